@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <list>
+#include <ostream>
+#include <chrono>
+
+class Bench
+{
+private:
+	virtual void bench(std::ostream& out) = 0;
+
+public:
+	const std::string name;
+	Bench(std::string name) : name(name) {}
+	void run(std::ostream& out) { out << "[BENCH] " << name << "\n"; bench(out); }
+	virtual ~Bench() {}
+
+	// Wall time of f() in milliseconds
+	template<typename F>
+	static double measure(F f)
+	{
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+};
+
+class BenchDriver
+{
+private:
+	std::list<Bench*> benches;
+	static bool deleteBench(Bench* bench) { delete bench; return true; }
+
+public:
+	// Runs every bench whose name contains filter
+	void runBenches(std::ostream& out, std::string const& filter)
+	{
+		for (Bench* bench : benches)
+			if (bench->name.find(filter) != std::string::npos)
+				bench->run(out);
+	}
+
+	void addBench(Bench* bench)
+	{
+		benches.push_back(bench);
+	}
+
+	~BenchDriver() { benches.remove_if(deleteBench); }
+};
@@ -0,0 +1,27 @@
+#include "setbenches.h"
+#include "loggerbenches.h"
+#include "modelsbenches.h"
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+	BenchDriver driver;
+	driver.addBench(new LshRecall());
+	driver.addBench(new SnapshotLoad());
+	driver.addBench(new SnapshotCompression());
+	driver.addBench(new MortonSearch());
+	driver.addBench(new LoggerLatency());
+	driver.addBench(new LoggerRegistration());
+	driver.addBench(new LoggerFormats());
+	driver.addBench(new LoggerStorm());
+	driver.addBench(new RationalSum());
+	driver.addBench(new RealProducts());
+	driver.addBench(new IntervalKernels());
+	driver.addBench(new RationalDouble());
+	driver.addBench(new MatrixSolve());
+	driver.addBench(new RationalDedupe());
+	driver.addBench(new TextFormat());
+
+	driver.runBenches(std::cout, argc > 1 ? argv[1] : "");
+	return 0;
+}
@@ -0,0 +1,183 @@
+#include "loggerbenches.h"
+#include "ILogger.h"
+#include "ISet.h"
+#include "numeric/AsyncLogger.h"
+#include "numeric/BinaryLogger.h"
+#include "numeric/LogStats.h"
+#include "IVector.h"
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+namespace
+{
+	long fileSize(char const* pFileName)
+	{
+		std::FILE* file = std::fopen(pFileName, "rb");
+		if (file == nullptr)
+			return 0;
+		std::fseek(file, 0, SEEK_END);
+		long res = std::ftell(file);
+		std::fclose(file);
+		return res;
+	}
+
+	// Wall time of every thread logging count messages, in ms
+	double logFromThreads(ILogger* logger, size_t threads, size_t count)
+	{
+		return Bench::measure([&]() {
+			std::vector<std::thread> workers;
+			for (size_t t = 0; t < threads; t++)
+				workers.emplace_back([=]() {
+					for (size_t i = 0; i < count; i++)
+						logger->log("In [IVector::add] dimension should be the same", RESULT_CODE::WRONG_DIM);
+				});
+			for (std::thread& worker : workers)
+				worker.join();
+		});
+	}
+}
+
+void LoggerLatency::bench(std::ostream& out)
+{
+	const size_t COUNT = 200000;
+	char const* fileName = "bench_log.txt";
+
+	for (size_t threads : { (size_t)1, (size_t)4 })
+	{
+		ILogger* logger = ILogger::createLogger(this);
+		logger->setLogFile(fileName);
+		double syncMs = logFromThreads(logger, 1, COUNT * threads);
+		logger->destroyLogger(this);
+
+		AsyncLogger::Params params;
+		params.fileName = fileName;
+		AsyncLogger* async = AsyncLogger::createLogger(this, params);
+		double dropMs = logFromThreads(async, threads, COUNT);
+		size_t dropped = async->getDropped();
+		async->destroyLogger(this);
+
+		params.overflow = AsyncLogger::OVERFLOW_POLICY::BLOCK;
+		async = AsyncLogger::createLogger(this, params);
+		double blockMs = logFromThreads(async, threads, COUNT);
+		double drainMs = Bench::measure([&]() {
+			async->flush();
+		});
+		async->destroyLogger(this);
+
+		double calls = (double)(COUNT * threads);
+		out << "  " << threads << " thread(s), " << COUNT * threads << " messages, ns per call:\n";
+		out << "    MyLogger (one thread) " << syncMs * 1e6 / calls << "\n";
+		out << "    AsyncLogger DROP " << dropMs * 1e6 / calls << " (" << dropped << " dropped)\n";
+		out << "    AsyncLogger BLOCK " << blockMs * 1e6 / calls << ", then flush " << drainMs << " ms\n";
+	}
+
+	std::remove(fileName);
+}
+
+void LoggerRegistration::bench(std::ostream& out)
+{
+	const size_t COUNT = 1000000;
+	ILogger* logger = ILogger::createLogger(this);
+
+	int clients[8];
+	double registerMs = Bench::measure([&]() {
+		for (size_t i = 0; i < COUNT; i++)
+		{
+			ILogger* client = ILogger::createLogger(&clients[i % 8]);
+			client->destroyLogger(&clients[i % 8]);
+		}
+	});
+
+	// Temporary sets as ISet::add and clone create them
+	double setMs = Bench::measure([&]() {
+		for (size_t i = 0; i < COUNT / 10; i++)
+			delete ISet::createSet(nullptr);
+	});
+
+	out << "  createLogger + destroyLogger " << registerMs * 1e6 / COUNT << " ns\n";
+	out << "  empty set create + delete " << setMs * 1e7 / COUNT << " ns\n";
+	logger->destroyLogger(this);
+}
+
+void LoggerFormats::bench(std::ostream& out)
+{
+	const size_t COUNT = 200000;
+	char const* textName = "bench_log.txt";
+	char const* binaryName = "bench_log.bin";
+
+	double data[3] = { 1, 2, 3 };
+	IVector* vec2 = IVector::createVector(2, data, nullptr);
+	IVector* vec3 = IVector::createVector(3, data, nullptr);
+
+	// Every record reaches the file, the rate limit is measured by LoggerStorm
+	LogStats::Limit defaults = LogStats::getLimit();
+	LogStats::Limit unlimited;
+	unlimited.burst = 0;
+	LogStats::setLimit(unlimited);
+
+	// The dimension mismatch of IVector::add, as in a bad batch
+	ILogger* text = ILogger::createLogger(this);
+	text->setLogFile(textName);
+	double textMs = Bench::measure([&]() {
+		for (size_t i = 0; i < COUNT; i++)
+			IVector::add(vec2, vec3, text);
+	});
+	text->destroyLogger(this);
+
+	BinaryLogger* binary = BinaryLogger::createLogger(this, binaryName);
+	double binaryMs = Bench::measure([&]() {
+		for (size_t i = 0; i < COUNT; i++)
+			IVector::add(vec2, vec3, binary);
+		binary->flush();
+	});
+	binary->destroyLogger(this);
+
+	out << "  " << COUNT << " failed IVector::add calls\n";
+	out << "    text   " << textMs * 1e6 / COUNT << " ns per call, " << (double)fileSize(textName) / COUNT << " bytes per record\n";
+	out << "    binary " << binaryMs * 1e6 / COUNT << " ns per call, " << (double)fileSize(binaryName) / COUNT << " bytes per record\n";
+
+	LogStats::setLimit(defaults);
+	std::remove(textName);
+	std::remove(binaryName);
+	delete vec2;
+	delete vec3;
+}
+
+void LoggerStorm::bench(std::ostream& out)
+{
+	const size_t COUNT = 200000;
+	char const* fileName = "bench_log.txt";
+
+	double data[3] = { 1, 2, 3 };
+	IVector* vec2 = IVector::createVector(2, data, nullptr);
+	IVector* vec3 = IVector::createVector(3, data, nullptr);
+	LogStats::Limit defaults = LogStats::getLimit();
+
+	// The same storm of failed IVector::add calls without and with the default limit
+	for (size_t burst : { (size_t)0, defaults.burst })
+	{
+		LogStats::Limit limit = defaults;
+		limit.burst = burst;
+		LogStats::setLimit(limit);
+		LogStats::reset();
+
+		ILogger* logger = ILogger::createLogger(this);
+		logger->setLogFile(fileName);
+		double ms = Bench::measure([&]() {
+			for (size_t i = 0; i < COUNT; i++)
+				IVector::add(vec2, vec3, logger);
+			LogStats::flushSummaries(logger);
+		});
+		logger->destroyLogger(this);
+
+		out << "  burst " << burst << ": " << ms * 1e6 / COUNT << " ns per call, "
+			<< fileSize(fileName) << " bytes logged, "
+			<< LogStats::getSuppressed(MESSAGE_ID::VECTOR_ADD_DIM) << " suppressed\n";
+	}
+
+	LogStats::setLimit(defaults);
+	std::remove(fileName);
+	delete vec2;
+	delete vec3;
+}
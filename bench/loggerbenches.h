@@ -0,0 +1,36 @@
+#pragma once
+#include "Bench.h"
+
+const std::string LOGGER_PREFIX = "Logger  ";
+
+class LoggerLatency : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	LoggerLatency() : Bench(LOGGER_PREFIX + "Latency") {}
+};
+
+class LoggerRegistration : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	LoggerRegistration() : Bench(LOGGER_PREFIX + "Registration") {}
+};
+
+class LoggerFormats : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	LoggerFormats() : Bench(LOGGER_PREFIX + "Formats") {}
+};
+
+class LoggerStorm : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	LoggerStorm() : Bench(LOGGER_PREFIX + "Storm") {}
+};
@@ -0,0 +1,348 @@
+#include "modelsbenches.h"
+#include "models/Rational.h"
+#include "models/RationalAccumulator.h"
+#include "models/IntervalArray.h"
+#include "models/RationalMatrix.h"
+#include "models/RationalVectorSet.h"
+#include <vector>
+#include <sstream>
+#include <cmath>
+#include <algorithm>
+
+void RationalSum::bench(std::ostream& out)
+{
+	const size_t COUNT = 1000000;
+	int denominators[] = { 2, 3, 4, 5, 6, 8, 10, 12 };
+	std::vector<Rational> terms;
+	terms.reserve(COUNT);
+	for (size_t k = 0; k < COUNT; k++)
+		terms.push_back(Rational((int)(k % 7) - 3, denominators[k % 8]));
+
+	out << "  sum of " << COUNT << " rationals with denominators up to 12\n";
+	for (bool lazy : { false, true })
+	{
+		Rational sum(0);
+		sum.setLazy(lazy);
+		double ms = Bench::measure([&]() {
+			for (Rational const& term : terms)
+				sum += term;
+			sum.reduce();
+		});
+
+		std::ostringstream text;
+		text << sum;
+		out << "    " << (lazy ? "lazy       " : "eager      ") << " " << ms << " ms, " << ms * 1e6 / COUNT << " ns per term, sum " << text.str() << "\n";
+	}
+
+	RationalAccumulator accumulator;
+	Rational sum(0);
+	double ms = Bench::measure([&]() {
+		for (Rational const& term : terms)
+			accumulator.add(term);
+		sum = accumulator.getSum();
+	});
+	std::ostringstream text;
+	text << sum;
+	out << "    accumulator " << ms << " ms, " << ms * 1e6 / COUNT << " ns per term, sum " << text.str() << "\n";
+}
+
+void RealProducts::bench(std::ostream& out)
+{
+	const size_t COUNT = 100000;
+	std::vector<Real> exact;
+	std::vector<RealD> bounds;
+	exact.reserve(COUNT);
+	bounds.reserve(COUNT);
+	for (size_t k = 0; k < COUNT; k++)
+	{
+		int a = (int)(k % 17) - 8;
+		Real value(Rational(a, (int)(k % 5) + 2), Rational(a + (int)(k % 3) + 1, (int)(k % 7) + 2));
+		exact.push_back(value);
+		bounds.push_back(RealD(value));
+	}
+
+	out << "  " << COUNT << " interval products x[k] * x[k + 1] summed\n";
+	Real sum(Rational(0), Rational(0));
+	double exactMs = Bench::measure([&]() {
+		for (size_t k = 0; k + 1 < COUNT; k++)
+			sum += exact[k] * exact[k + 1];
+	});
+	RealD sumD(0.0);
+	double boundsMs = Bench::measure([&]() {
+		for (size_t k = 0; k + 1 < COUNT; k++)
+			sumD += bounds[k] * bounds[k + 1];
+	});
+
+	std::ostringstream text;
+	text << sumD;
+	out << "    Real  " << exactMs << " ms, " << exactMs * 1e6 / COUNT << " ns per product\n";
+	out << "    RealD " << boundsMs << " ms, " << boundsMs * 1e6 / COUNT << " ns per product, " << exactMs / boundsMs << "x, sum " << text.str() << "\n";
+}
+
+void IntervalKernels::bench(std::ostream& out)
+{
+	const size_t COUNT = 1 << 20;
+	IntervalArray x, y;
+	for (size_t k = 0; k < COUNT; k++)
+	{
+		double a = (double)(k % 1000) / 7 - 70;
+		double c = (double)(k % 777) / 3 + 1;
+		x.append(RealD(a, a + (double)(k % 5)));
+		y.append(RealD(k % 2 == 0 ? c : -c - 1, k % 2 == 0 ? c + 1 : -c));
+	}
+
+	out << "  " << COUNT << " intervals, ns per element for add, mul, div\n";
+	IntervalArray res(COUNT);
+	double loopMs[3] = {};
+	loopMs[0] = Bench::measure([&]() {
+		for (size_t k = 0; k < COUNT; k++)
+			res.set(k, x.get(k) + y.get(k));
+	});
+	loopMs[1] = Bench::measure([&]() {
+		for (size_t k = 0; k < COUNT; k++)
+			res.set(k, x.get(k) * y.get(k));
+	});
+	loopMs[2] = Bench::measure([&]() {
+		for (size_t k = 0; k < COUNT; k++)
+			res.set(k, x.get(k) / y.get(k));
+	});
+	out << "    RealD loop " << loopMs[0] * 1e6 / COUNT << ", " << loopMs[1] * 1e6 / COUNT << ", " << loopMs[2] * 1e6 / COUNT << "\n";
+
+	INTERVAL_KERNEL initial = IntervalArray::getKernel();
+	char const* names[] = { "scalar    ", "AVX2      ", "AVX-512   " };
+	for (INTERVAL_KERNEL kernel : { INTERVAL_KERNEL::SCALAR, INTERVAL_KERNEL::AVX2, INTERVAL_KERNEL::AVX512 })
+	{
+		if (!IntervalArray::setKernel(kernel))
+			continue;
+		double addMs = Bench::measure([&]() { IntervalArray::add(x, y, res); });
+		double mulMs = Bench::measure([&]() { IntervalArray::mul(x, y, res); });
+		double divMs = Bench::measure([&]() { IntervalArray::div(x, y, res); });
+		out << "    " << names[(int)kernel] << " " << addMs * 1e6 / COUNT << ", " << mulMs * 1e6 / COUNT << ", " << divMs * 1e6 / COUNT << "\n";
+	}
+	IntervalArray::setKernel(initial);
+}
+
+void RationalDouble::bench(std::ostream& out)
+{
+	const size_t COUNT = 1 << 18;
+	std::vector<double> values(COUNT);
+	std::vector<Rational> fractions;
+	for (size_t k = 0; k < COUNT; k++)
+	{
+		values[k] = std::ldexp((double)(k * 2654435761u % 1000003) / 1000003 - 0.5, (int)(k % 200) - 100);
+		fractions.push_back(Rational(Integer((int64_t)(k * 2654435761u % 1000003) + 1), Integer((int64_t)k + 1000000007)));
+	}
+
+	out << "  " << COUNT << " values, ns per value\n";
+	std::vector<Rational> exact;
+	double fromMs = Bench::measure([&]() { Rational::fromDoubles(values.data(), COUNT, exact); });
+	std::vector<double> back(COUNT);
+	double toMs = Bench::measure([&]() { Rational::toDoubles(exact.data(), COUNT, back.data()); });
+	double fractionMs = Bench::measure([&]() { Rational::toDoubles(fractions.data(), COUNT, back.data()); });
+	out << "    fromDoubles " << fromMs * 1e6 / COUNT << ", toDoubles " << toMs * 1e6 / COUNT
+		<< ", toDoubles of word fractions " << fractionMs * 1e6 / COUNT << "\n";
+
+	std::vector<Rational> approximations;
+	for (int64_t bound : { (int64_t)1000, (int64_t)1000000 })
+	{
+		double singleMs = Bench::measure([&]() {
+			approximations.clear();
+			for (double value : values)
+				approximations.push_back(Rational::fromDouble(value).approximate(Integer(bound)));
+		});
+		double batchMs = Bench::measure([&]() { Rational::approximate(values.data(), COUNT, Integer(bound), approximations); });
+		out << "    approximate, denominators up to " << bound << ": one by one " << singleMs * 1e6 / COUNT
+			<< ", batch " << batchMs * 1e6 / COUNT << "\n";
+	}
+}
+
+namespace
+{
+	// Gauss-Jordan in Rational arithmetic on [a | b], the reference for MatrixSolve
+	bool gaussSolve(const RationalMatrix& matrix, const std::vector<Rational>& b, std::vector<Rational>& x, Rational& det)
+	{
+		size_t n = matrix.getRows();
+		std::vector<std::vector<Rational>> a(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			for (size_t j = 0; j < n; j++)
+				a[i].push_back(matrix.get(i, j));
+			a[i].push_back(b[i]);
+		}
+
+		det = Rational(1);
+		for (size_t c = 0; c < n; c++)
+		{
+			size_t pivot = c;
+			while (pivot < n && a[pivot][c] == Rational(0))
+				pivot++;
+			if (pivot == n)
+				return false;
+			if (pivot != c)
+			{
+				std::swap(a[pivot], a[c]);
+				det = -det;
+			}
+			det *= a[c][c];
+			for (size_t i = c + 1; i < n; i++)
+			{
+				Rational factor = a[i][c] / a[c][c];
+				for (size_t j = c; j <= n; j++)
+					a[i][j] -= factor * a[c][j];
+			}
+		}
+
+		x.assign(n, Rational(0));
+		for (size_t i = n; i-- > 0;)
+		{
+			Rational value = a[i][n];
+			for (size_t j = i + 1; j < n; j++)
+				value -= a[i][j] * x[j];
+			x[i] = value / a[i][i];
+		}
+		return true;
+	}
+}
+
+void MatrixSolve::bench(std::ostream& out)
+{
+	out << "  entries p / q with |p| <= 10, q <= 6, ms for determinant and solve\n";
+	uint64_t state = 3;
+	for (size_t n : { 4, 8, 16, 32, 64 })
+	{
+		RationalMatrix matrix(n, n);
+		std::vector<Rational> b;
+		for (size_t i = 0; i < n; i++)
+		{
+			for (size_t j = 0; j < n; j++)
+			{
+				state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+				matrix.set(i, j, Rational((int)((state >> 40) % 21) - 10, 1 + (int)((state >> 20) % 6)));
+			}
+			b.push_back(Rational((int)i, 7));
+		}
+
+		std::vector<Rational> x, gaussX;
+		Rational det(0), gaussDet(0);
+		double gaussMs = Bench::measure([&]() { gaussSolve(matrix, b, gaussX, gaussDet); });
+		double detMs = Bench::measure([&]() { det = matrix.determinant(); });
+		double solveMs = Bench::measure([&]() { matrix.solve(b, x); });
+		out << "    n = " << n << ": Rational Gauss " << gaussMs << ", Bareiss determinant " << detMs
+			<< ", Bareiss solve " << solveMs << (det == gaussDet && x == gaussX ? "" : ", MISMATCH") << "\n";
+	}
+}
+
+void RationalDedupe::bench(std::ostream& out)
+{
+	// Every vector three times, in a different form each time
+	const size_t DISTINCT = 4000, DIM = 4;
+	std::vector<std::vector<Rational>> vectors;
+	for (size_t copy = 1; copy <= 3; copy++)
+		for (size_t k = 0; k < DISTINCT; k++)
+		{
+			std::vector<Rational> vector;
+			for (size_t i = 0; i < DIM; i++)
+				vector.push_back(Rational(Integer((int64_t)((k * 7919 + i * 104729) % 1000) * (int64_t)copy), Integer((int64_t)(i + k % 13 + 1) * (int64_t)copy)));
+			vectors.push_back(vector);
+		}
+
+	size_t scanned = 0, hashed = 0;
+	double scanMs = Bench::measure([&]() {
+		std::vector<std::vector<Rational>> unique;
+		for (const std::vector<Rational>& vector : vectors)
+			if (std::find(unique.begin(), unique.end(), vector) == unique.end())
+				unique.push_back(vector);
+		scanned = unique.size();
+	});
+	double hashMs = Bench::measure([&]() {
+		RationalVectorSet unique;
+		for (const std::vector<Rational>& vector : vectors)
+			unique.insert(vector);
+		hashed = unique.size();
+	});
+	out << "  " << vectors.size() << " vectors of dim " << DIM << ", " << scanned << " (" << hashed << ") distinct\n";
+	out << "    scan " << scanMs << " ms, RationalVectorSet " << hashMs << " ms\n";
+}
+
+void TextFormat::bench(std::ostream& out)
+{
+	const size_t COUNT = 1000000;
+	std::vector<Integer> integers;
+	std::vector<Rational> rationals;
+	std::vector<Real> reals;
+	uint64_t state = 11;
+	for (size_t k = 0; k < COUNT; k++)
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		integers.push_back(Integer((int64_t)(state >> 20) - ((int64_t)1 << 43)));
+		rationals.push_back(Rational((int)(state >> 40) % 100000 - 50000, 1 + (int)((state >> 8) % 9999)));
+		reals.push_back(Real(rationals.back(), rationals.back() + Rational(1, 7)));
+	}
+	std::vector<char> buffer(64 * COUNT);
+	char* first = buffer.data();
+	char* last = first + buffer.size();
+
+	out << "  " << COUNT << " values, ms for iostreams vs toChars / fromChars on one buffer\n";
+	std::string text;
+	double streamMs = Bench::measure([&]() {
+		std::ostringstream stream;
+		for (const Integer& value : integers)
+			stream << value << '\n';
+		text = stream.str();
+	});
+	char* end = first;
+	double charsMs = Bench::measure([&]() { end = Integer::toChars(first, last, integers).ptr; });
+	bool same = text == std::string(first, end) + "\n";
+	out << "    Integer format: ostream " << streamMs << ", toChars " << charsMs << "\n";
+
+	std::vector<Integer> read(COUNT);
+	size_t count = 0;
+	streamMs = Bench::measure([&]() {
+		std::istringstream stream(text);
+		count = 0;
+		while (count < COUNT && stream >> read[count])
+			count++;
+	});
+	same = same && count == COUNT && read == integers;
+	charsMs = Bench::measure([&]() { Integer::fromChars(first, end, read, count); });
+	same = same && count == COUNT && read == integers;
+	out << "    Integer parse: istream " << streamMs << ", fromChars " << charsMs << "\n";
+
+	streamMs = Bench::measure([&]() {
+		std::ostringstream stream;
+		for (const Rational& value : rationals)
+			stream << value << '\n';
+		text = stream.str();
+	});
+	charsMs = Bench::measure([&]() { end = Rational::toChars(first, last, rationals).ptr; });
+	same = same && text == std::string(first, end) + "\n";
+	out << "    Rational format: ostream " << streamMs << ", toChars " << charsMs << "\n";
+
+	std::vector<Rational> readRationals(COUNT, Rational(0));
+	streamMs = Bench::measure([&]() {
+		std::istringstream stream(text);
+		Integer p, q;
+		char slash;
+		for (count = 0; count < COUNT && stream >> p >> slash >> q; count++)
+			readRationals[count] = Rational(p, q);
+	});
+	same = same && count == COUNT && readRationals == rationals;
+	charsMs = Bench::measure([&]() { Rational::fromChars(first, end, readRationals, count); });
+	same = same && count == COUNT && readRationals == rationals;
+	out << "    Rational parse: istream " << streamMs << ", fromChars " << charsMs << "\n";
+
+	streamMs = Bench::measure([&]() {
+		std::ostringstream stream;
+		for (const Real& value : reals)
+			stream << value << '\n';
+		text = stream.str();
+	});
+	charsMs = Bench::measure([&]() { end = Real::toChars(first, last, reals).ptr; });
+	same = same && text == std::string(first, end) + "\n";
+	out << "    Real format: ostream " << streamMs << ", toChars " << charsMs << "\n";
+
+	std::vector<Real> readReals(COUNT, REAL_NaN);
+	charsMs = Bench::measure([&]() { Real::fromChars(first, end, readReals, count); });
+	same = same && count == COUNT && readReals == reals;
+	out << "    Real parse: fromChars " << charsMs << (same ? "" : ", MISMATCH") << "\n";
+}
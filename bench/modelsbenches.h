@@ -0,0 +1,60 @@
+#pragma once
+#include "Bench.h"
+
+const std::string MODELS_PREFIX = "Models  ";
+
+class RationalSum : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	RationalSum() : Bench(MODELS_PREFIX + "RationalSum") {}
+};
+
+class RealProducts : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	RealProducts() : Bench(MODELS_PREFIX + "RealProducts") {}
+};
+
+class IntervalKernels : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	IntervalKernels() : Bench(MODELS_PREFIX + "IntervalKernels") {}
+};
+
+
+class RationalDouble : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	RationalDouble() : Bench(MODELS_PREFIX + "RationalDouble") {}
+};
+
+class MatrixSolve : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	MatrixSolve() : Bench(MODELS_PREFIX + "MatrixSolve") {}
+};
+
+class RationalDedupe : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	RationalDedupe() : Bench(MODELS_PREFIX + "RationalDedupe") {}
+};
+class TextFormat : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	TextFormat() : Bench(MODELS_PREFIX + "TextFormat") {}
+};
@@ -0,0 +1,321 @@
+#include "setbenches.h"
+#include "ISet.h"
+#include "numeric/LshSet.h"
+#include "numeric/OrderedSet.h"
+#include "numeric/SetSnapshot.h"
+#include "numeric/SnapshotBlocks.h"
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+	std::vector<IVector*> randomVectors(size_t count, size_t dim, double sigma, std::mt19937_64& gen, ILogger* logger)
+	{
+		std::normal_distribution<double> normal(0.0, sigma);
+		std::vector<double> data(dim);
+		std::vector<IVector*> res;
+		for (size_t i = 0; i < count; i++)
+		{
+			for (double& x : data)
+				x = normal(gen);
+			res.push_back(IVector::createVector(dim, data.data(), logger));
+		}
+		return res;
+	}
+
+	// Slowly drifting readings with two decimals, like archived sensor data
+	std::vector<IVector*> gridVectors(size_t count, size_t dim, std::mt19937_64& gen, ILogger* logger)
+	{
+		std::uniform_int_distribution<int> step(-2, 2);
+		std::vector<long> cells(dim, 0);
+		std::vector<double> data(dim);
+		std::vector<IVector*> res;
+		for (size_t i = 0; i < count; i++)
+		{
+			for (size_t d = 0; d < dim; d++)
+			{
+				cells[d] += step(gen);
+				data[d] = cells[d] / 100.0;
+			}
+			res.push_back(IVector::createVector(dim, data.data(), logger));
+		}
+		return res;
+	}
+
+	long fileSize(char const* pFileName)
+	{
+		std::FILE* file = std::fopen(pFileName, "rb");
+		if (file == nullptr)
+			return 0;
+		std::fseek(file, 0, SEEK_END);
+		long res = std::ftell(file);
+		std::fclose(file);
+		return res;
+	}
+
+	void deleteVectors(std::vector<IVector*>& vectors)
+	{
+		for (IVector* vec : vectors)
+			delete vec;
+		vectors.clear();
+	}
+}
+
+void LshRecall::bench(std::ostream& out)
+{
+	const size_t DIM = 128;
+	const size_t COUNT = 2000;
+	const size_t QUERIES = 500;
+	const double TOLERANCE = 1.0;
+	const IVector::NORM NORM = IVector::NORM::NORM_2;
+
+	ILogger* logger = ILogger::createLogger(this);
+	std::mt19937_64 gen(42);
+
+	std::vector<IVector*> points = randomVectors(COUNT, DIM, 1.0, gen, logger);
+	std::vector<IVector*> noise = randomVectors(QUERIES, DIM, 0.5 / sqrt((double)DIM), gen, logger);
+	std::vector<IVector*> queries;
+	for (size_t i = 0; i < QUERIES; i++)
+		queries.push_back(i % 2 == 0
+			? IVector::add(points[(i * 7919) % COUNT], noise[i], logger)
+			: IVector::mul(noise[i], 32.0, logger));
+
+	ISet* exact = ISet::createSet(logger);
+	double buildMs = Bench::measure([&]() {
+		for (IVector* vec : points)
+			exact->insert(vec, NORM, TOLERANCE);
+	});
+
+	std::vector<bool> truth(QUERIES);
+	double queryMs = Bench::measure([&]() {
+		for (size_t i = 0; i < QUERIES; i++)
+		{
+			IVector* found = nullptr;
+			exact->get(found, queries[i], NORM, TOLERANCE);
+			truth[i] = found != nullptr;
+			delete found;
+		}
+	});
+	size_t relevant = 0;
+	for (bool hit : truth)
+		relevant += hit;
+
+	out << "  dim " << DIM << ", size " << COUNT << ", queries " << QUERIES << " (" << relevant << " with a match)\n";
+	out << "  SetImpl           build " << buildMs << " ms, query " << queryMs << " ms\n";
+
+	const size_t CONFIGS[][3] = { { 4, 8, 0 }, { 8, 8, 0 }, { 8, 8, 2 }, { 16, 8, 2 }, { 16, 12, 4 } };
+	for (auto const& config : CONFIGS)
+	{
+		LshSet::Params params;
+		params.tables = config[0];
+		params.hashesPerTable = config[1];
+		params.probes = config[2];
+		params.bucketWidth = 4 * TOLERANCE;
+
+		ISet* lsh = LshSet::createSet(params, logger);
+		buildMs = Bench::measure([&]() {
+			for (IVector* vec : points)
+				lsh->insert(vec, NORM, TOLERANCE);
+		});
+
+		size_t hits = 0;
+		size_t wrong = 0;
+		queryMs = Bench::measure([&]() {
+			for (size_t i = 0; i < QUERIES; i++)
+			{
+				IVector* found = nullptr;
+				lsh->get(found, queries[i], NORM, TOLERANCE);
+				if (found != nullptr)
+					truth[i] ? hits++ : wrong++;
+				delete found;
+			}
+		});
+
+		out << "  LSH L=" << params.tables << " K=" << params.hashesPerTable << " probes=" << params.probes
+			<< "  build " << buildMs << " ms, query " << queryMs << " ms, recall "
+			<< (relevant == 0 ? 1.0 : (double)hits / relevant) << ", false hits " << wrong << "\n";
+		delete lsh;
+	}
+
+	delete exact;
+	deleteVectors(points);
+	deleteVectors(noise);
+	deleteVectors(queries);
+	logger->destroyLogger(this);
+}
+
+void SnapshotLoad::bench(std::ostream& out)
+{
+	const size_t DIM = 16;
+	const size_t COUNT = 20000;
+	const IVector::NORM NORM = IVector::NORM::NORM_2;
+	char const* fileName = "bench_snapshot.bin";
+
+	ILogger* logger = ILogger::createLogger(this);
+	std::mt19937_64 gen(7);
+	std::vector<IVector*> points = randomVectors(COUNT, DIM, 1.0, gen, logger);
+
+	ISet* set = ISet::createSet(logger);
+	double insertMs = Bench::measure([&]() {
+		for (IVector* vec : points)
+			set->insert(vec, NORM, 1e-3);
+	});
+
+	double saveMs = Bench::measure([&]() {
+		SetSnapshot::save(set, fileName, logger);
+	});
+
+	ISet* loaded = nullptr;
+	double loadMs = Bench::measure([&]() {
+		loaded = SetSnapshot::loadMapped(fileName, logger);
+	});
+
+	size_t found = 0;
+	double queryMs = Bench::measure([&]() {
+		for (size_t i = 0; i < 100; i++)
+		{
+			IVector* vec = nullptr;
+			loaded->get(vec, points[i * 37], NORM, 1e-3);
+			found += vec != nullptr;
+			delete vec;
+		}
+	});
+
+	out << "  dim " << DIM << ", size " << COUNT << "\n";
+	out << "  rebuild by insert " << insertMs << " ms, save " << saveMs << " ms, loadMapped " << loadMs << " ms\n";
+	out << "  100 queries on mapped set " << queryMs << " ms, found " << found << "\n";
+
+	std::remove(fileName);
+	delete loaded;
+	delete set;
+	deleteVectors(points);
+	logger->destroyLogger(this);
+}
+
+void SnapshotCompression::bench(std::ostream& out)
+{
+	const size_t DIM = 8;
+	const size_t COUNT = 20000;
+	const IVector::NORM NORM = IVector::NORM::NORM_2;
+	char const* plainName = "bench_plain.bin";
+	char const* packedName = "bench_packed.bin";
+
+	ILogger* logger = ILogger::createLogger(this);
+	std::mt19937_64 gen(11);
+	char const* names[2] = { "grid", "gaussian" };
+	std::vector<IVector*> points[2] = { gridVectors(COUNT, DIM, gen, logger), randomVectors(COUNT, DIM, 1.0, gen, logger) };
+
+	out << "  dim " << DIM << ", size " << COUNT << ", block " << SetSnapshot::BLOCK_SIZE << "\n";
+	for (int data = 0; data < 2; data++)
+	{
+		ISet* set = ISet::createSet(logger);
+		for (IVector* vec : points[data])
+			set->insert(vec, NORM, 1e-9);
+
+		SetSnapshot::save(set, plainName, logger);
+		double saveMs = Bench::measure([&]() {
+			SetSnapshot::saveCompressed(set, packedName, SetSnapshot::BLOCK_SIZE, logger);
+		});
+		double ratio = (double)fileSize(plainName) / (double)fileSize(packedName);
+
+		// Decode every block into one buffer, plain blocks are a memcpy baseline
+		double decodeMs[2] = {};
+		char const* files[2] = { plainName, packedName };
+		std::vector<double> coords(set->getSize() * DIM);
+		for (int f = 0; f < 2; f++)
+		{
+			SnapshotBlocks* blocks = SnapshotBlocks::open(files[f], logger);
+			decodeMs[f] = Bench::measure([&]() {
+				for (int rep = 0; rep < 10; rep++)
+					for (size_t b = 0; b < blocks->getBlockCount(); b++)
+						blocks->decodeBlock(b, coords.data() + b * blocks->getBlockSize() * DIM);
+			}) / 10;
+			delete blocks;
+		}
+
+		ISet* loaded = nullptr;
+		double loadMs = Bench::measure([&]() {
+			loaded = SetSnapshot::loadMapped(packedName, logger);
+		});
+
+		double megabytes = (double)coords.size() * sizeof(double) / (1 << 20);
+		out << "  " << names[data] << ": ratio " << ratio << ", saveCompressed " << saveMs << " ms\n";
+		out << "    decode " << megabytes / decodeMs[1] * 1000 << " MB/s, plain blocks " << megabytes / decodeMs[0] * 1000
+			<< " MB/s, loadMapped compressed " << loadMs << " ms\n";
+
+		delete loaded;
+		delete set;
+		deleteVectors(points[data]);
+	}
+
+	std::remove(plainName);
+	std::remove(packedName);
+	logger->destroyLogger(this);
+}
+
+void MortonSearch::bench(std::ostream& out)
+{
+	const size_t COUNT = 20000;
+	const size_t QUERIES = 2000;
+	const double TOLERANCE = 0.5;
+	const IVector::NORM NORM = IVector::NORM::NORM_INF;
+
+	ILogger* logger = ILogger::createLogger(this);
+	OrderedSet::LAYOUT layouts[2] = { OrderedSet::LAYOUT::INSERTION, OrderedSet::LAYOUT::MORTON };
+	char const* names[2] = { "INSERTION", "MORTON" };
+
+	out << "  size " << COUNT << ", uniform in [0, 1000), tolerance " << TOLERANCE << ", ms\n";
+	for (size_t dim : { 2, 3 })
+	{
+		std::mt19937_64 gen(dim);
+		std::uniform_real_distribution<double> uniform(0.0, 1000.0);
+		std::vector<double> data(dim);
+		std::vector<IVector*> points, queries;
+		for (size_t i = 0; i < COUNT + QUERIES; i++)
+		{
+			for (double& x : data)
+				x = uniform(gen);
+			(i < COUNT ? points : queries).push_back(IVector::createVector(dim, data.data(), logger));
+		}
+
+		OrderedSet* other = OrderedSet::createSet(OrderedSet::LAYOUT::MORTON, logger);
+		for (IVector* vec : queries)
+			other->insert(vec, NORM, TOLERANCE);
+
+		for (int layout = 0; layout < 2; layout++)
+		{
+			OrderedSet* set = OrderedSet::createSet(layouts[layout], logger);
+			double buildMs = Bench::measure([&]() {
+				for (IVector* vec : points)
+					set->insert(vec, NORM, TOLERANCE);
+			});
+
+			size_t found = 0;
+			std::vector<size_t> indices;
+			double queryMs = Bench::measure([&]() {
+				for (IVector* vec : queries)
+				{
+					set->findAll(vec, NORM, 4 * TOLERANCE, indices);
+					found += indices.size();
+				}
+			});
+
+			ISet* common = nullptr;
+			double intersectMs = Bench::measure([&]() {
+				common = ISet::intersect(other, set, NORM, TOLERANCE, logger);
+			});
+
+			out << "    dim " << dim << " " << names[layout] << ": build " << buildMs << ", " << QUERIES << " range queries "
+				<< queryMs << " (" << found << " found), intersect " << intersectMs << " (" << common->getSize() << ")\n";
+			delete common;
+			delete set;
+		}
+
+		delete other;
+		deleteVectors(points);
+		deleteVectors(queries);
+	}
+	logger->destroyLogger(this);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Bench.h"
+
+const std::string SET_PREFIX = "Set     ";
+
+class LshRecall : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	LshRecall() : Bench(SET_PREFIX + "LshRecall") {}
+};
+
+class SnapshotLoad : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	SnapshotLoad() : Bench(SET_PREFIX + "SnapshotLoad") {}
+};
+
+class SnapshotCompression : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	SnapshotCompression() : Bench(SET_PREFIX + "SnapshotCompression") {}
+};
+
+class MortonSearch : public Bench
+{
+private:
+	void bench(std::ostream& out) override;
+public:
+	MortonSearch() : Bench(SET_PREFIX + "MortonSearch") {}
+};
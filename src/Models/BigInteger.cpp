@@ -0,0 +1,625 @@
+#include "models/BigInteger.h"
+#include "models/Hash.h"
+#include "models/Error.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr char const* SOURCE = "BigInteger";
+
+	enum BigIntegerError
+	{
+		OK = 0,
+		DIVIDED_BY_ZERO = 1
+	};
+
+	// Indexed by BigIntegerError
+	constexpr Error BIG_INTEGER_ERRORS[] =
+	{
+		Error(),
+		Error(SOURCE, DIVIDED_BY_ZERO, "(/ 0, % 0) is undefined")
+	};
+}
+
+namespace
+{
+	typedef std::vector<uint32_t> Limbs;
+
+	// Below this many limbs of the shorter operand schoolbook multiplication is faster
+	const size_t KARATSUBA_LIMBS = 32;
+	const uint32_t DECIMAL_BASE = 1000000000;
+	const size_t DECIMAL_DIGITS = 9;
+
+	size_t trimmed(uint32_t const* a, size_t n)
+	{
+		while (n != 0 && a[n - 1] == 0)
+			n--;
+		return n;
+	}
+
+	// r[0, nr) += a[0, na), na <= nr, the carry out of r is dropped
+	void addTo(uint32_t* r, size_t nr, uint32_t const* a, size_t na)
+	{
+		uint64_t carry = 0;
+		size_t i = 0;
+		for (; i < na; i++)
+		{
+			carry += (uint64_t)r[i] + a[i];
+			r[i] = (uint32_t)carry;
+			carry >>= 32;
+		}
+		for (; carry != 0 && i < nr; i++)
+		{
+			carry += r[i];
+			r[i] = (uint32_t)carry;
+			carry >>= 32;
+		}
+	}
+
+	// r[0, nr) -= a[0, na), r >= a
+	void subFrom(uint32_t* r, size_t nr, uint32_t const* a, size_t na)
+	{
+		int64_t borrow = 0;
+		size_t i = 0;
+		for (; i < na; i++)
+		{
+			int64_t t = (int64_t)r[i] - a[i] - borrow;
+			r[i] = (uint32_t)t;
+			borrow = t < 0 ? 1 : 0;
+		}
+		for (; borrow != 0 && i < nr; i++)
+		{
+			borrow = r[i] == 0 ? 1 : 0;
+			r[i]--;
+		}
+	}
+
+	// r[0, na + nb) = a * b, r is zeroed by the caller
+	void mulSchool(uint32_t const* a, size_t na, uint32_t const* b, size_t nb, uint32_t* r)
+	{
+		for (size_t i = 0; i < na; i++)
+		{
+			if (a[i] == 0)
+				continue;
+
+			uint64_t carry = 0;
+			for (size_t j = 0; j < nb; j++)
+			{
+				carry += (uint64_t)a[i] * b[j] + r[i + j];
+				r[i + j] = (uint32_t)carry;
+				carry >>= 32;
+			}
+			r[i + nb] = (uint32_t)carry;
+		}
+	}
+
+	// r[0, na + nb) = a * b, r is zeroed by the caller.
+	// With a = a1 B^h + a0, b = b1 B^h + b0: a b = z2 B^2h + z1 B^h + z0, where
+	// z0 = a0 b0, z2 = a1 b1 and z1 = (a0 + a1)(b0 + b1) - z0 - z2 costs one product instead of two.
+	void mulKaratsuba(uint32_t const* a, size_t na, uint32_t const* b, size_t nb, uint32_t* r)
+	{
+		if (na < nb)
+		{
+			std::swap(a, b);
+			std::swap(na, nb);
+		}
+		if (nb < KARATSUBA_LIMBS)
+		{
+			mulSchool(a, na, b, nb, r);
+			return;
+		}
+
+		size_t h = (na + 1) / 2;
+		if (nb <= h)
+		{
+			// b is too short to split, a0 b and a1 b are separate products
+			mulKaratsuba(a, h, b, nb, r);
+			Limbs high(na - h + nb, 0);
+			mulKaratsuba(a + h, na - h, b, nb, high.data());
+			addTo(r + h, na + nb - h, high.data(), high.size());
+			return;
+		}
+
+		size_t na0 = trimmed(a, h), nb0 = trimmed(b, h);
+		size_t na1 = na - h, nb1 = nb - h;
+		mulKaratsuba(a, na0, b, nb0, r);
+		mulKaratsuba(a + h, na1, b + h, nb1, r + 2 * h);
+
+		Limbs sa(a, a + h), sb(b, b + h);
+		sa.push_back(0);
+		sb.push_back(0);
+		addTo(sa.data(), sa.size(), a + h, na1);
+		addTo(sb.data(), sb.size(), b + h, nb1);
+
+		size_t nsa = trimmed(sa.data(), sa.size()), nsb = trimmed(sb.data(), sb.size());
+		Limbs z1(nsa + nsb, 0);
+		mulKaratsuba(sa.data(), nsa, sb.data(), nsb, z1.data());
+		subFrom(z1.data(), z1.size(), r, trimmed(r, na0 + nb0));
+		subFrom(z1.data(), z1.size(), r + 2 * h, trimmed(r + 2 * h, na1 + nb1));
+		addTo(r + h, na + nb - h, z1.data(), trimmed(z1.data(), z1.size()));
+	}
+
+	// a = a * m + add
+	void mulAddSmall(Limbs& a, uint32_t m, uint32_t add)
+	{
+		uint64_t carry = add;
+		for (uint32_t& limb : a)
+		{
+			carry += (uint64_t)limb * m;
+			limb = (uint32_t)carry;
+			carry >>= 32;
+		}
+		if (carry != 0)
+			a.push_back((uint32_t)carry);
+	}
+
+	// a = a / d, returns a % d, a is trimmed
+	uint32_t divSmall(Limbs& a, uint32_t d)
+	{
+		uint64_t rem = 0;
+		for (size_t i = a.size(); i-- > 0;)
+		{
+			uint64_t cur = (rem << 32) | a[i];
+			a[i] = (uint32_t)(cur / d);
+			rem = cur % d;
+		}
+		a.resize(trimmed(a.data(), a.size()));
+		return (uint32_t)rem;
+	}
+
+	// Knuth's algorithm D for trimmed magnitudes, v has at least two limbs and u >= v
+	void divKnuth(Limbs const& u, Limbs const& v, Limbs& q, Limbs& r)
+	{
+		size_t n = v.size(), m = u.size() - n;
+
+		// Normalize so that the top limb of v has its high bit set
+		int s = 0;
+		while ((v[n - 1] << s & 0x80000000u) == 0)
+			s++;
+
+		Limbs vn(n), un(u.size() + 1);
+		for (size_t i = n - 1; i > 0; i--)
+			vn[i] = s == 0 ? v[i] : (v[i] << s) | (v[i - 1] >> (32 - s));
+		vn[0] = v[0] << s;
+		un[u.size()] = s == 0 ? 0 : u[u.size() - 1] >> (32 - s);
+		for (size_t i = u.size() - 1; i > 0; i--)
+			un[i] = s == 0 ? u[i] : (u[i] << s) | (u[i - 1] >> (32 - s));
+		un[0] = u[0] << s;
+
+		const uint64_t BASE = (uint64_t)1 << 32;
+		q.assign(m + 1, 0);
+		for (size_t j = m + 1; j-- > 0;)
+		{
+			uint64_t num = ((uint64_t)un[j + n] << 32) | un[j + n - 1];
+			uint64_t qhat = num / vn[n - 1];
+			uint64_t rhat = num % vn[n - 1];
+			while (qhat >= BASE || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2]))
+			{
+				qhat--;
+				rhat += vn[n - 1];
+				if (rhat >= BASE)
+					break;
+			}
+
+			// un[j, j + n] -= qhat * vn
+			int64_t borrow = 0;
+			uint64_t carry = 0;
+			for (size_t i = 0; i < n; i++)
+			{
+				uint64_t p = qhat * vn[i] + carry;
+				carry = p >> 32;
+				int64_t t = (int64_t)un[i + j] - (int64_t)(uint32_t)p - borrow;
+				un[i + j] = (uint32_t)t;
+				borrow = t < 0 ? 1 : 0;
+			}
+			int64_t t = (int64_t)un[j + n] - (int64_t)carry - borrow;
+			un[j + n] = (uint32_t)t;
+
+			// qhat was one too large, add vn back
+			if (t < 0)
+			{
+				qhat--;
+				uint64_t back = 0;
+				for (size_t i = 0; i < n; i++)
+				{
+					back += (uint64_t)un[i + j] + vn[i];
+					un[i + j] = (uint32_t)back;
+					back >>= 32;
+				}
+				un[j + n] += (uint32_t)back;
+			}
+			q[j] = (uint32_t)qhat;
+		}
+		q.resize(trimmed(q.data(), q.size()));
+
+		r.resize(n);
+		for (size_t i = 0; i < n; i++)
+			r[i] = s == 0 ? un[i] : (un[i] >> s) | (un[i + 1] << (32 - s));
+		r.resize(trimmed(r.data(), r.size()));
+	}
+}
+
+BigInteger::BigInteger()
+	: negative_(false)
+{}
+
+BigInteger::BigInteger(int64_t value)
+	: negative_(value < 0)
+{
+	uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+	while (magnitude != 0)
+	{
+		limbs_.push_back((uint32_t)magnitude);
+		magnitude >>= 32;
+	}
+}
+
+void BigInteger::trim()
+{
+	limbs_.resize(trimmed(limbs_.data(), limbs_.size()));
+	if (limbs_.empty())
+		negative_ = false;
+}
+
+int BigInteger::compareMagnitude(const BigInteger& other) const
+{
+	if (limbs_.size() != other.limbs_.size())
+		return limbs_.size() < other.limbs_.size() ? -1 : 1;
+
+	for (size_t i = limbs_.size(); i-- > 0;)
+		if (limbs_[i] != other.limbs_[i])
+			return limbs_[i] < other.limbs_[i] ? -1 : 1;
+	return 0;
+}
+
+void BigInteger::add(const BigInteger& other, bool otherNegative)
+{
+	if (negative_ == otherNegative)
+	{
+		if (limbs_.size() < other.limbs_.size())
+			limbs_.resize(other.limbs_.size(), 0);
+		limbs_.push_back(0);
+		addTo(limbs_.data(), limbs_.size(), other.limbs_.data(), other.limbs_.size());
+	}
+	else if (compareMagnitude(other) >= 0)
+		subFrom(limbs_.data(), limbs_.size(), other.limbs_.data(), other.limbs_.size());
+	else
+	{
+		Limbs res = other.limbs_;
+		subFrom(res.data(), res.size(), limbs_.data(), limbs_.size());
+		limbs_.swap(res);
+		negative_ = otherNegative;
+	}
+	trim();
+}
+
+BigInteger BigInteger::powerOfTwo(size_t exponent)
+{
+	BigInteger res;
+	res.limbs_.assign(exponent / 32 + 1, 0);
+	res.limbs_.back() = (uint32_t)1 << (exponent % 32);
+	return res;
+}
+
+bool BigInteger::fromString(const std::string& digits, BigInteger& res)
+{
+	const char* first = digits.data();
+	const char* last = first + digits.size();
+	if (first != last && *first == '+' && ++first != last && *first == '-')
+		return false;
+
+	BigInteger value;
+	std::from_chars_result parsed = fromChars(first, last, value);
+	if (parsed.ec != std::errc() || parsed.ptr != last)
+		return false;
+	res = std::move(value);
+	return true;
+}
+
+std::from_chars_result BigInteger::fromChars(const char* first, const char* last, BigInteger& res)
+{
+	const char* pos = first;
+	bool negative = pos != last && *pos == '-';
+	if (negative)
+		pos++;
+	const char* end = pos;
+	while (end != last && *end >= '0' && *end <= '9')
+		end++;
+	if (end == pos)
+		return { first, std::errc::invalid_argument };
+
+	// Nine digits at a time, the first chunk takes the remainder
+	Limbs limbs;
+	size_t chunk = (size_t)(end - pos) % DECIMAL_DIGITS;
+	if (chunk == 0)
+		chunk = DECIMAL_DIGITS;
+	while (pos != end)
+	{
+		uint32_t value = 0, scale = 1;
+		for (const char* stop = pos + chunk; pos != stop; pos++)
+		{
+			value = value * 10 + (uint32_t)(*pos - '0');
+			scale *= 10;
+		}
+		mulAddSmall(limbs, scale, value);
+		chunk = DECIMAL_DIGITS;
+	}
+
+	res.limbs_.swap(limbs);
+	res.negative_ = negative;
+	res.trim();
+	return { end, std::errc() };
+}
+
+bool BigInteger::divide(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder)
+{
+	if (b.isZero())
+		return false;
+
+	bool qNegative = a.negative_ != b.negative_, rNegative = a.negative_;
+	Limbs q, r;
+	if (a.compareMagnitude(b) < 0)
+		r = a.limbs_;
+	else if (b.limbs_.size() == 1)
+	{
+		q = a.limbs_;
+		uint32_t rem = divSmall(q, b.limbs_[0]);
+		if (rem != 0)
+			r.push_back(rem);
+	}
+	else
+		divKnuth(a.limbs_, b.limbs_, q, r);
+
+	quotient.limbs_.swap(q);
+	quotient.negative_ = qNegative;
+	quotient.trim();
+	remainder.limbs_.swap(r);
+	remainder.negative_ = rNegative;
+	remainder.trim();
+	return true;
+}
+
+BigInteger& BigInteger::operator+=(const BigInteger& other)
+{
+	add(other, other.negative_);
+	return *this;
+}
+
+BigInteger& BigInteger::operator-=(const BigInteger& other)
+{
+	add(other, !other.negative_ && !other.isZero());
+	return *this;
+}
+
+BigInteger& BigInteger::operator*=(const BigInteger& other)
+{
+	if (isZero() || other.isZero())
+	{
+		*this = BigInteger();
+		return *this;
+	}
+
+	Limbs product(limbs_.size() + other.limbs_.size(), 0);
+	mulKaratsuba(limbs_.data(), limbs_.size(), other.limbs_.data(), other.limbs_.size(), product.data());
+	limbs_.swap(product);
+	negative_ = negative_ != other.negative_;
+	trim();
+	return *this;
+}
+
+BigInteger& BigInteger::operator/=(const BigInteger& other)
+{
+	BigInteger remainder;
+	if (!divide(*this, other, *this, remainder))
+		reportError(BIG_INTEGER_ERRORS[BigIntegerError::DIVIDED_BY_ZERO]);
+	return *this;
+}
+
+BigInteger& BigInteger::operator%=(const BigInteger& other)
+{
+	BigInteger quotient;
+	if (!divide(*this, other, quotient, *this))
+		reportError(BIG_INTEGER_ERRORS[BigIntegerError::DIVIDED_BY_ZERO]);
+	return *this;
+}
+
+BigInteger BigInteger::operator-() const
+{
+	BigInteger res(*this);
+	res.negative_ = !negative_ && !isZero();
+	return res;
+}
+
+int BigInteger::compare(const BigInteger& other) const
+{
+	if (negative_ != other.negative_)
+		return negative_ ? -1 : 1;
+
+	int res = compareMagnitude(other);
+	return negative_ ? -res : res;
+}
+
+bool BigInteger::operator==(const BigInteger& other) const
+{
+	return negative_ == other.negative_ && limbs_ == other.limbs_;
+}
+
+bool BigInteger::operator!=(const BigInteger& other) const
+{
+	return !(*this == other);
+}
+
+bool BigInteger::operator>(const BigInteger& other) const
+{
+	return compare(other) > 0;
+}
+
+bool BigInteger::operator>=(const BigInteger& other) const
+{
+	return compare(other) >= 0;
+}
+
+bool BigInteger::operator<(const BigInteger& other) const
+{
+	return compare(other) < 0;
+}
+
+bool BigInteger::operator<=(const BigInteger& other) const
+{
+	return compare(other) <= 0;
+}
+
+bool BigInteger::isZero() const
+{
+	return limbs_.empty();
+}
+
+bool BigInteger::isNegative() const
+{
+	return negative_;
+}
+
+size_t BigInteger::getLimbCount() const
+{
+	return limbs_.size();
+}
+
+size_t BigInteger::bitLength() const
+{
+	if (limbs_.empty())
+		return 0;
+	size_t bits = 32 * (limbs_.size() - 1);
+	for (uint32_t top = limbs_.back(); top != 0; top >>= 1)
+		bits++;
+	return bits;
+}
+
+size_t BigInteger::hash() const
+{
+	size_t res = negative_ ? 1 : 0;
+	for (uint32_t limb : limbs_)
+		res = hashing::combine(res, limb);
+	return res;
+}
+
+size_t BigInteger::trailingZeros() const
+{
+	size_t bits = 0, k = 0;
+	for (; k < limbs_.size() && limbs_[k] == 0; k++)
+		bits += 32;
+	if (k < limbs_.size())
+		for (uint32_t low = limbs_[k]; (low & 1) == 0; low >>= 1)
+			bits++;
+	return bits;
+}
+
+bool BigInteger::fitsInt64() const
+{
+	if (limbs_.size() <= 1)
+		return true;
+	if (limbs_.size() > 2)
+		return false;
+
+	uint64_t magnitude = ((uint64_t)limbs_[1] << 32) | limbs_[0];
+	return magnitude <= (uint64_t)INT64_MAX || (negative_ && magnitude == (uint64_t)INT64_MAX + 1);
+}
+
+int64_t BigInteger::toInt64() const
+{
+	uint64_t magnitude = 0;
+	if (limbs_.size() > 0)
+		magnitude = limbs_[0];
+	if (limbs_.size() > 1)
+		magnitude |= (uint64_t)limbs_[1] << 32;
+	return (int64_t)(negative_ ? 0 - magnitude : magnitude);
+}
+
+std::string BigInteger::toString() const
+{
+	if (isZero())
+		return "0";
+
+	Limbs magnitude = limbs_;
+	std::vector<uint32_t> chunks;
+	while (!magnitude.empty())
+		chunks.push_back(divSmall(magnitude, DECIMAL_BASE));
+
+	std::string res = negative_ ? "-" : "";
+	res += std::to_string(chunks.back());
+	for (size_t i = chunks.size() - 1; i-- > 0;)
+	{
+		std::string chunk = std::to_string(chunks[i]);
+		res.append(DECIMAL_DIGITS - chunk.size(), '0');
+		res += chunk;
+	}
+	return res;
+}
+
+std::to_chars_result BigInteger::toChars(char* first, char* last) const
+{
+	if (isZero())
+		return std::to_chars(first, last, 0);
+
+	Limbs magnitude = limbs_;
+	std::vector<uint32_t> chunks;
+	while (!magnitude.empty())
+		chunks.push_back(divSmall(magnitude, DECIMAL_BASE));
+
+	size_t length = (negative_ ? 1 : 0) + (chunks.size() - 1) * DECIMAL_DIGITS;
+	if ((size_t)(last - first) < length)
+		return { last, std::errc::value_too_large };
+	if (negative_)
+		*first++ = '-';
+	std::to_chars_result res = std::to_chars(first, last - (chunks.size() - 1) * DECIMAL_DIGITS, chunks.back());
+	if (res.ec != std::errc())
+		return { last, std::errc::value_too_large };
+
+	// Lower chunks have exactly nine digits, leading zeros included
+	first = res.ptr;
+	for (size_t i = chunks.size() - 1; i-- > 0;)
+	{
+		uint32_t chunk = chunks[i];
+		for (size_t k = DECIMAL_DIGITS; k-- > 0; chunk /= 10)
+			first[k] = (char)('0' + chunk % 10);
+		first += DECIMAL_DIGITS;
+	}
+	return { first, std::errc() };
+}
+
+std::ostream& operator<<(std::ostream& stream, const BigInteger& integer)
+{
+	stream << integer.toString();
+	return stream;
+}
+
+BigInteger operator+(BigInteger a, const BigInteger& b)
+{
+	a += b;
+	return a;
+}
+
+BigInteger operator-(BigInteger a, const BigInteger& b)
+{
+	a -= b;
+	return a;
+}
+
+BigInteger operator*(BigInteger a, const BigInteger& b)
+{
+	a *= b;
+	return a;
+}
+
+BigInteger operator/(const BigInteger& a, const BigInteger& b)
+{
+	BigInteger res(a);
+	res /= b;
+	return res;
+}
+
+BigInteger operator%(const BigInteger& a, const BigInteger& b)
+{
+	BigInteger res(a);
+	res %= b;
+	return res;
+}
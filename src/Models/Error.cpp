@@ -1,18 +1,26 @@
 #include "models/Error.h"
+#include <atomic>
+#include <iostream>
 
-Error::Error(int code, std::string message)
-	: code(code), message(message)
-{}
+namespace
+{
+	std::atomic<ErrorHandler> handler{ nullptr };
+	thread_local Error lastError;
+}
+
+char const* Error::getSource() const
+{
+	return source;
+}
 
-Error::Error(const Error& other)
-	: code(other.code), message(other.message)
-{}
+int Error::getCode() const
+{
+	return code;
+}
 
-Error& Error::operator=(const Error& other)
+char const* Error::getMessage() const
 {
-	code = other.code;
-	message = other.message;
-	return *this;
+	return message;
 }
 
 Error::operator bool() const
@@ -25,6 +33,34 @@ std::ostream& operator<<(std::ostream& stream, const Error& error)
 	if (!error)
 		stream << "OK";
 	else
-		stream << "ERROR " << error.code << ": " << error.message;
+		stream << "ERROR " << error.code << ": [" << error.source << "] " << error.message;
 	return stream;
-}
\ No newline at end of file
+}
+
+ErrorHandler setErrorHandler(ErrorHandler newHandler)
+{
+	return handler.exchange(newHandler);
+}
+
+void reportError(const Error& error)
+{
+	lastError = error;
+	ErrorHandler current = handler.load(std::memory_order_acquire);
+	if (current != nullptr)
+		current(error);
+}
+
+Error getLastError()
+{
+	return lastError;
+}
+
+void clearLastError()
+{
+	lastError = Error();
+}
+
+void printError(const Error& error)
+{
+	std::cerr << error << "\n";
+}
@@ -1,274 +1,178 @@
 #include "models/Integer.h"
+#include "models/Chars.h"
 #include "models/Error.h"
 #include <string>
 
-const std::string CLASS_PREFIX = "[Integer] ";
-const int MIN_VALUE = std::numeric_limits<int>::min();
-const int MAX_VALUE = std::numeric_limits<int>::max();
-
-class IntegerError : public Error
+namespace
 {
-public:
-	enum Code 
-	{ 
-		OK = 0, 
-		ADD_OVERFLOW = 1, 
-		MULT_OVERFLOW = 2, 
-		SUB_OVERFLOW = 3, 
-		DIVIDED_BY_ZERO = 4 
-	};
-	IntegerError(const Code code);
+	constexpr char const* SOURCE = "Integer";
 
-private:
-	std::string getMessage(const Code code);
-};
-
-std::string IntegerError::getMessage(const Code code)
-{
-	switch (code) 
+	enum IntegerError
 	{
-	case OK:
-		return "";
-		break;
-	case ADD_OVERFLOW:
-		return CLASS_PREFIX + "(+) overflow detected";
-		break;
-	case MULT_OVERFLOW:
-		return CLASS_PREFIX + "(*) overflow detected";
-		break;
-	case SUB_OVERFLOW:
-		return CLASS_PREFIX + "(-) overflow detected";
-		break;
-	case DIVIDED_BY_ZERO:
-		return CLASS_PREFIX + "(/ 0, % 0) is undefined";
-		break;
-	}
-}
-
-IntegerError::IntegerError(const Code code)
-	: Error(code, getMessage(code))
-{ }
-
-Integer::Integer(int i)
-	: i(i)
-{}
-
-Integer::Integer(const Integer& other)
-	: i(other.i)
-{}
+		OK = 0,
+		DIVIDED_BY_ZERO = 1
+	};
 
-Integer& Integer::operator=(const Integer& other)
-{
-	i = other.i;
-	return *this;
+	// Indexed by IntegerError
+	constexpr Error INTEGER_ERRORS[] =
+	{
+		Error(),
+		Error(SOURCE, DIVIDED_BY_ZERO, "(/ 0, % 0) is undefined")
+	};
 }
 
-Integer& Integer::operator=(int value)
+Integer::Integer(const BigInteger& value)
+	: i(0), big(nullptr)
 {
-	i = value;
-	return *this;
+	setBig(BigInteger(value));
 }
 
-Integer& Integer::operator+=(const Integer& other)
+Integer::Integer(BigInteger&& value)
+	: i(0), big(nullptr)
 {
-	if ((i >= 0) && (other.i >= 0) && (i > MAX_VALUE - other.i)) // Two non negative, can reach MAX
-		std::cerr << IntegerError(IntegerError::ADD_OVERFLOW) << "\n";
-	else if ((i < 0) && (other.i < 0) && (i < MIN_VALUE - other.i)) // Two negative, can reach MIN
-		std::cerr << IntegerError(IntegerError::ADD_OVERFLOW) << "\n";
-	else
-		i += other.i; // No problemo, can't reach MIN or MAX
-
-	return *this;
+	setBig(std::move(value));
 }
 
-Integer& Integer::operator-=(const Integer & other)
+// Keeps the invariant: big is set only for values outside int64_t
+void Integer::setBig(BigInteger&& value)
 {
-	if ((i < 0) && (other.i >= 0) && (i < MIN_VALUE + other.i)) // Equivalent of two negative addition
-		std::cerr << IntegerError(IntegerError::SUB_OVERFLOW) << "\n";
-	else if ((i >= 0) && (other.i < 0) && (i > MAX_VALUE + other.i)) // Equivalent of two non-negative addition
-		std::cerr << IntegerError(IntegerError::SUB_OVERFLOW) << "\n";
+	if (value.fitsInt64())
+	{
+		i = value.toInt64();
+		delete big;
+		big = nullptr;
+	}
+	else if (big)
+		*big = std::move(value);
 	else
-		i -= other.i;
-
-	return *this;
-}
-
-Integer& Integer::operator*=(const Integer& other)
-{
-	if (!i || !other.i) // At least one of the operands is zero
 	{
 		i = 0;
-		return *this;
+		big = new BigInteger(std::move(value));
 	}
-
-	bool neg = (i < 0) && (other.i > 0) || (i > 0) && (other.i < 0); // Sign of *
-
-	int a = i < 0 ? -i : i; // Absolute values
-	int b = other.i < 0 ? -other.i : other.i; 
-
-	if (MAX_VALUE / a < b)
-		std::cerr << IntegerError(IntegerError::MULT_OVERFLOW) << "\n";
-	else
-		i = i * other.i;
-
-	return *this;
 }
 
-Integer& Integer::operator/=(const Integer& other)
+BigInteger Integer::toBig() const
 {
-	if (other.i == 0)
-		std::cerr << IntegerError(IntegerError::DIVIDED_BY_ZERO) << "\n";
-	else
-		i /= other.i;
-
-	return *this;
+	return big ? *big : BigInteger(i);
 }
 
-Integer& Integer::operator%=(const Integer& other)
+void Integer::addBig(const Integer& other)
 {
-	if (other.i == 0)
-		std::cerr << IntegerError(IntegerError::DIVIDED_BY_ZERO) << "\n";
-	else
-		i %= other.i;
-
-	return *this;
+	setBig(toBig() + other.toBig());
 }
 
-Integer Integer::operator-()
+void Integer::subBig(const Integer& other)
 {
-	return Integer(-i);
+	setBig(toBig() - other.toBig());
 }
 
-bool Integer::operator==(const Integer& other) const
+void Integer::mulBig(const Integer& other)
 {
-	return i == other.i;
+	setBig(toBig() * other.toBig());
 }
 
-bool Integer::operator!=(const Integer& other) const
+void Integer::divBig(const Integer& other)
 {
-	return i != other.i;
+	setBig(toBig() / other.toBig());
 }
 
-bool Integer::operator>(const Integer& other) const
+void Integer::remBig(const Integer& other)
 {
-	return i > other.i;
+	setBig(toBig() % other.toBig());
 }
 
-bool Integer::operator>=(const Integer& other) const
+void Integer::reportDivisionByZero()
 {
-	return i >= other.i;
+	reportError(INTEGER_ERRORS[IntegerError::DIVIDED_BY_ZERO]);
 }
 
-bool Integer::operator<(const Integer& other) const
+size_t Integer::bitLength() const
 {
-	return i < other.i;
+	if (big)
+		return big->bitLength();
+	size_t bits = 0;
+	for (uint64_t magnitude = i < 0 ? 0 - (uint64_t)i : (uint64_t)i; magnitude != 0; magnitude >>= 1)
+		bits++;
+	return bits;
 }
 
-bool Integer::operator<=(const Integer& other) const
+size_t Integer::trailingZeros() const
 {
-	return i <= other.i;
+	if (big)
+		return big->trailingZeros();
+	return i == 0 ? 0 : overflow::trailingZeros((uint64_t)i);
 }
 
-bool Integer::operator==(int value) const
+int Integer::compareBig(const Integer& other) const
 {
-	return i == value;
+	return toBig().compare(other.toBig());
 }
 
-bool Integer::operator!=(int value) const
+std::to_chars_result Integer::toChars(char* first, char* last) const
 {
-	return i != value;
+	if (big)
+		return big->toChars(first, last);
+	return std::to_chars(first, last, i);
 }
 
-bool Integer::operator>(int value) const
+std::from_chars_result Integer::fromChars(const char* first, const char* last, Integer& res)
 {
-	return i > value;
-}
-
-bool Integer::operator>=(int value) const
-{
-	return i >= value;
-}
+	// Up to 18 digits always fit in a word
+	const char* digits = first != last && *first == '-' ? first + 1 : first;
+	const char* end = digits;
+	while (end != last && *end >= '0' && *end <= '9' && end - digits <= 18)
+		end++;
+	if (end - digits <= 18)
+	{
+		int64_t value = 0;
+		std::from_chars_result parsed = std::from_chars(first, end, value);
+		if (parsed.ec == std::errc() && parsed.ptr == end)
+			res = Integer(value);
+		return parsed.ptr == end ? parsed : std::from_chars_result{ first, std::errc::invalid_argument };
+	}
 
-bool Integer::operator<(int value) const
-{
-	return i < value;
+	BigInteger value;
+	std::from_chars_result parsed = BigInteger::fromChars(first, last, value);
+	if (parsed.ec == std::errc())
+		res.setBig(std::move(value));
+	return parsed;
 }
 
-bool Integer::operator<=(int value) const
+std::to_chars_result Integer::toChars(char* first, char* last, std::span<const Integer> values, char separator)
 {
-	return i <= value;
+	return chars::formatAll(first, last, values, separator);
 }
 
-Integer::operator int() const
+std::from_chars_result Integer::fromChars(const char* first, const char* last, std::span<Integer> values, size_t& count)
 {
-	return i;
+	return chars::parseAll(first, last, values, count);
 }
 
 std::ostream& operator<<(std::ostream& stream, const Integer& integer)
 {
-	stream << integer.i;
+	if (integer.big)
+		stream << *integer.big;
+	else
+		stream << integer.i;
 	return stream;
 }
 
 std::istream& operator>>(std::istream& stream, Integer& integer)
 {
-	int x;
-	stream >> x;
-	integer.i = x;
-	return stream;
-}
-
-Integer operator+(Integer a, const Integer & b)
-{
-	a += b;
-	return a;
-}
-
-Integer operator-(Integer a, const Integer & b)
-{
-	a -= b;
-	return a;
-}
+	std::string digits;
+	if (!(stream >> digits))
+		return stream;
 
-Integer operator*(Integer a, const Integer & b)
-{
-	a *= b;
-	return a;
-}
+	const char* first = digits.data();
+	const char* last = first + digits.size();
+	if (first != last && *first == '+' && ++first != last && *first == '-')
+		first = last;
 
-Integer operator/(Integer a, const Integer& b)
-{
-	a /= b;
-	return a;
-}
-
-Integer operator%(Integer a, const Integer& b)
-{
-	a %= b;
-	return a;
+	Integer value;
+	std::from_chars_result parsed = Integer::fromChars(first, last, value);
+	if (parsed.ec == std::errc() && parsed.ptr == last)
+		integer = std::move(value);
+	else
+		stream.setstate(std::ios::failbit);
+	return stream;
 }
-
-
-Integer GCD(Integer a, Integer b)
-{
-	if (a == 0 && b != 0)
-		return b;
-
-	if (b == 0 && a != 0)
-		return a;
-
-	if (a < b)
-		std::swap(a, b);
-
-	Integer res;
-
-	Integer r = a % b;
-	while (r != 0) {
-		a = b;
-		b = r;
-		r = a % b;
-	}
-	res = b;
-
-	return res;
-}
\ No newline at end of file
@@ -0,0 +1,618 @@
+#include "models/IntervalArray.h"
+#include "models/Error.h"
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define INTERVAL_SIMD
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+#define AVX512_TARGET __attribute__((target("avx512f,avx2,fma")))
+#endif
+
+namespace
+{
+	constexpr char const* SOURCE = "IntervalArray";
+
+	constexpr double NOT_A_NUMBER = std::numeric_limits<double>::quiet_NaN();
+
+	// Processes count elements from the start, returns how many it did: all for the
+	// scalar kernels, whole vectors for the SIMD ones
+	typedef size_t (*BinaryKernel)(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& failed);
+	typedef size_t (*ZeroKernel)(const double* lower, const double* upper, uint8_t* res, size_t count);
+
+	// Same choice as the min / max instructions, so that all kernels give the same bits
+	double lesser(double x, double y)
+	{
+		return x < y ? x : y;
+	}
+
+	double greater(double x, double y)
+	{
+		return x > y ? x : y;
+	}
+
+	size_t addScalar(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& /*failed*/)
+	{
+		for (size_t k = 0; k < count; k++)
+		{
+			double lo = rounding::addDown(a[k], c[k]);
+			double hi = rounding::addUp(b[k], d[k]);
+			lower[k] = lo;
+			upper[k] = hi;
+		}
+		return count;
+	}
+
+	size_t subScalar(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& /*failed*/)
+	{
+		for (size_t k = 0; k < count; k++)
+		{
+			double lo = rounding::subDown(a[k], d[k]);
+			double hi = rounding::subUp(b[k], c[k]);
+			lower[k] = lo;
+			upper[k] = hi;
+		}
+		return count;
+	}
+
+	// The bounds are the extreme corner products: for a bound x of the first interval the
+	// extreme over the second one is at the end its sign picks
+	size_t mulScalar(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& /*failed*/)
+	{
+		for (size_t k = 0; k < count; k++)
+		{
+			double ak = a[k], bk = b[k], ck = c[k], dk = d[k];
+			lower[k] = lesser(rounding::mulDown(ak, ak >= 0 ? ck : dk), rounding::mulDown(bk, bk >= 0 ? ck : dk));
+			upper[k] = greater(rounding::mulUp(ak, ak >= 0 ? dk : ck), rounding::mulUp(bk, bk >= 0 ? dk : ck));
+		}
+		return count;
+	}
+
+	size_t divScalar(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& failed)
+	{
+		for (size_t k = 0; k < count; k++)
+		{
+			double ak = a[k], bk = b[k], ck = c[k], dk = d[k];
+			if (ck <= 0 && dk >= 0)
+			{
+				lower[k] = upper[k] = NOT_A_NUMBER;
+				failed = true;
+				continue;
+			}
+			lower[k] = lesser(rounding::divDown(ak, ak >= 0 ? dk : ck), rounding::divDown(bk, bk >= 0 ? dk : ck));
+			upper[k] = greater(rounding::divUp(ak, ak >= 0 ? ck : dk), rounding::divUp(bk, bk >= 0 ? ck : dk));
+		}
+		return count;
+	}
+
+	size_t containsZeroScalar(const double* lower, const double* upper, uint8_t* res, size_t count)
+	{
+		for (size_t k = 0; k < count; k++)
+			res[k] = lower[k] <= 0 && upper[k] >= 0;
+		return count;
+	}
+
+#ifdef INTERVAL_SIMD
+	// The functions of Rounding.h on 4 lanes, FMA gives the product errors
+
+	AVX2_TARGET inline __m256d negate4(__m256d x)
+	{
+		return _mm256_xor_pd(x, _mm256_set1_pd(-0.0));
+	}
+
+	AVX2_TARGET inline __m256d nextDown4(__m256d x)
+	{
+		const __m256d zero = _mm256_setzero_pd();
+		__m256d positive = _mm256_cmp_pd(x, zero, _CMP_GT_OQ);
+		__m256d negative = _mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_LT_OQ), _mm256_cmp_pd(x, _mm256_set1_pd(-INFINITY), _CMP_NEQ_OQ));
+		// Compare masks are -1 as integers
+		__m256i bits = _mm256_castpd_si256(x);
+		bits = _mm256_add_epi64(bits, _mm256_castpd_si256(positive));
+		bits = _mm256_sub_epi64(bits, _mm256_castpd_si256(negative));
+		__m256d zeros = _mm256_cmp_pd(x, zero, _CMP_EQ_OQ);
+		return _mm256_blendv_pd(_mm256_castsi256_pd(bits), _mm256_set1_pd(-std::numeric_limits<double>::denorm_min()), zeros);
+	}
+
+	AVX2_TARGET inline __m256d down4(__m256d res, __m256d error)
+	{
+		__m256d step = _mm256_cmp_pd(error, _mm256_setzero_pd(), _CMP_NGE_UQ);
+		return _mm256_blendv_pd(res, nextDown4(res), step);
+	}
+
+	AVX2_TARGET inline __m256d up4(__m256d res, __m256d error)
+	{
+		__m256d step = _mm256_cmp_pd(error, _mm256_setzero_pd(), _CMP_NLE_UQ);
+		return _mm256_blendv_pd(res, negate4(nextDown4(negate4(res))), step);
+	}
+
+	AVX2_TARGET inline __m256d sumError4(__m256d a, __m256d b, __m256d s)
+	{
+		__m256d bb = _mm256_sub_pd(s, a);
+		return _mm256_add_pd(_mm256_sub_pd(a, _mm256_sub_pd(s, bb)), _mm256_sub_pd(b, bb));
+	}
+
+	AVX2_TARGET inline __m256d isAtLeast4(__m256d x, double bound)
+	{
+		__m256d magnitude = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+		return _mm256_cmp_pd(magnitude, _mm256_set1_pd(bound), _CMP_GE_OQ);
+	}
+
+	AVX2_TARGET inline __m256d productError4(__m256d a, __m256d b, __m256d p)
+	{
+		const __m256d zero = _mm256_setzero_pd();
+		__m256d magnitude = _mm256_andnot_pd(_mm256_set1_pd(-0.0), p);
+		__m256d valid = _mm256_and_pd(isAtLeast4(p, rounding::TINY), _mm256_cmp_pd(magnitude, _mm256_set1_pd(rounding::HUGE_RESULT), _CMP_LE_OQ));
+		__m256d error = _mm256_blendv_pd(_mm256_set1_pd(NOT_A_NUMBER), _mm256_fmsub_pd(a, b, p), valid);
+		__m256d zeroOperand = _mm256_or_pd(_mm256_cmp_pd(a, zero, _CMP_EQ_OQ), _mm256_cmp_pd(b, zero, _CMP_EQ_OQ));
+		return _mm256_blendv_pd(error, zero, zeroOperand);
+	}
+
+	// Error of q = a / b with the sign of b folded in
+	AVX2_TARGET inline __m256d quotientError4(__m256d a, __m256d b, __m256d q)
+	{
+		const __m256d zero = _mm256_setzero_pd();
+		__m256d valid = _mm256_and_pd(isAtLeast4(a, rounding::TINY), isAtLeast4(q, rounding::TINY));
+		__m256d r = _mm256_blendv_pd(_mm256_set1_pd(NOT_A_NUMBER), _mm256_fnmadd_pd(q, b, a), valid);
+		r = _mm256_blendv_pd(r, zero, _mm256_cmp_pd(a, zero, _CMP_EQ_OQ));
+		return _mm256_xor_pd(r, _mm256_and_pd(b, _mm256_set1_pd(-0.0)));
+	}
+
+	AVX2_TARGET inline __m256d mulDown4(__m256d a, __m256d b)
+	{
+		__m256d p = _mm256_mul_pd(a, b);
+		return down4(p, productError4(a, b, p));
+	}
+
+	AVX2_TARGET inline __m256d mulUp4(__m256d a, __m256d b)
+	{
+		__m256d p = _mm256_mul_pd(a, b);
+		return up4(p, productError4(a, b, p));
+	}
+
+	AVX2_TARGET inline __m256d divDown4(__m256d a, __m256d b)
+	{
+		__m256d q = _mm256_div_pd(a, b);
+		return down4(q, quotientError4(a, b, q));
+	}
+
+	AVX2_TARGET inline __m256d divUp4(__m256d a, __m256d b)
+	{
+		__m256d q = _mm256_div_pd(a, b);
+		return up4(q, quotientError4(a, b, q));
+	}
+
+	AVX2_TARGET size_t addAvx2(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& /*failed*/)
+	{
+		size_t k = 0;
+		for (; k + 4 <= count; k += 4)
+		{
+			__m256d va = _mm256_loadu_pd(a + k), vb = _mm256_loadu_pd(b + k);
+			__m256d vc = _mm256_loadu_pd(c + k), vd = _mm256_loadu_pd(d + k);
+			__m256d lo = _mm256_add_pd(va, vc);
+			__m256d hi = _mm256_add_pd(vb, vd);
+			_mm256_storeu_pd(lower + k, down4(lo, sumError4(va, vc, lo)));
+			_mm256_storeu_pd(upper + k, up4(hi, sumError4(vb, vd, hi)));
+		}
+		return k;
+	}
+
+	AVX2_TARGET size_t subAvx2(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& /*failed*/)
+	{
+		size_t k = 0;
+		for (; k + 4 <= count; k += 4)
+		{
+			__m256d va = _mm256_loadu_pd(a + k), vb = _mm256_loadu_pd(b + k);
+			__m256d vc = negate4(_mm256_loadu_pd(c + k)), vd = negate4(_mm256_loadu_pd(d + k));
+			__m256d lo = _mm256_add_pd(va, vd);
+			__m256d hi = _mm256_add_pd(vb, vc);
+			_mm256_storeu_pd(lower + k, down4(lo, sumError4(va, vd, lo)));
+			_mm256_storeu_pd(upper + k, up4(hi, sumError4(vb, vc, hi)));
+		}
+		return k;
+	}
+
+	AVX2_TARGET size_t mulAvx2(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& /*failed*/)
+	{
+		const __m256d zero = _mm256_setzero_pd();
+		size_t k = 0;
+		for (; k + 4 <= count; k += 4)
+		{
+			__m256d va = _mm256_loadu_pd(a + k), vb = _mm256_loadu_pd(b + k);
+			__m256d vc = _mm256_loadu_pd(c + k), vd = _mm256_loadu_pd(d + k);
+			__m256d aPositive = _mm256_cmp_pd(va, zero, _CMP_GE_OQ);
+			__m256d bPositive = _mm256_cmp_pd(vb, zero, _CMP_GE_OQ);
+			__m256d lo = _mm256_min_pd(mulDown4(va, _mm256_blendv_pd(vd, vc, aPositive)), mulDown4(vb, _mm256_blendv_pd(vd, vc, bPositive)));
+			__m256d hi = _mm256_max_pd(mulUp4(va, _mm256_blendv_pd(vc, vd, aPositive)), mulUp4(vb, _mm256_blendv_pd(vc, vd, bPositive)));
+			_mm256_storeu_pd(lower + k, lo);
+			_mm256_storeu_pd(upper + k, hi);
+		}
+		return k;
+	}
+
+	AVX2_TARGET size_t divAvx2(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& failed)
+	{
+		const __m256d zero = _mm256_setzero_pd();
+		const __m256d nan = _mm256_set1_pd(NOT_A_NUMBER);
+		size_t k = 0;
+		for (; k + 4 <= count; k += 4)
+		{
+			__m256d va = _mm256_loadu_pd(a + k), vb = _mm256_loadu_pd(b + k);
+			__m256d vc = _mm256_loadu_pd(c + k), vd = _mm256_loadu_pd(d + k);
+			__m256d aPositive = _mm256_cmp_pd(va, zero, _CMP_GE_OQ);
+			__m256d bPositive = _mm256_cmp_pd(vb, zero, _CMP_GE_OQ);
+			__m256d lo = _mm256_min_pd(divDown4(va, _mm256_blendv_pd(vc, vd, aPositive)), divDown4(vb, _mm256_blendv_pd(vc, vd, bPositive)));
+			__m256d hi = _mm256_max_pd(divUp4(va, _mm256_blendv_pd(vd, vc, aPositive)), divUp4(vb, _mm256_blendv_pd(vd, vc, bPositive)));
+			__m256d zeroInside = _mm256_and_pd(_mm256_cmp_pd(vc, zero, _CMP_LE_OQ), _mm256_cmp_pd(vd, zero, _CMP_GE_OQ));
+			if (_mm256_movemask_pd(zeroInside) != 0)
+				failed = true;
+			_mm256_storeu_pd(lower + k, _mm256_blendv_pd(lo, nan, zeroInside));
+			_mm256_storeu_pd(upper + k, _mm256_blendv_pd(hi, nan, zeroInside));
+		}
+		return k;
+	}
+
+	AVX2_TARGET size_t containsZeroAvx2(const double* lower, const double* upper, uint8_t* res, size_t count)
+	{
+		const __m256d zero = _mm256_setzero_pd();
+		size_t k = 0;
+		for (; k + 4 <= count; k += 4)
+		{
+			__m256d inside = _mm256_and_pd(_mm256_cmp_pd(_mm256_loadu_pd(lower + k), zero, _CMP_LE_OQ),
+				_mm256_cmp_pd(_mm256_loadu_pd(upper + k), zero, _CMP_GE_OQ));
+			int bits = _mm256_movemask_pd(inside);
+			for (int lane = 0; lane < 4; lane++)
+				res[k + lane] = (bits >> lane) & 1;
+		}
+		return k;
+	}
+
+	// The same on 8 lanes with mask registers
+
+	AVX512_TARGET inline __m512d negate8(__m512d x)
+	{
+		return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(x), _mm512_set1_epi64(INT64_MIN)));
+	}
+
+	AVX512_TARGET inline __m512d nextDown8(__m512d x)
+	{
+		const __m512d zero = _mm512_setzero_pd();
+		const __m512i one = _mm512_set1_epi64(1);
+		__mmask8 positive = _mm512_cmp_pd_mask(x, zero, _CMP_GT_OQ);
+		__mmask8 negative = _mm512_cmp_pd_mask(x, zero, _CMP_LT_OQ) & _mm512_cmp_pd_mask(x, _mm512_set1_pd(-INFINITY), _CMP_NEQ_OQ);
+		__m512i bits = _mm512_castpd_si512(x);
+		bits = _mm512_mask_sub_epi64(bits, positive, bits, one);
+		bits = _mm512_mask_add_epi64(bits, negative, bits, one);
+		__mmask8 zeros = _mm512_cmp_pd_mask(x, zero, _CMP_EQ_OQ);
+		return _mm512_mask_blend_pd(zeros, _mm512_castsi512_pd(bits), _mm512_set1_pd(-std::numeric_limits<double>::denorm_min()));
+	}
+
+	AVX512_TARGET inline __m512d down8(__m512d res, __m512d error)
+	{
+		__mmask8 step = _mm512_cmp_pd_mask(error, _mm512_setzero_pd(), _CMP_NGE_UQ);
+		return _mm512_mask_blend_pd(step, res, nextDown8(res));
+	}
+
+	AVX512_TARGET inline __m512d up8(__m512d res, __m512d error)
+	{
+		__mmask8 step = _mm512_cmp_pd_mask(error, _mm512_setzero_pd(), _CMP_NLE_UQ);
+		return _mm512_mask_blend_pd(step, res, negate8(nextDown8(negate8(res))));
+	}
+
+	AVX512_TARGET inline __m512d sumError8(__m512d a, __m512d b, __m512d s)
+	{
+		__m512d bb = _mm512_sub_pd(s, a);
+		return _mm512_add_pd(_mm512_sub_pd(a, _mm512_sub_pd(s, bb)), _mm512_sub_pd(b, bb));
+	}
+
+	// _mm512_min_pd/_mm512_max_pd pass an undefined merge source that GCC 12 reports
+	// as maybe uninitialized: give the full-mask forms a zero one instead
+
+	AVX512_TARGET inline __m512d min8(__m512d a, __m512d b)
+	{
+		return _mm512_mask_min_pd(_mm512_setzero_pd(), 0xFF, a, b);
+	}
+
+	AVX512_TARGET inline __m512d max8(__m512d a, __m512d b)
+	{
+		return _mm512_mask_max_pd(_mm512_setzero_pd(), 0xFF, a, b);
+	}
+
+	AVX512_TARGET inline __mmask8 isAtLeast8(__m512d x, double bound)
+	{
+		return _mm512_cmp_pd_mask(_mm512_abs_pd(x), _mm512_set1_pd(bound), _CMP_GE_OQ);
+	}
+
+	AVX512_TARGET inline __m512d productError8(__m512d a, __m512d b, __m512d p)
+	{
+		const __m512d zero = _mm512_setzero_pd();
+		__mmask8 valid = isAtLeast8(p, rounding::TINY) & _mm512_cmp_pd_mask(_mm512_abs_pd(p), _mm512_set1_pd(rounding::HUGE_RESULT), _CMP_LE_OQ);
+		__m512d error = _mm512_mask_blend_pd(valid, _mm512_set1_pd(NOT_A_NUMBER), _mm512_fmsub_pd(a, b, p));
+		__mmask8 zeroOperand = _mm512_cmp_pd_mask(a, zero, _CMP_EQ_OQ) | _mm512_cmp_pd_mask(b, zero, _CMP_EQ_OQ);
+		return _mm512_mask_blend_pd(zeroOperand, error, zero);
+	}
+
+	AVX512_TARGET inline __m512d quotientError8(__m512d a, __m512d b, __m512d q)
+	{
+		const __m512d zero = _mm512_setzero_pd();
+		__mmask8 valid = isAtLeast8(a, rounding::TINY) & isAtLeast8(q, rounding::TINY);
+		__m512d r = _mm512_mask_blend_pd(valid, _mm512_set1_pd(NOT_A_NUMBER), _mm512_fnmadd_pd(q, b, a));
+		r = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(a, zero, _CMP_EQ_OQ), r, zero);
+		__m512i sign = _mm512_and_si512(_mm512_castpd_si512(b), _mm512_set1_epi64(INT64_MIN));
+		return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(r), sign));
+	}
+
+	AVX512_TARGET inline __m512d mulDown8(__m512d a, __m512d b)
+	{
+		__m512d p = _mm512_mul_pd(a, b);
+		return down8(p, productError8(a, b, p));
+	}
+
+	AVX512_TARGET inline __m512d mulUp8(__m512d a, __m512d b)
+	{
+		__m512d p = _mm512_mul_pd(a, b);
+		return up8(p, productError8(a, b, p));
+	}
+
+	AVX512_TARGET inline __m512d divDown8(__m512d a, __m512d b)
+	{
+		__m512d q = _mm512_div_pd(a, b);
+		return down8(q, quotientError8(a, b, q));
+	}
+
+	AVX512_TARGET inline __m512d divUp8(__m512d a, __m512d b)
+	{
+		__m512d q = _mm512_div_pd(a, b);
+		return up8(q, quotientError8(a, b, q));
+	}
+
+	AVX512_TARGET size_t addAvx512(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& /*failed*/)
+	{
+		size_t k = 0;
+		for (; k + 8 <= count; k += 8)
+		{
+			__m512d va = _mm512_loadu_pd(a + k), vb = _mm512_loadu_pd(b + k);
+			__m512d vc = _mm512_loadu_pd(c + k), vd = _mm512_loadu_pd(d + k);
+			__m512d lo = _mm512_add_pd(va, vc);
+			__m512d hi = _mm512_add_pd(vb, vd);
+			_mm512_storeu_pd(lower + k, down8(lo, sumError8(va, vc, lo)));
+			_mm512_storeu_pd(upper + k, up8(hi, sumError8(vb, vd, hi)));
+		}
+		return k;
+	}
+
+	AVX512_TARGET size_t subAvx512(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& /*failed*/)
+	{
+		size_t k = 0;
+		for (; k + 8 <= count; k += 8)
+		{
+			__m512d va = _mm512_loadu_pd(a + k), vb = _mm512_loadu_pd(b + k);
+			__m512d vc = negate8(_mm512_loadu_pd(c + k)), vd = negate8(_mm512_loadu_pd(d + k));
+			__m512d lo = _mm512_add_pd(va, vd);
+			__m512d hi = _mm512_add_pd(vb, vc);
+			_mm512_storeu_pd(lower + k, down8(lo, sumError8(va, vd, lo)));
+			_mm512_storeu_pd(upper + k, up8(hi, sumError8(vb, vc, hi)));
+		}
+		return k;
+	}
+
+	AVX512_TARGET size_t mulAvx512(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& /*failed*/)
+	{
+		const __m512d zero = _mm512_setzero_pd();
+		size_t k = 0;
+		for (; k + 8 <= count; k += 8)
+		{
+			__m512d va = _mm512_loadu_pd(a + k), vb = _mm512_loadu_pd(b + k);
+			__m512d vc = _mm512_loadu_pd(c + k), vd = _mm512_loadu_pd(d + k);
+			__mmask8 aPositive = _mm512_cmp_pd_mask(va, zero, _CMP_GE_OQ);
+			__mmask8 bPositive = _mm512_cmp_pd_mask(vb, zero, _CMP_GE_OQ);
+			__m512d lo = min8(mulDown8(va, _mm512_mask_blend_pd(aPositive, vd, vc)), mulDown8(vb, _mm512_mask_blend_pd(bPositive, vd, vc)));
+			__m512d hi = max8(mulUp8(va, _mm512_mask_blend_pd(aPositive, vc, vd)), mulUp8(vb, _mm512_mask_blend_pd(bPositive, vc, vd)));
+			_mm512_storeu_pd(lower + k, lo);
+			_mm512_storeu_pd(upper + k, hi);
+		}
+		return k;
+	}
+
+	AVX512_TARGET size_t divAvx512(const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count, bool& failed)
+	{
+		const __m512d zero = _mm512_setzero_pd();
+		const __m512d nan = _mm512_set1_pd(NOT_A_NUMBER);
+		size_t k = 0;
+		for (; k + 8 <= count; k += 8)
+		{
+			__m512d va = _mm512_loadu_pd(a + k), vb = _mm512_loadu_pd(b + k);
+			__m512d vc = _mm512_loadu_pd(c + k), vd = _mm512_loadu_pd(d + k);
+			__mmask8 aPositive = _mm512_cmp_pd_mask(va, zero, _CMP_GE_OQ);
+			__mmask8 bPositive = _mm512_cmp_pd_mask(vb, zero, _CMP_GE_OQ);
+			__m512d lo = min8(divDown8(va, _mm512_mask_blend_pd(aPositive, vc, vd)), divDown8(vb, _mm512_mask_blend_pd(bPositive, vc, vd)));
+			__m512d hi = max8(divUp8(va, _mm512_mask_blend_pd(aPositive, vd, vc)), divUp8(vb, _mm512_mask_blend_pd(bPositive, vd, vc)));
+			__mmask8 zeroInside = _mm512_cmp_pd_mask(vc, zero, _CMP_LE_OQ) & _mm512_cmp_pd_mask(vd, zero, _CMP_GE_OQ);
+			if (zeroInside != 0)
+				failed = true;
+			_mm512_storeu_pd(lower + k, _mm512_mask_blend_pd(zeroInside, lo, nan));
+			_mm512_storeu_pd(upper + k, _mm512_mask_blend_pd(zeroInside, hi, nan));
+		}
+		return k;
+	}
+
+	AVX512_TARGET size_t containsZeroAvx512(const double* lower, const double* upper, uint8_t* res, size_t count)
+	{
+		const __m512d zero = _mm512_setzero_pd();
+		size_t k = 0;
+		for (; k + 8 <= count; k += 8)
+		{
+			__mmask8 inside = _mm512_cmp_pd_mask(_mm512_loadu_pd(lower + k), zero, _CMP_LE_OQ) &
+				_mm512_cmp_pd_mask(_mm512_loadu_pd(upper + k), zero, _CMP_GE_OQ);
+			for (int lane = 0; lane < 8; lane++)
+				res[k + lane] = (inside >> lane) & 1;
+		}
+		return k;
+	}
+#endif
+
+	struct Kernels
+	{
+		INTERVAL_KERNEL kind;
+		BinaryKernel add, sub, mul, div;
+		ZeroKernel containsZero;
+	};
+
+	constexpr Kernels SCALAR_KERNELS = { INTERVAL_KERNEL::SCALAR, addScalar, subScalar, mulScalar, divScalar, containsZeroScalar };
+#ifdef INTERVAL_SIMD
+	constexpr Kernels AVX2_KERNELS = { INTERVAL_KERNEL::AVX2, addAvx2, subAvx2, mulAvx2, divAvx2, containsZeroAvx2 };
+	constexpr Kernels AVX512_KERNELS = { INTERVAL_KERNEL::AVX512, addAvx512, subAvx512, mulAvx512, divAvx512, containsZeroAvx512 };
+#endif
+
+	// nullptr if the CPU lacks the kernel
+	const Kernels* findKernels(INTERVAL_KERNEL kind)
+	{
+		switch (kind)
+		{
+#ifdef INTERVAL_SIMD
+		case INTERVAL_KERNEL::AVX512:
+			return __builtin_cpu_supports("avx512f") ? &AVX512_KERNELS : nullptr;
+		case INTERVAL_KERNEL::AVX2:
+			return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") ? &AVX2_KERNELS : nullptr;
+#endif
+		case INTERVAL_KERNEL::SCALAR:
+			return &SCALAR_KERNELS;
+		default:
+			return nullptr;
+		}
+	}
+
+	const Kernels* bestKernels()
+	{
+		for (INTERVAL_KERNEL kind : { INTERVAL_KERNEL::AVX512, INTERVAL_KERNEL::AVX2 })
+			if (const Kernels* kernels = findKernels(kind))
+				return kernels;
+		return &SCALAR_KERNELS;
+	}
+
+	const Kernels*& activeKernels()
+	{
+		static const Kernels* active = bestKernels();
+		return active;
+	}
+
+	// The kernel does whole vectors, the scalar one the rest
+	bool run(BinaryKernel kernel, BinaryKernel scalar, const double* a, const double* b, const double* c, const double* d,
+		double* lower, double* upper, size_t count)
+	{
+		bool failed = false;
+		size_t done = kernel(a, b, c, d, lower, upper, count, failed);
+		scalar(a + done, b + done, c + done, d + done, lower + done, upper + done, count - done, failed);
+		return failed;
+	}
+}
+
+void IntervalArray::report(IntervalArrayError code)
+{
+	// Indexed by IntervalArrayError
+	static constexpr Error INTERVAL_ARRAY_ERRORS[] =
+	{
+		Error(),
+		Error(SOURCE, SIZE_MISMATCH, "(x op y) needs arrays of the same size"),
+		Error(SOURCE, DIVIDED_BY_ZERO, "(/ b, 0 in b) result is undefined")
+	};
+
+	reportError(INTERVAL_ARRAY_ERRORS[code]);
+}
+
+IntervalArray::IntervalArray(size_t size)
+	: lower_(size), upper_(size)
+{}
+
+IntervalArray::IntervalArray(const std::vector<Real>& values)
+{
+	lower_.reserve(values.size());
+	upper_.reserve(values.size());
+	for (const Real& value : values)
+		append(RealD(value));
+}
+
+void IntervalArray::resize(size_t size)
+{
+	lower_.resize(size);
+	upper_.resize(size);
+}
+
+void IntervalArray::append(const RealD& value)
+{
+	lower_.push_back(value.getLower());
+	upper_.push_back(value.getUpper());
+}
+
+bool IntervalArray::prepare(const IntervalArray& x, const IntervalArray& y, IntervalArray& res)
+{
+	if (x.size() != y.size())
+	{
+		report(SIZE_MISMATCH);
+		return false;
+	}
+	res.resize(x.size());
+	return true;
+}
+
+void IntervalArray::add(const IntervalArray& x, const IntervalArray& y, IntervalArray& res)
+{
+	if (prepare(x, y, res))
+		run(activeKernels()->add, addScalar, x.lower_.data(), x.upper_.data(), y.lower_.data(), y.upper_.data(),
+			res.lower_.data(), res.upper_.data(), res.size());
+}
+
+void IntervalArray::sub(const IntervalArray& x, const IntervalArray& y, IntervalArray& res)
+{
+	if (prepare(x, y, res))
+		run(activeKernels()->sub, subScalar, x.lower_.data(), x.upper_.data(), y.lower_.data(), y.upper_.data(),
+			res.lower_.data(), res.upper_.data(), res.size());
+}
+
+void IntervalArray::mul(const IntervalArray& x, const IntervalArray& y, IntervalArray& res)
+{
+	if (prepare(x, y, res))
+		run(activeKernels()->mul, mulScalar, x.lower_.data(), x.upper_.data(), y.lower_.data(), y.upper_.data(),
+			res.lower_.data(), res.upper_.data(), res.size());
+}
+
+void IntervalArray::div(const IntervalArray& x, const IntervalArray& y, IntervalArray& res)
+{
+	if (prepare(x, y, res) &&
+		run(activeKernels()->div, divScalar, x.lower_.data(), x.upper_.data(), y.lower_.data(), y.upper_.data(),
+			res.lower_.data(), res.upper_.data(), res.size()))
+		report(DIVIDED_BY_ZERO);
+}
+
+void IntervalArray::containsZero(std::vector<uint8_t>& res) const
+{
+	res.resize(size());
+	size_t done = activeKernels()->containsZero(lower_.data(), upper_.data(), res.data(), size());
+	containsZeroScalar(lower_.data() + done, upper_.data() + done, res.data() + done, size() - done);
+}
+
+bool IntervalArray::setKernel(INTERVAL_KERNEL kernel)
+{
+	const Kernels* kernels = findKernels(kernel);
+	if (kernels == nullptr)
+		return false;
+	activeKernels() = kernels;
+	return true;
+}
+
+INTERVAL_KERNEL IntervalArray::getKernel()
+{
+	return activeKernels()->kind;
+}
@@ -1,295 +1,361 @@
 #include "models/Rational.h"
 #include "models/Error.h"
+#include "models/Chars.h"
+#include <algorithm>
+#include <cmath>
 
-const std::string CLASS_PREFIX = "[Rational] ";
-const std::string SEPARATOR = " / ";
+constexpr char const* SEPARATOR = " / ";
+constexpr char const* NAN_TEXT = "NaN";
 
-class RationalError : public Error
+namespace
 {
-public:
-	enum Code
-	{
-		OK = 0,
-		ZERO_DENOMINATOR = 1,
-		DIVIDED_BY_ZERO = 2,
-		ADD_WITH_NAN = 3,
-		SUB_WITH_NAN = 4,
-		MULT_WITH_NAN = 5,
-		DIV_WITH_NAN = 6,
-		CMP_WITH_NAN = 7
-	};
-	RationalError(const Code code);
-
-private:
-	std::string getMessage(const Code code);
-};
+	constexpr char const* SOURCE = "Rational";
 
-RationalError::RationalError(const Code code)
-	: Error(code, getMessage(code))
-{}
+	// Doubles up to 2^53 are exact, so their quotient is rounded once
+	const uint64_t EXACT_DOUBLE = (uint64_t)1 << 53;
 
-std::string RationalError::getMessage(const Code code)
-{
-	switch (code)
+	Integer powerOfTwo(int exponent)
 	{
-	case OK:
-		return "";
-		break;
-	case ZERO_DENOMINATOR:
-		return CLASS_PREFIX + "Rational (p /= 0, q = 0) is undefined";
-		break;
-	case DIVIDED_BY_ZERO:
-		return CLASS_PREFIX + "(/ 0) is undefined";
-		break;
-	case ADD_WITH_NAN:
-		return CLASS_PREFIX + "(+ NaN) is undefined";
-		break;
-	case SUB_WITH_NAN:
-		return CLASS_PREFIX + "(- NaN) is undefined";
-		break;
-	case MULT_WITH_NAN:
-		return CLASS_PREFIX + "(* NaN) is undefined";
-		break;
-	case DIV_WITH_NAN:
-		return CLASS_PREFIX + "(/ NaN) is undefined";
-		break;
-	case CMP_WITH_NAN:
-		return CLASS_PREFIX + "(>=< NaN) is undefined";
-		break;
+		if (exponent < 63)
+			return Integer((int64_t)1 << exponent);
+		return Integer(BigInteger::powerOfTwo(exponent));
 	}
-}
 
-void Rational::transform()
-{
-	if (p_ == 0)
+	int bitLength(uint64_t value)
 	{
-		q_ = 1;
-		return;
+		int bits = 0;
+		for (; value != 0; value >>= 1)
+			bits++;
+		return bits;
 	}
 
-	if (q_ < 0)
+	// (m + sticky) * 2^-shift rounded to the nearest double, ties to even, for m of 62 or
+	// 63 bits and sticky true if anything was cut off below m
+	double roundScaled(uint64_t m, bool sticky, int shift)
 	{
-		p_ = -p_;
-		q_ = -q_;
+		// Bits below 2^-1074 go as well once the result is subnormal
+		int drop = std::max(bitLength(m) - 53, shift - 1074);
+		if (drop > 63)
+			return 0.0;
+
+		uint64_t kept = m >> drop;
+		uint64_t rest = m & (((uint64_t)1 << drop) - 1);
+		uint64_t half = (uint64_t)1 << (drop - 1);
+		if (rest > half || (rest == half && (sticky || (kept & 1) != 0)))
+			kept++;
+		return std::ldexp((double)kept, drop - shift);
 	}
 
-	Integer gcd = GCD(p_, q_);
-	gcd = gcd < 0 ? -gcd : gcd; // If GCD is negative
-	p_ /= gcd;
-	q_ /= gcd;
-}
-
-Rational::Rational(Integer p, Integer q)
-	: p_(p), q_(q)
-{
-	if (q == 0)
-		if (p != 0)
+	// Convergents of p / q > 0 in lowest terms, whose denominator is above bound: h / k is
+	// the last one with k <= bound and hs / ks the best semiconvergent after it. By the
+	// half rule the result is 1 if the semiconvergent is closer, -1 if the convergent is,
+	// 0 if only an exact comparison can tell.
+	template<typename T>
+	int lastConvergents(T p, T q, const T& bound, T& h, T& k, T& hs, T& ks)
+	{
+		T h0(0), k0(1);
+		h = T(1);
+		k = T(0);
+		for (;;)
 		{
-			std::cerr << RationalError(RationalError::ZERO_DENOMINATOR) << "\n";
-			p_ = 0;
-			return;
+			T a = p / q;
+			T k2 = k0 + a * k;
+			if (k2 > bound)
+			{
+				T t = (bound - k0) / k;
+				hs = h0 + t * h;
+				ks = k0 + t * k;
+				T twice = t + t;
+				return twice > a ? 1 : (twice < a ? -1 : 0);
+			}
+
+			T h2 = h0 + a * h;
+			T r = p - a * q;
+			h0 = std::move(h);
+			k0 = std::move(k);
+			h = std::move(h2);
+			k = std::move(k2);
+			p = std::move(q);
+			q = std::move(r);
 		}
-		else
-			return;
-	
-	transform();
-}
-
-Rational::Rational(int p, int q)
-	: Rational(Integer(p), Integer(q))
-{}
-
-Rational::Rational(Integer a)
-	: Rational(a, Integer(1))
-{}
+	}
 
-Rational::Rational(int a)
-	: Rational(a, 1)
-{}
+	// On a tie of distances the convergent has the smaller denominator
+	Rational closer(const Rational& value, const Rational& convergent, const Rational& semiconvergent, int rule)
+	{
+		if (rule == 0)
+		{
+			Rational toConvergent = value - convergent, toSemiconvergent = value - semiconvergent;
+			if (toConvergent.sign() < 0)
+				toConvergent = -toConvergent;
+			if (toSemiconvergent.sign() < 0)
+				toSemiconvergent = -toSemiconvergent;
+			rule = toSemiconvergent < toConvergent ? 1 : -1;
+		}
+		return rule > 0 ? semiconvergent : convergent;
+	}
 
-Rational::Rational(const Rational& other)
-	: p_(other.p_), q_(other.q_)
-{}
+#ifdef __SIZEOF_INT128__
+	// Bounds up to here keep every convergent of a double in 128 bits
+	const int64_t WORD_BOUND = (int64_t)1 << 62;
 
-Rational& Rational::operator=(const Rational& other)
-{
-	p_ = other.p_;
-	q_ = other.q_;
-	return *this;
-}
+	Integer toInteger(unsigned __int128 value)
+	{
+		if (value < ((unsigned __int128)1 << 63))
+			return Integer((int64_t)value);
+		Integer res((int64_t)(value >> 62));
+		res *= Integer((int64_t)1 << 62);
+		res += Integer((int64_t)(value & (((unsigned __int128)1 << 62) - 1)));
+		return res;
+	}
 
-Rational& Rational::operator+=(const Rational& other)
-{
-	if (isNaN() || other.isNaN())
+	// Rational::fromDouble(value).approximate(bound) for 1 <= bound <= WORD_BOUND, in 128-bit
+	// words where the denominator of value fits
+	Rational approximateDouble(double value, int64_t bound)
 	{
-		std::cerr << RationalError(RationalError::ADD_WITH_NAN) << "\n";
-		return *this;
+		if (!std::isfinite(value) || value == 0)
+			return Rational::fromDouble(value);
+
+		int exponent = 0;
+		int64_t m = (int64_t)std::ldexp(std::frexp(value, &exponent), 53);
+		exponent -= 53;
+		if (exponent >= 0)
+			return Rational::fromDouble(value);
+
+		int shift = std::min(overflow::trailingZeros((uint64_t)m), -exponent);
+		int twos = -exponent - shift;
+		if (twos == 0 || twos > 126)
+			return Rational::fromDouble(value).approximate(Integer(bound));
+
+		unsigned __int128 p = (unsigned __int128)(m < 0 ? -m : m) >> shift;
+		unsigned __int128 q = (unsigned __int128)1 << twos;
+		if (q <= (unsigned __int128)bound)
+			return Rational::fromDouble(value);
+
+		unsigned __int128 h, k, hs, ks;
+		int rule = lastConvergents(p, q, (unsigned __int128)bound, h, k, hs, ks);
+		Rational res = rule > 0 ? Rational(toInteger(hs), toInteger(ks)) : Rational(toInteger(h), toInteger(k));
+		if (rule == 0)
+			res = closer(Rational(toInteger(p), toInteger(q)), res, Rational(toInteger(hs), toInteger(ks)), rule);
+		return m < 0 ? -res : res;
 	}
+#endif
 
-	p_ = p_ * other.q_ + q_ * other.p_;
-	q_ *= other.q_;
-	transform();
+	// Nearest double to p / q for p, q > 0
+	double magnitudeToDouble(const Integer& p, const Integer& q)
+	{
+		if (!p.isBig() && !q.isBig())
+		{
+			uint64_t pm = (uint64_t)(int64_t)p, qm = (uint64_t)(int64_t)q;
+			if (pm <= EXACT_DOUBLE && qm <= EXACT_DOUBLE)
+				return (double)pm / (double)qm;
+			if (qm == 1)
+				return (double)pm;
+#ifdef __SIZEOF_INT128__
+			// The quotient keeps 62 or 63 bits
+			int shift = 62 - (bitLength(pm) - bitLength(qm));
+			unsigned __int128 num = (unsigned __int128)pm << shift;
+			return roundScaled((uint64_t)(num / qm), num % qm != 0, shift);
+#endif
+		}
 
-	return *this;
+		// Dyadic, as from fromDouble: one rounding by the scaling
+		size_t twos = q.trailingZeros();
+		if (!p.isBig() && (uint64_t)(int64_t)p <= EXACT_DOUBLE && q.bitLength() == twos + 1)
+			return std::ldexp((double)(int64_t)p, -(int)std::min(twos, (size_t)2000));
+
+		int shift = 62 - ((int)p.bitLength() - (int)q.bitLength());
+		Integer num = shift > 0 ? p * powerOfTwo(shift) : p;
+		Integer den = shift < 0 ? q * powerOfTwo(-shift) : q;
+		return roundScaled((uint64_t)(int64_t)(num / den), num % den != 0, shift);
+	}
 }
 
-Rational& Rational::operator-=(const Rational& other)
+void Rational::report(RationalError code)
 {
-	if (isNaN() || other.isNaN())
+	// Indexed by RationalError
+	static constexpr Error RATIONAL_ERRORS[] =
 	{
-		std::cerr << RationalError(RationalError::SUB_WITH_NAN) << "\n";
-		return *this;
-	}
-
-	p_ = p_ * other.q_ - q_ * other.p_;
-	q_ *= other.q_;
-	transform();
+		Error(),
+		Error(SOURCE, ZERO_DENOMINATOR, "Rational (p /= 0, q = 0) is undefined"),
+		Error(SOURCE, DIVIDED_BY_ZERO, "(/ 0) is undefined"),
+		Error(SOURCE, ADD_WITH_NAN, "(+ NaN) is undefined"),
+		Error(SOURCE, SUB_WITH_NAN, "(- NaN) is undefined"),
+		Error(SOURCE, MULT_WITH_NAN, "(* NaN) is undefined"),
+		Error(SOURCE, DIV_WITH_NAN, "(/ NaN) is undefined"),
+		Error(SOURCE, CMP_WITH_NAN, "(>=< NaN) is undefined"),
+		Error(SOURCE, NOT_FINITE, "Rational (infinity or NaN double) is undefined"),
+		Error(SOURCE, WRONG_BOUND, "(approximate, max denominator < 1) is undefined")
+	};
 
-	return *this;
+	reportError(RATIONAL_ERRORS[code]);
 }
 
-Rational& Rational::operator*=(const Rational& other)
+size_t Rational::hash() const
 {
-	if (isNaN() || other.isNaN())
+	if (!reduced_)
 	{
-		std::cerr << RationalError(RationalError::MULT_WITH_NAN) << "\n";
-		return *this;
+		Rational reduced(*this);
+		reduced.reduce();
+		return reduced.hash();
 	}
-
-	p_ = p_ * other.p_;
-	q_ = q_ * other.q_;
-	transform();
-
-	return *this;
+	return hashing::combine(p_.hash(), q_.hash());
 }
 
-Rational& Rational::operator/=(const Rational& other)
+Rational Rational::fromDouble(double value)
 {
-	if (isNaN() || other.isNaN())
-	{
-		std::cerr << RationalError(RationalError::DIV_WITH_NAN) << "\n";
-		return *this;
-	}
+	if (!std::isfinite(value) && failed(NOT_FINITE))
+		return RATIONAL_NaN;
+
+	if (std::fabs(value) < 0x1p63 && value == (double)(int64_t)value)
+		return Rational(Integer((int64_t)value));
+
+	// A finite double is m * 2^e with a 53-bit m, reduced here by shifting out the twos
+	int exponent = 0;
+	int64_t m = (int64_t)std::ldexp(std::frexp(value, &exponent), 53);
+	exponent -= 53;
+	if (exponent >= 0)
+		return Rational(Integer(m) * powerOfTwo(exponent));
+
+	int shift = std::min(overflow::trailingZeros((uint64_t)m), -exponent);
+	Rational res(Integer(m >> shift));
+	res.q_ = powerOfTwo(-exponent - shift);
+	return res;
+}
 
-	if (other.p_ == 0)
-	{
-		std::cerr << RationalError(RationalError::DIVIDED_BY_ZERO) << "\n";
+Rational Rational::approximate(const Integer& maxDenominator) const
+{
+	if (isNaN())
 		return *this;
-	}
-
-	Integer temp = p_ * other.q_;
-	q_ = q_ * other.p_;
-	p_ = temp;
-	transform();
+	if (maxDenominator < 1 && failed(WRONG_BOUND))
+		return RATIONAL_NaN;
+	if (sign() < 0)
+		return -(-*this).approximate(maxDenominator);
+
+	Rational value(*this);
+	value.reduce();
+	if (value.q_ <= maxDenominator)
+		return value;
+
+	Integer h, k, hs, ks;
+	int rule = lastConvergents(value.p_, value.q_, maxDenominator, h, k, hs, ks);
+	return closer(value, Rational(h, k), Rational(hs, ks), rule);
+}
 
-	return *this;
+double Rational::toDouble() const
+{
+	if (isNaN())
+		return NAN;
+	if (p_ < 0)
+		return -magnitudeToDouble(-p_, q_);
+	if (p_ == 0)
+		return 0.0;
+	return magnitudeToDouble(p_, q_);
 }
 
-Rational Rational::operator-()
+void Rational::fromDoubles(const double* values, size_t count, std::vector<Rational>& res)
 {
-	return Rational(-p_, q_);
+	res.clear();
+	res.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		res.push_back(fromDouble(values[i]));
 }
 
-bool Rational::operator==(const Rational& other) const
+void Rational::approximate(const double* values, size_t count, const Integer& maxDenominator, std::vector<Rational>& res)
 {
-	if (isNaN() || other.isNaN())
+	res.clear();
+	if (maxDenominator < 1 && failed(WRONG_BOUND))
 	{
-		std::cerr << RationalError(RationalError::CMP_WITH_NAN) << "\n";
-		return false;
+		res.assign(count, RATIONAL_NaN);
+		return;
 	}
 
-	return (p_ == other.p_) && (q_ == other.q_);
-}
-
-bool Rational::operator!=(const Rational& other) const
-{
-	if (isNaN() || other.isNaN())
+	res.reserve(count);
+#ifdef __SIZEOF_INT128__
+	if (!maxDenominator.isBig() && (int64_t)maxDenominator <= WORD_BOUND)
 	{
-		std::cerr << RationalError(RationalError::CMP_WITH_NAN) << "\n";
-		return false;
+		for (size_t i = 0; i < count; i++)
+			res.push_back(approximateDouble(values[i], (int64_t)maxDenominator));
+		return;
 	}
+#endif
+	for (size_t i = 0; i < count; i++)
+		res.push_back(fromDouble(values[i]).approximate(maxDenominator));
+}
 
-	return (p_ != other.p_) || (q_ != other.q_);
+void Rational::toDoubles(const Rational* values, size_t count, double* res)
+{
+	for (size_t i = 0; i < count; i++)
+		res[i] = values[i].toDouble();
 }
 
-bool Rational::operator>(const Rational& other) const
+std::to_chars_result Rational::toChars(char* first, char* last) const
 {
-	if (isNaN() || other.isNaN())
+	if (isNaN())
+		return chars::put(first, last, NAN_TEXT) ? std::to_chars_result{ first, std::errc() } : std::to_chars_result{ last, std::errc::value_too_large };
+	if (!reduced_)
 	{
-		std::cerr << RationalError(RationalError::CMP_WITH_NAN) << "\n";
-		return false;
+		Rational reduced(*this);
+		reduced.reduce();
+		return reduced.toChars(first, last);
 	}
 
-	return (p_ * other.q_ > q_ * other.p_);
+	std::to_chars_result res = p_.toChars(first, last);
+	if (res.ec != std::errc())
+		return res;
+	first = res.ptr;
+	if (!chars::put(first, last, SEPARATOR))
+		return { last, std::errc::value_too_large };
+	return q_.toChars(first, last);
 }
 
-bool Rational::operator>=(const Rational& other) const
+std::from_chars_result Rational::fromChars(const char* first, const char* last, Rational& res)
 {
-	if (isNaN() || other.isNaN())
+	const char* pos = first;
+	if (chars::take(pos, last, NAN_TEXT))
 	{
-		std::cerr << RationalError(RationalError::CMP_WITH_NAN) << "\n";
-		return false;
+		res = RATIONAL_NaN;
+		return { pos, std::errc() };
 	}
 
-	return (p_ * other.q_ >= q_ * other.p_);
-}
+	Integer p, q(1);
+	std::from_chars_result parsed = Integer::fromChars(first, last, p);
+	if (parsed.ec != std::errc())
+		return parsed;
 
-bool Rational::operator<(const Rational& other) const
-{
-	if (isNaN() || other.isNaN())
+	pos = chars::skipSpaces(parsed.ptr, last);
+	if (pos != last && *pos == '/')
 	{
-		std::cerr << RationalError(RationalError::CMP_WITH_NAN) << "\n";
-		return false;
+		parsed = Integer::fromChars(chars::skipSpaces(pos + 1, last), last, q);
+		if (parsed.ec != std::errc() || q == 0)
+			return { first, std::errc::invalid_argument };
 	}
 
-	return (p_ * other.q_ < q_ * other.p_);
+	res = Rational(std::move(p), std::move(q));
+	return { parsed.ptr, std::errc() };
 }
 
-bool Rational::operator<=(const Rational& other) const
+std::to_chars_result Rational::toChars(char* first, char* last, std::span<const Rational> values, char separator)
 {
-	if (isNaN() || other.isNaN())
-	{
-		std::cerr << RationalError(RationalError::CMP_WITH_NAN) << "\n";
-		return false;
-	}
-
-	return (p_ * other.q_ <= q_ * other.p_);
+	return chars::formatAll(first, last, values, separator);
 }
 
-bool Rational::isNaN() const
+std::from_chars_result Rational::fromChars(const char* first, const char* last, std::span<Rational> values, size_t& count)
 {
-	return (p_ == 0) && (q_ == 0);
+	return chars::parseAll(first, last, values, count);
 }
 
 std::ostream& operator<<(std::ostream& stream, const Rational& rational)
 {
 	if (rational.isNaN())
 		stream << "NaN";
+	else if (!rational.reduced_)
+	{
+		Rational reduced(rational);
+		reduced.reduce();
+		stream << reduced;
+	}
 	else
 		stream << rational.p_ << SEPARATOR << rational.q_;
 	return stream;
 }
-
-Rational operator+(Rational a, const Rational& b)
-{
-	a += b;
-	return a;
-}
-
-Rational operator-(Rational a, const Rational& b)
-{
-	a -= b;
-	return a;
-}
-
-Rational operator*(Rational a, const Rational& b)
-{
-	a *= b;
-	return a;
-}
-
-Rational operator/(Rational a, const Rational & b)
-{
-	a /= b;
-	return a;
-}
@@ -0,0 +1,120 @@
+#include "models/RationalAccumulator.h"
+#include "models/Error.h"
+
+namespace
+{
+	constexpr char const* SOURCE = "RationalAccumulator";
+
+	enum RationalAccumulatorError
+	{
+		OK = 0,
+		ADD_WITH_NAN = 1
+	};
+
+	// Indexed by RationalAccumulatorError
+	constexpr Error RATIONAL_ACCUMULATOR_ERRORS[] =
+	{
+		Error(),
+		Error(SOURCE, ADD_WITH_NAN, "(+ NaN) is undefined")
+	};
+}
+
+RationalAccumulator::RationalAccumulator()
+	: numerator_(0), denominator_(1), scales_(SCALE_TABLE), nan_(false)
+{}
+
+// denominator_ / q, the denominator first grows to lcm(denominator_, q) if q doesn't divide it
+Integer RationalAccumulator::scaleFor(const Integer& q)
+{
+	Integer scale = denominator_ / q;
+	if (scale * q != denominator_)
+	{
+		Integer grow = q / GCD(denominator_, q);
+		numerator_ *= grow;
+		denominator_ *= grow;
+		for (Integer& known : scales_)
+			known = 0;
+		scale = denominator_ / q;
+	}
+	return scale;
+}
+
+// numerator_ / denominator_ += p / q for q > 0
+void RationalAccumulator::addFraction(const Integer& p, const Integer& q)
+{
+	if (q < (int)SCALE_TABLE)
+	{
+		Integer& scale = scales_[(size_t)(int)q];
+		if (scale == 0)
+			scale = scaleFor(q);
+		numerator_ += p * scale;
+	}
+	else
+		numerator_ += p * scaleFor(q);
+}
+
+void RationalAccumulator::add(const Rational& value)
+{
+	if (nan_)
+		return;
+	if (value.getDenominator() == 0)
+	{
+		reportError(RATIONAL_ACCUMULATOR_ERRORS[RationalAccumulatorError::ADD_WITH_NAN]);
+		nan_ = true;
+		return;
+	}
+
+	addFraction(value.getNumerator(), value.getDenominator());
+}
+
+void RationalAccumulator::sub(const Rational& value)
+{
+	if (nan_)
+		return;
+	if (value.getDenominator() == 0)
+	{
+		reportError(RATIONAL_ACCUMULATOR_ERRORS[RationalAccumulatorError::ADD_WITH_NAN]);
+		nan_ = true;
+		return;
+	}
+
+	Integer p = value.getNumerator();
+	addFraction(-p, value.getDenominator());
+}
+
+void RationalAccumulator::addProduct(const Rational& a, const Rational& b)
+{
+	if (nan_)
+		return;
+	if (a.getDenominator() == 0 || b.getDenominator() == 0)
+	{
+		reportError(RATIONAL_ACCUMULATOR_ERRORS[RationalAccumulatorError::ADD_WITH_NAN]);
+		nan_ = true;
+		return;
+	}
+
+	addFraction(a.getNumerator() * b.getNumerator(), a.getDenominator() * b.getDenominator());
+}
+
+void RationalAccumulator::addDot(const Rational* a, const Rational* b, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		addProduct(a[i], b[i]);
+}
+
+Rational RationalAccumulator::getSum() const
+{
+	if (nan_)
+		return RATIONAL_NaN;
+	return Rational(numerator_, denominator_);
+}
+
+bool RationalAccumulator::isNaN() const
+{
+	return nan_;
+}
+
+void RationalAccumulator::reset()
+{
+	*this = RationalAccumulator();
+}
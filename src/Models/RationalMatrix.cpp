@@ -0,0 +1,191 @@
+#include "models/RationalMatrix.h"
+#include "models/Error.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr char const* SOURCE = "RationalMatrix";
+
+	// Bareiss elimination of the rows x cols integers in a, pivots taken from the first
+	// pivotCols columns. Entries below the pivots become 0, each other entry of a row below
+	// is replaced by (pivot * entry - lead * top entry) / previous pivot, which divides exactly.
+	// Returns the rank; sign flips with every row swap.
+	size_t eliminate(std::vector<Integer>& a, size_t rows, size_t cols, size_t pivotCols, int& sign)
+	{
+		Integer previous(1);
+		size_t rank = 0;
+		for (size_t c = 0; c < pivotCols && rank < rows; c++)
+		{
+			size_t pivot = rank;
+			while (pivot < rows && a[pivot * cols + c] == 0)
+				pivot++;
+			if (pivot == rows)
+				continue;
+			if (pivot != rank)
+			{
+				std::swap_ranges(a.begin() + pivot * cols, a.begin() + (pivot + 1) * cols, a.begin() + rank * cols);
+				sign = -sign;
+			}
+
+			const Integer* top = &a[rank * cols];
+			for (size_t i = rank + 1; i < rows; i++)
+			{
+				Integer* row = &a[i * cols];
+				for (size_t j = c + 1; j < cols; j++)
+				{
+					Integer value = top[c] * row[j];
+					if (row[c] != 0)
+						value -= row[c] * top[j];
+					if (previous != 1)
+						value /= previous;
+					row[j] = std::move(value);
+				}
+				row[c] = 0;
+			}
+			previous = top[c];
+			rank++;
+		}
+		return rank;
+	}
+}
+
+void RationalMatrix::report(RationalMatrixError code)
+{
+	// Indexed by RationalMatrixError
+	static constexpr Error RATIONAL_MATRIX_ERRORS[] =
+	{
+		Error(),
+		Error(SOURCE, WRONG_SIZE, "(matrix size) doesn't fit the operation"),
+		Error(SOURCE, NAN_ENTRY, "(matrix with NaN) result is undefined"),
+		Error(SOURCE, SINGULAR, "(solve, det = 0) result is undefined")
+	};
+
+	reportError(RATIONAL_MATRIX_ERRORS[code]);
+}
+
+RationalMatrix::RationalMatrix(size_t rows, size_t cols)
+	: rows_(rows), cols_(cols), entries_(rows * cols, Rational(0))
+{}
+
+RationalMatrix::RationalMatrix(size_t rows, size_t cols, std::vector<Rational> entries)
+	: rows_(rows), cols_(cols), entries_(std::move(entries))
+{
+	if (entries_.size() != rows * cols)
+	{
+		report(WRONG_SIZE);
+		entries_.resize(rows * cols, Rational(0));
+	}
+}
+
+bool RationalMatrix::toIntegers(const std::vector<Rational>* b, std::vector<Integer>& res, Integer& scale) const
+{
+	size_t width = cols_ + (b != nullptr ? 1 : 0);
+	res.clear();
+	res.reserve(rows_ * width);
+	scale = 1;
+	for (size_t i = 0; i < rows_; i++)
+	{
+		const Rational* row = &entries_[i * cols_];
+		Integer lcm(1);
+		for (size_t j = 0; j < width; j++)
+		{
+			const Integer& q = (j < cols_ ? row[j] : (*b)[i]).getDenominator();
+			if (q == 0)
+				return false;
+			if (q != 1)
+				lcm *= q / GCD(lcm, q);
+		}
+		for (size_t j = 0; j < width; j++)
+		{
+			const Rational& value = j < cols_ ? row[j] : (*b)[i];
+			res.push_back(value.getDenominator() == lcm ? value.getNumerator() : value.getNumerator() * (lcm / value.getDenominator()));
+		}
+		if (lcm != 1)
+			scale *= lcm;
+	}
+	return true;
+}
+
+Rational RationalMatrix::determinant() const
+{
+	if (rows_ != cols_)
+	{
+		report(WRONG_SIZE);
+		return RATIONAL_NaN;
+	}
+
+	std::vector<Integer> a;
+	Integer scale;
+	if (!toIntegers(nullptr, a, scale))
+	{
+		report(NAN_ENTRY);
+		return RATIONAL_NaN;
+	}
+	if (rows_ == 0)
+		return Rational(1);
+
+	int sign = 1;
+	if (eliminate(a, rows_, cols_, cols_, sign) < rows_)
+		return Rational(0);
+	Integer& last = a.back();
+	return Rational(sign < 0 ? -last : last, scale);
+}
+
+size_t RationalMatrix::rank() const
+{
+	std::vector<Integer> a;
+	Integer scale;
+	if (!toIntegers(nullptr, a, scale))
+	{
+		report(NAN_ENTRY);
+		return 0;
+	}
+
+	int sign = 1;
+	return eliminate(a, rows_, cols_, cols_, sign);
+}
+
+bool RationalMatrix::solve(const std::vector<Rational>& b, std::vector<Rational>& x) const
+{
+	if (rows_ != cols_ || b.size() != rows_)
+	{
+		report(WRONG_SIZE);
+		return false;
+	}
+
+	std::vector<Integer> a;
+	Integer scale;
+	if (!toIntegers(&b, a, scale))
+	{
+		report(NAN_ENTRY);
+		return false;
+	}
+
+	size_t n = rows_, width = n + 1;
+	int sign = 1;
+	if (eliminate(a, n, width, n, sign) < n)
+	{
+		report(SINGULAR);
+		return false;
+	}
+
+	// Upper triangular U y = c with d = U[n - 1][n - 1]: by Cramer's rule d * y is integral,
+	// so back substitution on it divides exactly and each component is reduced once
+	const Integer& d = a[(n - 1) * width + n - 1];
+	std::vector<Integer> scaled(n);
+	for (size_t i = n; i-- > 0;)
+	{
+		const Integer* row = &a[i * width];
+		Integer value = d * row[n];
+		for (size_t j = i + 1; j < n; j++)
+			value -= row[j] * scaled[j];
+		value /= row[i];
+		scaled[i] = std::move(value);
+	}
+
+	x.clear();
+	x.reserve(n);
+	for (size_t i = 0; i < n; i++)
+		x.push_back(Rational(std::move(scaled[i]), d));
+	return true;
+}
@@ -1,212 +1,93 @@
 #include "models/Real.h"
 #include "models/Error.h"
-#include <algorithm>
+#include "models/Chars.h"
 
-const std::string CLASS_PREFIX = "[Real] ";
-const std::string COMMA = ", ";
+constexpr char const* COMMA = ", ";
+constexpr char const* NAN_TEXT = "NaN";
 
-class RealError : public Error
+namespace
 {
-public:
-	enum Code
-	{
-		OK = 0,
-		EMPTY_INTERVAL = 1,
-		ADD_WITH_NAN = 2,
-		SUB_WITH_NAN = 3,
-		MULT_WITH_NAN = 4,
-		DIV_WITH_NAN = 5,
-		ZERO_IN_NAN = 6,
-		DIVIDED_BY_ZERO = 7
-	};
-	RealError(const Code code);
-
-private:
-	std::string getMessage(const Code code);
-};
-
-RealError::RealError(const Code code)
-	: Error(code, getMessage(code))
-{}
-
-std::string RealError::getMessage(const Code code)
-{
-	switch (code)
-	{
-	case OK:
-		return "";
-		break;
-	case EMPTY_INTERVAL:
-		return CLASS_PREFIX + "[a, b] is empty if a > b, SWAP";
-		break;
-	case ADD_WITH_NAN:
-		return CLASS_PREFIX + "(+ NaN) is undefined";
-		break;
-	case SUB_WITH_NAN:
-		return CLASS_PREFIX + "(- NaN) is undefined";
-		break;
-	case MULT_WITH_NAN:
-		return CLASS_PREFIX + "(* NaN) is undefined";
-		break;
-	case DIV_WITH_NAN:
-		return CLASS_PREFIX + "(/ NaN) is undefined";
-		break;
-	case ZERO_IN_NAN:
-		return CLASS_PREFIX + "(0 in NaN) is undefined";
-		break;
-	case DIVIDED_BY_ZERO:
-		return CLASS_PREFIX + "(/ b, 0 in b) result is undefined";
-		break;
-	}
+	constexpr char const* SOURCE = "Real";
 }
 
-
-Real::Real(Rational a, Rational b)
-	: a_(a), b_(b)
+void Real::report(RealError code)
 {
-	if (a.isNaN() || b.isNaN())
-	{
-		*this = REAL_NaN;
-		return;
-	}
-
-	if (a > b)
+	// Indexed by RealError
+	static constexpr Error REAL_ERRORS[] =
 	{
-		std::cerr << RealError(RealError::EMPTY_INTERVAL) << "\n";
-		std::swap(a_, b_);
-	}
-}
-
-Real::Real(const Real& other)
-	: a_(other.a_), b_(other.b_)
-{}
-
-Real& Real::operator=(const Real& other)
-{
-	a_ = other.a_;
-	b_ = other.b_;
-	return *this;
-}
-
-Real& Real::operator+=(const Real& other)
-{
-	if (isNaN() || other.isNaN())
-	{
-		std::cerr << RealError(RealError::ADD_WITH_NAN) << "\n";
-		return *this;
-	}
-
-	a_ = a_ + other.a_;
-	b_ = b_ + other.b_;
-
-	return *this;
-}
-
-Real& Real::operator-=(const Real& other)
-{
-	if (isNaN() || other.isNaN())
-	{
-		std::cerr << RealError(RealError::SUB_WITH_NAN) << "\n";
-		return *this;
-	}
-
-	a_ = a_ - other.b_;
-	b_ = b_ - other.a_;
+		Error(),
+		Error(SOURCE, EMPTY_INTERVAL, "[a, b] is empty if a > b, SWAP"),
+		Error(SOURCE, ADD_WITH_NAN, "(+ NaN) is undefined"),
+		Error(SOURCE, SUB_WITH_NAN, "(- NaN) is undefined"),
+		Error(SOURCE, MULT_WITH_NAN, "(* NaN) is undefined"),
+		Error(SOURCE, DIV_WITH_NAN, "(/ NaN) is undefined"),
+		Error(SOURCE, ZERO_IN_NAN, "(0 in NaN) is undefined"),
+		Error(SOURCE, DIVIDED_BY_ZERO, "(/ b, 0 in b) result is undefined")
+	};
 
-	return *this;
+	reportError(REAL_ERRORS[code]);
 }
 
-Real& Real::operator*=(const Real& other)
+size_t Real::hash() const
 {
-	if (isNaN() || other.isNaN())
-	{
-		std::cerr << RealError(RealError::MULT_WITH_NAN) << "\n";
-		return *this;
-	}
-
-	Rational a = 
-			std::min(a_ * other.a_,
-			std::min(a_ * other.b_,
-			std::min(b_ * other.a_, b_ * other.b_)));
-	Rational b =
-			std::max(a_ * other.a_,
-			std::max(a_ * other.b_,
-			std::max(b_ * other.a_, b_ * other.b_)));
-
-	a_ = a;
-	b_ = b;
-
-	return *this;
+	return hashing::combine(a_.hash(), b_.hash());
 }
 
-Real& Real::operator/=(const Real& other)
+std::to_chars_result Real::toChars(char* first, char* last) const
 {
-	if (isNaN() || other.isNaN())
-	{
-		std::cerr << RealError(RealError::DIV_WITH_NAN) << "\n";
-		return *this;
-	}
-	if (containsZero())
+	if (isNaN())
+		return chars::put(first, last, NAN_TEXT) ? std::to_chars_result{ first, std::errc() } : std::to_chars_result{ last, std::errc::value_too_large };
+
+	if (!chars::put(first, last, "["))
+		return { last, std::errc::value_too_large };
+	std::to_chars_result res = a_.toChars(first, last);
+	if (res.ec != std::errc())
+		return res;
+	first = res.ptr;
+	if (!chars::put(first, last, COMMA))
+		return { last, std::errc::value_too_large };
+	res = b_.toChars(first, last);
+	if (res.ec != std::errc())
+		return res;
+	first = res.ptr;
+	if (!chars::put(first, last, "]"))
+		return { last, std::errc::value_too_large };
+	return { first, std::errc() };
+}
+
+std::from_chars_result Real::fromChars(const char* first, const char* last, Real& res)
+{
+	const char* pos = first;
+	if (chars::take(pos, last, NAN_TEXT))
 	{
-		std::cerr << RealError(RealError::DIVIDED_BY_ZERO) << "\n";
-		return *this;
+		res = REAL_NaN;
+		return { pos, std::errc() };
 	}
-	*this *= Real(Rational(1) / other.b_, Rational(1) / other.a_);
-	return *this;
-}
-
-Real Real::operator-()
-{
-	return Real(-b_, -a_);
-}
-
-bool Real::operator==(const Real& other) const
-{
-	return (a_ == other.a_) && (b_ == other.b_);
-}
-
-bool Real::operator!=(const Real & other) const
-{
-	return (a_ != other.a_) || (b_ != other.b_);
-}
 
-bool Real::operator>(const Real& other) const
-{
-	return a_ > other.b_;
-}
-
-bool Real::operator>=(const Real& other) const
-{
-	return (*this > other) || (*this == other);
-}
+	Rational a(0), b(0);
+	if (!chars::take(pos, last, "["))
+		return { first, std::errc::invalid_argument };
+	std::from_chars_result parsed = Rational::fromChars(chars::skipSpaces(pos, last), last, a);
+	pos = chars::skipSpaces(parsed.ptr, last);
+	if (parsed.ec != std::errc() || !chars::take(pos, last, ","))
+		return { first, std::errc::invalid_argument };
+	parsed = Rational::fromChars(chars::skipSpaces(pos, last), last, b);
+	pos = chars::skipSpaces(parsed.ptr, last);
+	if (parsed.ec != std::errc() || !chars::take(pos, last, "]") || a.compareTotal(b) > 0)
+		return { first, std::errc::invalid_argument };
 
-bool Real::operator<(const Real & other) const
-{
-	return b_ < other.a_;
+	res = Real(std::move(a), std::move(b));
+	return { pos, std::errc() };
 }
 
-bool Real::operator<=(const Real& other) const
+std::to_chars_result Real::toChars(char* first, char* last, std::span<const Real> values, char separator)
 {
-	return (*this < other) || (*this == other);
+	return chars::formatAll(first, last, values, separator);
 }
 
-bool Real::isNaN() const
+std::from_chars_result Real::fromChars(const char* first, const char* last, std::span<Real> values, size_t& count)
 {
-	return (a_.isNaN()) && (b_.isNaN());
-}
-
-bool Real::containsZero() const
-{
-	if (isNaN())
-	{
-		std::cerr << RealError(RealError::ZERO_IN_NAN) << "\n";
-		return false;
-	}
-
-	if (a_ * b_ <= Rational(0))
-		return true;
-	else
-		return false;
+	return chars::parseAll(first, last, values, count);
 }
 
 std::ostream & operator<<(std::ostream& stream, const Real& real)
@@ -217,32 +98,3 @@ std::ostream & operator<<(std::ostream& stream, const Real& real)
 		stream << "[" << real.a_ << COMMA << real.b_ << "]";
 	return stream;
 }
-
-Real operator+(Real a, const Real& b)
-{
-	a += b;
-	return a;
-}
-
-Real operator-(Real a, const Real& b)
-{
-	a -= b;
-	return a;
-}
-
-Real operator*(Real a, const Real& b)
-{
-	a *= b;
-	return a;
-}
-
-Real operator/(Real a, const Real & b)
-{
-	a /= b;
-	return a;
-}
-
-Real operator*(Rational m, const Real& a)
-{
-	return Real(m, m) * a;
-}
@@ -0,0 +1,116 @@
+#include "models/RealD.h"
+#include "models/Error.h"
+#include <cfloat>
+
+constexpr char const* COMMA = ", ";
+
+namespace
+{
+	constexpr char const* SOURCE = "RealD";
+
+	Integer powerOfTwo(int exponent)
+	{
+		if (exponent < 63)
+			return Integer((int64_t)1 << exponent);
+		return Integer(BigInteger::powerOfTwo(exponent));
+	}
+
+	// The doubles next to a non-negative p / q
+	void magnitudeBounds(const Integer& p, const Integer& q, double& lower, double& upper)
+	{
+		// Both exact as doubles: one rounded division each way
+		const int64_t EXACT = (int64_t)1 << 53;
+		if (!p.isBig() && !q.isBig() && (int64_t)p <= EXACT && (int64_t)q <= EXACT)
+		{
+			lower = rounding::divDown((double)(int64_t)p, (double)(int64_t)q);
+			upper = rounding::divUp((double)(int64_t)p, (double)(int64_t)q);
+			return;
+		}
+
+		// m = p * 2^shift / q truncated has 62 or 63 bits, the rest only decides rounding up
+		int shift = 62 - ((int)p.bitLength() - (int)q.bitLength());
+		Integer num = shift > 0 ? p * powerOfTwo(shift) : p;
+		Integer den = shift < 0 ? q * powerOfTwo(-shift) : q;
+		uint64_t m = (uint64_t)(int64_t)(num / den);
+		bool inexact = num % den != 0;
+
+		int drop = 0;
+		while ((m >> drop) >= ((uint64_t)1 << 53))
+			drop++;
+		uint64_t kept = m >> drop << drop;
+		inexact = inexact || kept != m;
+
+		double top = inexact ? (double)(kept + ((uint64_t)1 << drop)) : (double)kept;
+		lower = std::ldexp((double)kept, -shift);
+		upper = std::ldexp(top, -shift);
+
+		// ldexp rounds to nearest once the result is subnormal (up to DBL_MIN, too) and
+		// overflows to infinity: a bound rounded the wrong way moves out by one double
+		if (std::ldexp(lower, shift) > (double)kept)
+			lower = std::nextafter(lower, -INFINITY);
+		if (std::ldexp(upper, shift) < top)
+			upper = std::nextafter(upper, INFINITY);
+	}
+
+	void bounds(const Rational& value, double& lower, double& upper)
+	{
+		const Integer& p = value.getNumerator();
+		const Integer& q = value.getDenominator();
+		if (p < 0)
+		{
+			magnitudeBounds(-p, q, upper, lower);
+			lower = -lower;
+			upper = -upper;
+		}
+		else
+			magnitudeBounds(p, q, lower, upper);
+	}
+}
+
+void RealD::report(RealDError code)
+{
+	// Indexed by RealDError
+	static constexpr Error REALD_ERRORS[] =
+	{
+		Error(),
+		Error(SOURCE, EMPTY_INTERVAL, "[a, b] is empty if a > b, SWAP"),
+		Error(SOURCE, ADD_WITH_NAN, "(+ NaN) is undefined"),
+		Error(SOURCE, SUB_WITH_NAN, "(- NaN) is undefined"),
+		Error(SOURCE, MULT_WITH_NAN, "(* NaN) is undefined"),
+		Error(SOURCE, DIV_WITH_NAN, "(/ NaN) is undefined"),
+		Error(SOURCE, ZERO_IN_NAN, "(0 in NaN) is undefined"),
+		Error(SOURCE, DIVIDED_BY_ZERO, "(/ b, 0 in b) result is undefined")
+	};
+
+	reportError(REALD_ERRORS[code]);
+}
+
+RealD::RealD(const Real& real)
+	: a_(0), b_(0)
+{
+	if (real.isNaN())
+	{
+		setNaN();
+		return;
+	}
+
+	double unused = 0;
+	bounds(real.getLower(), a_, unused);
+	bounds(real.getUpper(), unused, b_);
+}
+
+Real RealD::toReal() const
+{
+	if (!std::isfinite(a_) || !std::isfinite(b_))
+		return REAL_NaN;
+	return Real(Rational::fromDouble(a_), Rational::fromDouble(b_));
+}
+
+std::ostream& operator<<(std::ostream& stream, const RealD& real)
+{
+	if (real.isNaN())
+		stream << "NaN";
+	else
+		stream << "[" << real.a_ << COMMA << real.b_ << "]";
+	return stream;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <vector>
+#include <charconv>
+#include <string>
+#include <iostream>
+#include <cstdint>
+
+// Arbitrary-precision integer: sign and magnitude in 32-bit limbs, least significant first.
+// Products of long operands use Karatsuba, division is Knuth's algorithm D.
+// Division truncates towards zero like built-in integers.
+class BigInteger
+{
+private:
+	std::vector<uint32_t> limbs_;  // no leading zero limbs, empty for 0
+	bool negative_;
+
+	void trim();
+	void add(const BigInteger& other, bool otherNegative);
+	int compareMagnitude(const BigInteger& other) const;
+
+public:
+	BigInteger();
+	explicit BigInteger(int64_t value);
+	BigInteger(const BigInteger& other) = default;
+	BigInteger(BigInteger&& other) noexcept = default;
+	BigInteger& operator=(const BigInteger& other) = default;
+	BigInteger& operator=(BigInteger&& other) noexcept = default;
+	~BigInteger() = default;
+
+	// Decimal digits with an optional sign, false if there are none or anything else follows
+	static bool fromString(const std::string& digits, BigInteger& res);
+
+	// An optional '-' and decimal digits, as by std::from_chars
+	static std::from_chars_result fromChars(const char* first, const char* last, BigInteger& res);
+
+	// 2^exponent, built limb by limb
+	static BigInteger powerOfTwo(size_t exponent);
+
+	// quotient = a / b, remainder = a % b, false if b is 0
+	static bool divide(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+
+	BigInteger& operator+=(const BigInteger& other);
+	BigInteger& operator-=(const BigInteger& other);
+	BigInteger& operator*=(const BigInteger& other);
+	BigInteger& operator/=(const BigInteger& other);
+	BigInteger& operator%=(const BigInteger& other);
+	BigInteger operator-() const;
+
+	int compare(const BigInteger& other) const;
+	bool operator==(const BigInteger& other) const;
+	bool operator!=(const BigInteger& other) const;
+	bool operator>(const BigInteger& other) const;
+	bool operator>=(const BigInteger& other) const;
+	bool operator<(const BigInteger& other) const;
+	bool operator<=(const BigInteger& other) const;
+
+	bool isZero() const;
+	bool isNegative() const;
+	size_t getLimbCount() const;
+	size_t bitLength() const;  // of the magnitude, 0 for 0
+	size_t trailingZeros() const;  // of the magnitude, 0 for 0
+	size_t hash() const;
+
+	bool fitsInt64() const;
+	int64_t toInt64() const;  // low 64 bits for values that don't fit
+	std::string toString() const;
+	std::to_chars_result toChars(char* first, char* last) const;
+
+	friend std::ostream& operator<<(std::ostream& stream, const BigInteger& integer);
+};
+
+BigInteger operator+(BigInteger a, const BigInteger& b);
+BigInteger operator-(BigInteger a, const BigInteger& b);
+BigInteger operator*(BigInteger a, const BigInteger& b);
+BigInteger operator/(const BigInteger& a, const BigInteger& b);
+BigInteger operator%(const BigInteger& a, const BigInteger& b);
@@ -0,0 +1,79 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+// Helpers for the toChars / fromChars members of the Models types. Like std::to_chars they
+// report value_too_large with ptr = last when the buffer is short, and like std::from_chars
+// invalid_argument with ptr = first when the text isn't a value; nothing is allocated here.
+namespace chars
+{
+	constexpr bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	constexpr const char* skipSpaces(const char* first, const char* last)
+	{
+		while (first != last && isSpace(*first))
+			first++;
+		return first;
+	}
+
+	// Moves first past text, false if it doesn't fit
+	inline bool put(char*& first, char* last, std::string_view text)
+	{
+		if ((size_t)(last - first) < text.size())
+			return false;
+		first = std::copy(text.begin(), text.end(), first);
+		return true;
+	}
+
+	// Moves first past text if the input starts with it
+	constexpr bool take(const char*& first, const char* last, std::string_view text)
+	{
+		if ((size_t)(last - first) < text.size() || std::string_view(first, text.size()) != text)
+			return false;
+		first += text.size();
+		return true;
+	}
+
+	// Values with separator between them, nothing after the last
+	template<typename T>
+	std::to_chars_result formatAll(char* first, char* last, std::span<const T> values, char separator)
+	{
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			if (i != 0 && !put(first, last, std::string_view(&separator, 1)))
+				return { last, std::errc::value_too_large };
+			std::to_chars_result res = values[i].toChars(first, last);
+			if (res.ec != std::errc())
+				return res;
+			first = res.ptr;
+		}
+		return { first, std::errc() };
+	}
+
+	// Up to values.size() values separated by whitespace, count of them read. Stops at the end
+	// of the input or, with the error of T::fromChars, at text that isn't a value.
+	template<typename T>
+	std::from_chars_result parseAll(const char* first, const char* last, std::span<T> values, size_t& count)
+	{
+		count = 0;
+		while (count < values.size())
+		{
+			first = skipSpaces(first, last);
+			if (first == last)
+				break;
+			std::from_chars_result res = T::fromChars(first, last, values[count]);
+			if (res.ec != std::errc())
+				return res;
+			first = res.ptr;
+			count++;
+		}
+		return { first, std::errc() };
+	}
+}
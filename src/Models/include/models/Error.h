@@ -1,22 +1,48 @@
 #pragma once
-#include <string>
 #include <ostream>
 
+// Static description of a failed operation: descriptors live in constant tables,
+// so reporting one allocates nothing
 class Error 
 {
 private:
+	char const* source;
 	int code;
-	std::string message;
-
-protected:
-	Error(int code, std::string message);
+	char const* message;
 
 public:
-	Error(const Error& other);
-	Error& operator=(const Error& other);
+	constexpr Error()
+		: source(""), code(0), message("")
+	{}
+
+	constexpr Error(char const* source, int code, char const* message)
+		: source(source), code(code), message(message)
+	{}
+
+	Error(const Error& other) = default;
+	Error& operator=(const Error& other) = default;
 	~Error() = default;
 
+	char const* getSource() const;
+	int getCode() const;
+	char const* getMessage() const;
+
 	friend std::ostream& operator<<(std::ostream& stream, const Error& error);
 
 	operator bool() const;
-};
\ No newline at end of file
+};
+
+// Called for every error the models report, from the thread that hit it
+typedef void (*ErrorHandler)(const Error& error);
+
+// Returns the previous handler, nullptr (the default) only records the error
+ErrorHandler setErrorHandler(ErrorHandler handler);
+
+void reportError(const Error& error);
+
+// The last error reported on this thread, OK if none since clearLastError
+Error getLastError();
+void clearLastError();
+
+// Handler writing errors to std::cerr
+void printError(const Error& error);
@@ -0,0 +1,280 @@
+#pragma once
+#include "Overflow.h"
+#include <iostream>
+#include <cstdint>
+
+enum class INTEGER_STATUS
+{
+	OK,
+	OVERFLOW,
+	DIVIDED_BY_ZERO
+};
+
+// What a FixedInteger keeps after an overflow. The named operations (add, sub...) report
+// it in any case, division by zero always leaves the value unchanged.
+
+// The value before the operation
+struct CheckedOverflow
+{
+	template<typename T>
+	static T resolve(T old, T /*wrapped*/, bool /*positive*/)
+	{
+		return old;
+	}
+};
+
+// The closest representable value
+struct SaturatingOverflow
+{
+	template<typename T>
+	static T resolve(T /*old*/, T /*wrapped*/, bool positive)
+	{
+		return positive ? overflow::Limits<T>::max() : overflow::Limits<T>::min();
+	}
+};
+
+// The result modulo 2^bits
+struct WrappingOverflow
+{
+	template<typename T>
+	static T resolve(T /*old*/, T wrapped, bool /*positive*/)
+	{
+		return wrapped;
+	}
+};
+
+// Binary operators return the next wider storage, where the exact result always fits.
+// Compound assignments can't widen, nor can the widest storage: they behave as CheckedOverflow.
+struct WideningOverflow : CheckedOverflow
+{};
+
+template<typename Storage>
+struct WiderStorage;
+
+template<>
+struct WiderStorage<int32_t>
+{
+	typedef int64_t type;
+};
+
+#ifdef __SIZEOF_INT128__
+template<>
+struct WiderStorage<int64_t>
+{
+	typedef __int128 type;
+};
+#endif
+
+// Integer of fixed width with the overflow policy chosen at compile time, all inline.
+// Storage is int32_t, int64_t or __int128 where the compiler has it.
+template<typename Storage, typename Policy = CheckedOverflow>
+class FixedInteger
+{
+private:
+	Storage value_;
+
+	INTEGER_STATUS apply(bool overflowed, Storage res, bool positive)
+	{
+		if (!overflowed)
+		{
+			value_ = res;
+			return INTEGER_STATUS::OK;
+		}
+		value_ = Policy::resolve(value_, res, positive);
+		return INTEGER_STATUS::OVERFLOW;
+	}
+
+public:
+	typedef Storage StorageType;
+	typedef Policy PolicyType;
+
+	static constexpr Storage min()
+	{
+		return overflow::Limits<Storage>::min();
+	}
+
+	static constexpr Storage max()
+	{
+		return overflow::Limits<Storage>::max();
+	}
+
+	constexpr FixedInteger()
+		: value_(0)
+	{}
+
+	constexpr explicit FixedInteger(Storage value)
+		: value_(value)
+	{}
+
+	constexpr Storage get() const
+	{
+		return value_;
+	}
+
+	INTEGER_STATUS add(const FixedInteger& other)
+	{
+		Storage res;
+		bool overflowed = overflow::add(value_, other.value_, res);
+		return apply(overflowed, res, other.value_ > 0);
+	}
+
+	INTEGER_STATUS sub(const FixedInteger& other)
+	{
+		Storage res;
+		bool overflowed = overflow::sub(value_, other.value_, res);
+		return apply(overflowed, res, other.value_ < 0);
+	}
+
+	INTEGER_STATUS mul(const FixedInteger& other)
+	{
+		Storage res;
+		bool overflowed = overflow::mul(value_, other.value_, res);
+		return apply(overflowed, res, (value_ < 0) == (other.value_ < 0));
+	}
+
+	// min() / -1 is the only quotient that overflows
+	INTEGER_STATUS div(const FixedInteger& other)
+	{
+		if (other.value_ == 0)
+			return INTEGER_STATUS::DIVIDED_BY_ZERO;
+		if (other.value_ == -1)
+		{
+			Storage res;
+			bool overflowed = overflow::sub(Storage(0), value_, res);
+			return apply(overflowed, res, true);
+		}
+		value_ /= other.value_;
+		return INTEGER_STATUS::OK;
+	}
+
+	INTEGER_STATUS rem(const FixedInteger& other)
+	{
+		if (other.value_ == 0)
+			return INTEGER_STATUS::DIVIDED_BY_ZERO;
+		value_ = other.value_ == -1 ? 0 : value_ % other.value_;
+		return INTEGER_STATUS::OK;
+	}
+
+	FixedInteger& operator+=(const FixedInteger& other)
+	{
+		add(other);
+		return *this;
+	}
+
+	FixedInteger& operator-=(const FixedInteger& other)
+	{
+		sub(other);
+		return *this;
+	}
+
+	FixedInteger& operator*=(const FixedInteger& other)
+	{
+		mul(other);
+		return *this;
+	}
+
+	FixedInteger& operator/=(const FixedInteger& other)
+	{
+		div(other);
+		return *this;
+	}
+
+	FixedInteger& operator%=(const FixedInteger& other)
+	{
+		rem(other);
+		return *this;
+	}
+
+	FixedInteger operator-() const
+	{
+		FixedInteger res;
+		res -= *this;
+		return res;
+	}
+
+	constexpr bool operator==(const FixedInteger& other) const { return value_ == other.value_; }
+	constexpr bool operator!=(const FixedInteger& other) const { return value_ != other.value_; }
+	constexpr bool operator>(const FixedInteger& other) const { return value_ > other.value_; }
+	constexpr bool operator>=(const FixedInteger& other) const { return value_ >= other.value_; }
+	constexpr bool operator<(const FixedInteger& other) const { return value_ < other.value_; }
+	constexpr bool operator<=(const FixedInteger& other) const { return value_ <= other.value_; }
+
+	// Decimal digits, also for __int128 which streams don't know
+	friend std::ostream& operator<<(std::ostream& stream, const FixedInteger& integer)
+	{
+		char digits[48];
+		char* pos = digits + sizeof(digits);
+		*--pos = '\0';
+		Storage value = integer.value_;
+		do
+		{
+			Storage digit = value % 10;
+			*--pos = (char)('0' + (digit < 0 ? -digit : digit));
+			value /= 10;
+		} while (value != 0);
+		if (integer.value_ < 0)
+			*--pos = '-';
+		stream << pos;
+		return stream;
+	}
+};
+
+template<typename Storage, typename Policy>
+FixedInteger<Storage, Policy> operator+(FixedInteger<Storage, Policy> a, const FixedInteger<Storage, Policy>& b)
+{
+	a += b;
+	return a;
+}
+
+template<typename Storage, typename Policy>
+FixedInteger<Storage, Policy> operator-(FixedInteger<Storage, Policy> a, const FixedInteger<Storage, Policy>& b)
+{
+	a -= b;
+	return a;
+}
+
+template<typename Storage, typename Policy>
+FixedInteger<Storage, Policy> operator*(FixedInteger<Storage, Policy> a, const FixedInteger<Storage, Policy>& b)
+{
+	a *= b;
+	return a;
+}
+
+template<typename Storage, typename Policy>
+FixedInteger<Storage, Policy> operator/(FixedInteger<Storage, Policy> a, const FixedInteger<Storage, Policy>& b)
+{
+	a /= b;
+	return a;
+}
+
+template<typename Storage, typename Policy>
+FixedInteger<Storage, Policy> operator%(FixedInteger<Storage, Policy> a, const FixedInteger<Storage, Policy>& b)
+{
+	a %= b;
+	return a;
+}
+
+// n-bit sums and differences need n + 1 bits and products 2n, the wider storage holds both
+template<typename Storage>
+using Widened = FixedInteger<typename WiderStorage<Storage>::type, WideningOverflow>;
+
+template<typename Storage>
+Widened<Storage> operator+(const FixedInteger<Storage, WideningOverflow>& a, const FixedInteger<Storage, WideningOverflow>& b)
+{
+	typedef typename WiderStorage<Storage>::type Wide;
+	return Widened<Storage>((Wide)a.get() + (Wide)b.get());
+}
+
+template<typename Storage>
+Widened<Storage> operator-(const FixedInteger<Storage, WideningOverflow>& a, const FixedInteger<Storage, WideningOverflow>& b)
+{
+	typedef typename WiderStorage<Storage>::type Wide;
+	return Widened<Storage>((Wide)a.get() - (Wide)b.get());
+}
+
+template<typename Storage>
+Widened<Storage> operator*(const FixedInteger<Storage, WideningOverflow>& a, const FixedInteger<Storage, WideningOverflow>& b)
+{
+	typedef typename WiderStorage<Storage>::type Wide;
+	return Widened<Storage>((Wide)a.get() * (Wide)b.get());
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Hash mixing for the Models types. Equal values must hash alike, so every type hashes
+// its canonical form: Integer its word or limbs, Rational the reduced p / q, Real its bounds.
+namespace hashing
+{
+	// splitmix64 finalizer: every input bit reaches every output bit
+	constexpr uint64_t mix(uint64_t value)
+	{
+		value ^= value >> 30;
+		value *= 0xbf58476d1ce4e5b9ULL;
+		value ^= value >> 27;
+		value *= 0x94d049bb133111ebULL;
+		value ^= value >> 31;
+		return value;
+	}
+
+	// Not symmetric: the seed is scaled, so (p, q) and (q, p) differ
+	constexpr size_t combine(size_t seed, size_t value)
+	{
+		return (size_t)mix((uint64_t)seed * 0x9e3779b97f4a7c15ULL + value);
+	}
+}
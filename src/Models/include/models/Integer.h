@@ -1,47 +1,311 @@
 #pragma once
+#include "BigInteger.h"
+#include "Overflow.h"
+#include "Hash.h"
+#include <charconv>
+#include <functional>
+#include <span>
 #include <iostream>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
 
-class Integer 
+// Exact integer. Values in int64_t stay in a machine word and the operators below are inline
+// for them; a result that would overflow moves to a BigInteger and comes back once it fits.
+// Word-sized values also work in constant expressions, which don't report division by zero:
+// the value is left unchanged as at run time, and a big result does not compile.
+class Integer
 {
 private:
-	int i;
+	int64_t i;
+	BigInteger* big;  // owned, set only for values outside int64_t
+
+	// Slow paths, also taken for every operand that is already big
+	void addBig(const Integer& other);
+	void subBig(const Integer& other);
+	void mulBig(const Integer& other);
+	void divBig(const Integer& other);
+	void remBig(const Integer& other);
+	void setBig(BigInteger&& value);
+	BigInteger toBig() const;
+	int compareBig(const Integer& other) const;
+	static void reportDivisionByZero();
 
 public:
-	explicit Integer(int i = 0);
-	Integer(const Integer& other);
-	Integer& operator= (const Integer& other);
-	Integer& operator= (int value);
-	~Integer() = default;
-
-	Integer& operator+=(const Integer& other);
-	Integer& operator-=(const Integer& other);
-	Integer& operator*=(const Integer& other);
-	Integer& operator/=(const Integer& other);
-	Integer& operator%=(const Integer& other);
-	Integer operator-();
-
-	bool operator==(const Integer& other) const;
-	bool operator!=(const Integer& other) const;
-	bool operator>(const Integer& other) const;
-	bool operator>=(const Integer& other) const;
-	bool operator<(const Integer& other) const;
-	bool operator<=(const Integer& other) const;
-
-	bool operator==(int value) const;
-	bool operator!=(int value) const;
-	bool operator>(int value) const;
-	bool operator>=(int value) const;
-	bool operator<(int value) const;
-	bool operator<=(int value) const;
-
-	explicit operator int() const;
+	constexpr explicit Integer(int i = 0)
+		: i(i), big(nullptr)
+	{}
+
+	constexpr explicit Integer(int64_t i)
+		: i(i), big(nullptr)
+	{}
+
+	explicit Integer(const BigInteger& value);
+	explicit Integer(BigInteger&& value);
+
+	constexpr Integer(const Integer& other)
+		: i(other.i), big(other.big ? new BigInteger(*other.big) : nullptr)
+	{}
+
+	constexpr Integer(Integer&& other) noexcept
+		: i(other.i), big(other.big)
+	{
+		other.big = nullptr;
+	}
+
+	constexpr Integer& operator= (const Integer& other)
+	{
+		if (this != &other)
+		{
+			BigInteger* copy = other.big ? new BigInteger(*other.big) : nullptr;
+			delete big;
+			i = other.i;
+			big = copy;
+		}
+		return *this;
+	}
+
+	constexpr Integer& operator= (Integer&& other) noexcept
+	{
+		std::swap(i, other.i);
+		std::swap(big, other.big);
+		return *this;
+	}
+
+	constexpr Integer& operator= (int value)
+	{
+		delete big;
+		i = value;
+		big = nullptr;
+		return *this;
+	}
+
+	constexpr ~Integer()
+	{
+		delete big;
+	}
+
+	constexpr Integer& operator+=(const Integer& other)
+	{
+		int64_t res = 0;
+		if (!big && !other.big && !overflow::add(i, other.i, res))
+			i = res;
+		else
+			addBig(other);
+		return *this;
+	}
+
+	constexpr Integer& operator-=(const Integer& other)
+	{
+		int64_t res = 0;
+		if (!big && !other.big && !overflow::sub(i, other.i, res))
+			i = res;
+		else
+			subBig(other);
+		return *this;
+	}
+
+	constexpr Integer& operator*=(const Integer& other)
+	{
+		int64_t res = 0;
+		if (!big && !other.big && !overflow::mul(i, other.i, res))
+			i = res;
+		else
+			mulBig(other);
+		return *this;
+	}
+
+	constexpr Integer& operator/=(const Integer& other)
+	{
+		if (other == 0)
+		{
+			if (!std::is_constant_evaluated())
+				reportDivisionByZero();
+		}
+		else if (!big && !other.big && !(i == INT64_MIN && other.i == -1))
+			i /= other.i;
+		else
+			divBig(other);
+		return *this;
+	}
+
+	constexpr Integer& operator%=(const Integer& other)
+	{
+		if (other == 0)
+		{
+			if (!std::is_constant_evaluated())
+				reportDivisionByZero();
+		}
+		else if (!big && !other.big)
+			i = other.i == -1 ? 0 : i % other.i;
+		else
+			remBig(other);
+		return *this;
+	}
+
+	constexpr Integer operator-() const
+	{
+		Integer res;
+		res -= *this;
+		return res;
+	}
+
+	constexpr bool operator==(const Integer& other) const { return compare(other) == 0; }
+	constexpr bool operator!=(const Integer& other) const { return compare(other) != 0; }
+	constexpr bool operator>(const Integer& other) const { return compare(other) > 0; }
+	constexpr bool operator>=(const Integer& other) const { return compare(other) >= 0; }
+	constexpr bool operator<(const Integer& other) const { return compare(other) < 0; }
+	constexpr bool operator<=(const Integer& other) const { return compare(other) <= 0; }
+
+	// A big value is beyond every int
+	constexpr bool operator==(int value) const { return !big && i == value; }
+	constexpr bool operator!=(int value) const { return big || i != value; }
+	constexpr bool operator>(int value) const { return big ? !big->isNegative() : i > value; }
+	constexpr bool operator>=(int value) const { return big ? !big->isNegative() : i >= value; }
+	constexpr bool operator<(int value) const { return big ? big->isNegative() : i < value; }
+	constexpr bool operator<=(int value) const { return big ? big->isNegative() : i <= value; }
+
+	constexpr bool isBig() const
+	{
+		return big != nullptr;
+	}
+
+	size_t bitLength() const;  // of the magnitude, 0 for 0
+	size_t trailingZeros() const;  // of the magnitude, 0 for 0
+
+	size_t hash() const
+	{
+		return big ? big->hash() : (size_t)hashing::mix((uint64_t)i);
+	}
+
+	constexpr int compare(const Integer& other) const
+	{
+		if (!big && !other.big)
+			return i < other.i ? -1 : (i > other.i ? 1 : 0);
+		return compareBig(other);
+	}
+
+	// Low bits for values that don't fit
+	constexpr explicit operator int() const
+	{
+		return (int)(int64_t)*this;
+	}
+
+	constexpr explicit operator int64_t() const
+	{
+		return big ? big->toInt64() : i;
+	}
+
+	// Decimal with an optional '-', as by std::to_chars and std::from_chars. Values in a word
+	// allocate nothing.
+	std::to_chars_result toChars(char* first, char* last) const;
+	static std::from_chars_result fromChars(const char* first, const char* last, Integer& res);
+
+	// Many values: written with separator between them, read separated by whitespace
+	static std::to_chars_result toChars(char* first, char* last, std::span<const Integer> values, char separator = '\n');
+	static std::from_chars_result fromChars(const char* first, const char* last, std::span<Integer> values, size_t& count);
+
 	friend std::ostream& operator<<(std::ostream& stream, const Integer& integer);
 	friend std::istream& operator>>(std::istream& stream, Integer& integer);
 };
 
-Integer operator+(Integer a, const Integer& b);
-Integer operator-(Integer a, const Integer& b);
-Integer operator*(Integer a, const Integer& b);
-Integer operator/(Integer a, const Integer& b);
-Integer operator%(Integer a, const Integer& b);
-Integer GCD(Integer a, Integer b);
\ No newline at end of file
+constexpr Integer operator+(Integer a, const Integer& b)
+{
+	a += b;
+	return a;
+}
+
+constexpr Integer operator-(Integer a, const Integer& b)
+{
+	a -= b;
+	return a;
+}
+
+constexpr Integer operator*(Integer a, const Integer& b)
+{
+	a *= b;
+	return a;
+}
+
+constexpr Integer operator/(Integer a, const Integer& b)
+{
+	a /= b;
+	return a;
+}
+
+constexpr Integer operator%(Integer a, const Integer& b)
+{
+	a %= b;
+	return a;
+}
+
+namespace overflow
+{
+	constexpr int trailingZeros(uint64_t value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctzll(value);
+#else
+		int count = 0;
+		while ((value & 1) == 0)
+		{
+			value >>= 1;
+			count++;
+		}
+		return count;
+#endif
+	}
+
+	// Stein's algorithm: shifts and subtractions instead of divisions
+	constexpr uint64_t binaryGCD(uint64_t a, uint64_t b)
+	{
+		if (a == 0)
+			return b;
+		if (b == 0)
+			return a;
+
+		int shift = trailingZeros(a | b);
+		a >>= trailingZeros(a);
+		do
+		{
+			b >>= trailingZeros(b);
+			if (a > b)
+				std::swap(a, b);
+			b -= a;
+		} while (b != 0);
+		return a << shift;
+	}
+}
+
+// Non-negative, binary GCD once both values fit in a machine word
+constexpr Integer GCD(Integer a, Integer b)
+{
+	if (a < 0)
+		a = -a;
+	if (b < 0)
+		b = -b;
+
+	// Euclid while a value is big, every step shrinks it by about a word
+	while (a.isBig() || b.isBig())
+	{
+		if (b == 0)
+			return a;
+		Integer r = a % b;
+		a = std::move(b);
+		b = std::move(r);
+	}
+
+	uint64_t g = overflow::binaryGCD((uint64_t)(int64_t)a, (uint64_t)(int64_t)b);
+	if (g > (uint64_t)INT64_MAX)
+		return -Integer(INT64_MIN);
+	return Integer((int64_t)g);
+}
+
+template<>
+struct std::hash<Integer>
+{
+	size_t operator()(const Integer& value) const
+	{
+		return value.hash();
+	}
+};
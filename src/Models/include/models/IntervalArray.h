@@ -0,0 +1,88 @@
+#pragma once
+#include "RealD.h"
+#include <vector>
+#include <cstdint>
+
+enum class INTERVAL_KERNEL
+{
+	SCALAR,
+	AVX2,
+	AVX512
+};
+
+// Many RealD intervals with lower and upper bounds in separate arrays, for the same
+// formula over many boxes. Operations run AVX2 or AVX-512 kernels where the CPU has them:
+// the bounds are chosen by min / max instead of branches and rounded outwards as by RealD,
+// so an element is the RealD result (up to bounds near the underflow range, where either
+// may be one ulp wider). NaN elements give NaN and are not reported.
+class IntervalArray
+{
+private:
+	std::vector<double> lower_, upper_;
+
+	// Codes of the descriptors in IntervalArray.cpp
+	enum IntervalArrayError
+	{
+		OK = 0,
+		SIZE_MISMATCH = 1,
+		DIVIDED_BY_ZERO = 2
+	};
+
+	static void report(IntervalArrayError code);
+	static bool prepare(const IntervalArray& x, const IntervalArray& y, IntervalArray& res);
+
+public:
+	IntervalArray() = default;
+	explicit IntervalArray(size_t size);
+	explicit IntervalArray(const std::vector<Real>& values);
+
+	size_t size() const
+	{
+		return lower_.size();
+	}
+
+	void resize(size_t size);
+	void append(const RealD& value);
+
+	RealD get(size_t index) const
+	{
+		return RealD(lower_[index], upper_[index]);
+	}
+
+	void set(size_t index, const RealD& value)
+	{
+		lower_[index] = value.getLower();
+		upper_[index] = value.getUpper();
+	}
+
+	// Exact value of an element, for checks against Real
+	Real toReal(size_t index) const
+	{
+		return get(index).toReal();
+	}
+
+	const double* getLower() const
+	{
+		return lower_.data();
+	}
+
+	const double* getUpper() const
+	{
+		return upper_.data();
+	}
+
+	// res = x op y elementwise, res may be x or y. Sizes of x and y must match.
+	static void add(const IntervalArray& x, const IntervalArray& y, IntervalArray& res);
+	static void sub(const IntervalArray& x, const IntervalArray& y, IntervalArray& res);
+	static void mul(const IntervalArray& x, const IntervalArray& y, IntervalArray& res);
+	// Elements whose divisor contains zero become NaN, reported once per call
+	static void div(const IntervalArray& x, const IntervalArray& y, IntervalArray& res);
+
+	// 1 where the element contains zero, 0 elsewhere and for NaN
+	void containsZero(std::vector<uint8_t>& res) const;
+
+	// The best kernel the CPU has is chosen on first use. Not thread-safe, false if
+	// the CPU lacks the kernel.
+	static bool setKernel(INTERVAL_KERNEL kernel);
+	static INTERVAL_KERNEL getKernel();
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+
+// Overflow-checked arithmetic on built-in signed integers: res gets the wrapped result,
+// the return value tells whether it differs from the exact one.
+// GCC and Clang compile these to one instruction and a flag test, all work in constant expressions.
+namespace overflow
+{
+	template<typename T>
+	struct Limits
+	{
+		static constexpr T max()
+		{
+			return (T)(((T(1) << (sizeof(T) * 8 - 2)) - 1) * 2 + 1);
+		}
+
+		static constexpr T min()
+		{
+			return (T)(-max() - 1);
+		}
+	};
+
+#if defined(__GNUC__) || defined(__clang__)
+	template<typename T>
+	constexpr bool add(T a, T b, T& res)
+	{
+		return __builtin_add_overflow(a, b, &res);
+	}
+
+	template<typename T>
+	constexpr bool sub(T a, T b, T& res)
+	{
+		return __builtin_sub_overflow(a, b, &res);
+	}
+
+	template<typename T>
+	constexpr bool mul(T a, T b, T& res)
+	{
+		return __builtin_mul_overflow(a, b, &res);
+	}
+#else
+	// Wrapped results go through the unsigned type, signed overflow itself is undefined
+	template<typename T>
+	constexpr bool add(T a, T b, T& res)
+	{
+		typedef typename std::make_unsigned<T>::type U;
+		res = (T)((U)a + (U)b);
+		return (b > 0 && a > Limits<T>::max() - b) || (b < 0 && a < Limits<T>::min() - b);
+	}
+
+	template<typename T>
+	constexpr bool sub(T a, T b, T& res)
+	{
+		typedef typename std::make_unsigned<T>::type U;
+		res = (T)((U)a - (U)b);
+		return (b < 0 && a > Limits<T>::max() + b) || (b > 0 && a < Limits<T>::min() + b);
+	}
+
+	template<typename T>
+	constexpr bool mul(T a, T b, T& res)
+	{
+		typedef typename std::make_unsigned<T>::type U;
+		res = (T)((U)a * (U)b);
+		if (a == 0 || b == 0)
+			return false;
+		if (a == -1)
+			return b == Limits<T>::min();
+		if (b == -1)
+			return a == Limits<T>::min();
+		return res / b != a;
+	}
+#endif
+}
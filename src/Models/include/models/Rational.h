@@ -1,42 +1,386 @@
 #pragma once
 #include "Integer.h"
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+// Exact fraction p / q with q > 0. A lazy value skips the GCD after arithmetic until
+// a component passes LAZY_LIMIT or reduce() is called; comparisons and output are the
+// same as for a reduced value.
+// Everything but output works in constant expressions, where errors are not reported and
+// the result (NaN or the unchanged value) is the status.
 class Rational
 {
 private:
 	Integer p_, q_;
-	void transform(); // Save invariants
+	bool lazy_;
+	bool reduced_;
+
+	// Codes of the descriptors in Rational.cpp
+	enum RationalError
+	{
+		OK = 0,
+		ZERO_DENOMINATOR = 1,
+		DIVIDED_BY_ZERO = 2,
+		ADD_WITH_NAN = 3,
+		SUB_WITH_NAN = 4,
+		MULT_WITH_NAN = 5,
+		DIV_WITH_NAN = 6,
+		CMP_WITH_NAN = 7,
+		NOT_FINITE = 8,
+		WRONG_BOUND = 9
+	};
+
+	static void report(RationalError code);
+
+	constexpr static bool failed(RationalError code)
+	{
+		if (!std::is_constant_evaluated())
+			report(code);
+		return true;
+	}
+
+	constexpr static bool isSmall(const Integer& value)
+	{
+		return !value.isBig() && (int64_t)value >= -LAZY_LIMIT && (int64_t)value <= LAZY_LIMIT;
+	}
+
+	// Sign of a / b - c / d for b, d > 0 by continued fractions: the integer parts are
+	// compared and, while they are equal, the reciprocals of the remainders. No product
+	// is formed, so big values cost divisions of their own size only.
+	constexpr static int compareContinued(Integer a, Integer b, Integer c, Integer d)
+	{
+		int sa = a.compare(Integer(0)), sc = c.compare(Integer(0));
+		if (sa != sc)
+			return sa < sc ? -1 : 1;
+		if (sa == 0)
+			return 0;
+
+		int res = 1;
+		if (sa < 0)
+		{
+			// -a / b ? -c / d is c / d ? a / b
+			a = -a;
+			c = -c;
+			std::swap(a, c);
+			std::swap(b, d);
+		}
+
+		for (;;)
+		{
+			Integer qa = a / b, qc = c / d;
+			int byParts = qa.compare(qc);
+			if (byParts != 0)
+				return res * byParts;
+
+			Integer ra = a % b, rc = c % d;
+			if (ra == 0 || rc == 0)
+				return ra == 0 ? (rc == 0 ? 0 : -res) : res;
+
+			// a / b = q + ra / b, the larger remainder fraction has the smaller reciprocal b / ra
+			a = std::move(b);
+			b = std::move(ra);
+			c = std::move(d);
+			d = std::move(rc);
+			res = -res;
+		}
+	}
+
+	// Sign of a / b - c / d for b, d > 0, in 128 bits for word-sized values
+	constexpr static int compareFractions(const Integer& a, const Integer& b, const Integer& c, const Integer& d)
+	{
+#ifdef __SIZEOF_INT128__
+		if (!a.isBig() && !b.isBig() && !c.isBig() && !d.isBig())
+		{
+			__int128 left = (__int128)(int64_t)a * (int64_t)d;
+			__int128 right = (__int128)(int64_t)c * (int64_t)b;
+			return left < right ? -1 : (left > right ? 1 : 0);
+		}
+#else
+		int64_t left = 0, right = 0;
+		if (!a.isBig() && !b.isBig() && !c.isBig() && !d.isBig() &&
+			!overflow::mul((int64_t)a, (int64_t)d, left) && !overflow::mul((int64_t)c, (int64_t)b, right))
+			return left < right ? -1 : (left > right ? 1 : 0);
+#endif
+		return compareContinued(a, b, c, d);
+	}
+
+	// Save invariants
+	constexpr void transform()
+	{
+		if (p_ == 0)
+		{
+			q_ = 1;
+			reduced_ = true;
+			return;
+		}
+
+		if (q_ < 0)
+		{
+			p_ = -p_;
+			q_ = -q_;
+		}
+
+		reduced_ = false;
+		if (!lazy_ || !isSmall(p_) || !isSmall(q_))
+			reduce();
+	}
 
 public:
-	Rational(Integer p, Integer q);
-	Rational(int p, int q);
-	Rational(Integer a);
-	explicit Rational(int a);
-	Rational(const Rational &other);
-	Rational& operator= (const Rational& other);
-	~Rational() = default;
-
-	Rational& operator+=(const Rational& other);
-	Rational& operator-=(const Rational& other);
-	Rational& operator*=(const Rational& other);
-	Rational& operator/=(const Rational& other);
-	Rational operator-();
-
-	bool operator==(const Rational& other) const;
-	bool operator!=(const Rational& other) const;
-	bool operator>(const Rational& other) const;
-	bool operator>=(const Rational& other) const;
-	bool operator<(const Rational& other) const;
-	bool operator<=(const Rational& other) const;
-
-	bool isNaN() const;
+	static const int64_t LAZY_LIMIT = INT32_MAX;  // keeps cross products of lazy values in a word
+
+	constexpr Rational(Integer p, Integer q)
+		: p_(std::move(p)), q_(std::move(q)), lazy_(false), reduced_(true)
+	{
+		if (q_ == 0)
+		{
+			if (p_ != 0 && failed(ZERO_DENOMINATOR))
+				p_ = 0;
+			return;
+		}
+
+		transform();
+	}
+
+	constexpr Rational(int p, int q)
+		: Rational(Integer(p), Integer(q))
+	{}
+
+	constexpr Rational(Integer a)
+		: Rational(std::move(a), Integer(1))
+	{}
+
+	constexpr explicit Rational(int a)
+		: Rational(a, 1)
+	{}
+
+	constexpr Rational(const Rational& other) = default;
+	constexpr Rational(Rational&& other) noexcept = default;
+	constexpr Rational& operator= (const Rational& other) = default;
+	constexpr Rational& operator= (Rational&& other) noexcept = default;
+	constexpr ~Rational() = default;
+
+	constexpr Rational& operator+=(const Rational& other)
+	{
+		if ((isNaN() || other.isNaN()) && failed(ADD_WITH_NAN))
+			return *this;
+
+		p_ = p_ * other.q_ + q_ * other.p_;
+		q_ *= other.q_;
+		transform();
+
+		return *this;
+	}
+
+	constexpr Rational& operator-=(const Rational& other)
+	{
+		if ((isNaN() || other.isNaN()) && failed(SUB_WITH_NAN))
+			return *this;
+
+		p_ = p_ * other.q_ - q_ * other.p_;
+		q_ *= other.q_;
+		transform();
+
+		return *this;
+	}
+
+	constexpr Rational& operator*=(const Rational& other)
+	{
+		if ((isNaN() || other.isNaN()) && failed(MULT_WITH_NAN))
+			return *this;
+
+		p_ *= other.p_;
+		q_ *= other.q_;
+		transform();
+
+		return *this;
+	}
+
+	constexpr Rational& operator/=(const Rational& other)
+	{
+		if ((isNaN() || other.isNaN()) && failed(DIV_WITH_NAN))
+			return *this;
+
+		if (other.p_ == 0 && failed(DIVIDED_BY_ZERO))
+			return *this;
+
+		Integer temp = p_ * other.q_;
+		q_ *= other.p_;
+		p_ = std::move(temp);
+		transform();
+
+		return *this;
+	}
+
+	constexpr Rational operator-() const
+	{
+		Rational res(*this);
+		res.p_ = -res.p_;
+		return res;
+	}
+
+	// -1, 0 or 1 as this is less, equal or greater, UNORDERED if either is NaN
+	static const int UNORDERED = 2;
+
+	constexpr int compare(const Rational& other) const
+	{
+		if ((isNaN() || other.isNaN()) && failed(CMP_WITH_NAN))
+			return UNORDERED;
+
+		if (reduced_ && other.reduced_ && q_ == other.q_)
+			return p_.compare(other.p_);
+		return compareFractions(p_, q_, other.p_, other.q_);
+	}
+
+	// compare() extended to NaN, which comes first and equals itself; reports nothing
+	constexpr int compareTotal(const Rational& other) const
+	{
+		if (isNaN() || other.isNaN())
+			return isNaN() ? (other.isNaN() ? 0 : -1) : 1;
+		return compare(other);
+	}
+
+	constexpr int sign() const
+	{
+		return p_ < 0 ? -1 : (p_ == 0 ? 0 : 1);
+	}
+
+	constexpr bool operator==(const Rational& other) const
+	{
+		int res = compare(other);
+		return res != UNORDERED && res == 0;
+	}
+
+	constexpr bool operator!=(const Rational& other) const
+	{
+		int res = compare(other);
+		return res != UNORDERED && res != 0;
+	}
+
+	constexpr bool operator>(const Rational& other) const
+	{
+		int res = compare(other);
+		return res != UNORDERED && res > 0;
+	}
+
+	constexpr bool operator>=(const Rational& other) const
+	{
+		int res = compare(other);
+		return res != UNORDERED && res >= 0;
+	}
+
+	constexpr bool operator<(const Rational& other) const
+	{
+		int res = compare(other);
+		return res != UNORDERED && res < 0;
+	}
+
+	constexpr bool operator<=(const Rational& other) const
+	{
+		int res = compare(other);
+		return res != UNORDERED && res <= 0;
+	}
+
+	constexpr bool isNaN() const
+	{
+		return (p_ == 0) && (q_ == 0);
+	}
+
+	// q > 0 unless NaN, not reduced for a lazy value
+	constexpr const Integer& getNumerator() const
+	{
+		return p_;
+	}
+
+	constexpr const Integer& getDenominator() const
+	{
+		return q_;
+	}
+
+	constexpr void setLazy(bool lazy)
+	{
+		lazy_ = lazy;
+		if (!lazy)
+			reduce();
+	}
+
+	constexpr bool isLazy() const
+	{
+		return lazy_;
+	}
+
+	constexpr void reduce()
+	{
+		if (reduced_ || q_ == 0)
+			return;
+
+		Integer gcd = GCD(p_, q_);
+		p_ /= gcd;
+		q_ /= gcd;
+		reduced_ = true;
+	}
+
+	// Of the reduced form, so equal values hash alike, lazy or not
+	size_t hash() const;
+
+	// Exact value of a finite double, NaN for NaN and infinities
+	static Rational fromDouble(double value);
+
+	// Closest fraction with denominator at most maxDenominator >= 1, the smaller denominator
+	// on a tie. Found from the continued fraction, so no other fraction that size is closer.
+	Rational approximate(const Integer& maxDenominator) const;
+
+	// Nearest double, ties to even, infinite past DBL_MAX. NaN stays NaN.
+	double toDouble() const;
+
+	// One result per value, in order
+	static void fromDoubles(const double* values, size_t count, std::vector<Rational>& res);
+	static void approximate(const double* values, size_t count, const Integer& maxDenominator, std::vector<Rational>& res);
+	static void toDoubles(const Rational* values, size_t count, double* res);
+
+	// "p / q" in lowest terms as printed by <<, or "NaN". Read back with any spaces around
+	// '/', or as a plain integer "p"; a zero denominator is invalid_argument.
+	std::to_chars_result toChars(char* first, char* last) const;
+	static std::from_chars_result fromChars(const char* first, const char* last, Rational& res);
+
+	// Many values: written with separator between them, read separated by whitespace
+	static std::to_chars_result toChars(char* first, char* last, std::span<const Rational> values, char separator = '\n');
+	static std::from_chars_result fromChars(const char* first, const char* last, std::span<Rational> values, size_t& count);
 
 	friend std::ostream& operator<<(std::ostream& stream, const Rational& rational);
 };
 
-Rational operator+(Rational a, const Rational& b);
-Rational operator-(Rational a, const Rational& b);
-Rational operator*(Rational a, const Rational& b);
-Rational operator/(Rational a, const Rational& b);
+constexpr Rational operator+(Rational a, const Rational& b)
+{
+	a += b;
+	return a;
+}
 
-const Rational RATIONAL_NaN = { 0, 0 };
\ No newline at end of file
+constexpr Rational operator-(Rational a, const Rational& b)
+{
+	a -= b;
+	return a;
+}
+
+constexpr Rational operator*(Rational a, const Rational& b)
+{
+	a *= b;
+	return a;
+}
+
+constexpr Rational operator/(Rational a, const Rational& b)
+{
+	a /= b;
+	return a;
+}
+
+inline constexpr Rational RATIONAL_NaN = { 0, 0 };
+
+template<>
+struct std::hash<Rational>
+{
+	size_t operator()(const Rational& value) const
+	{
+		return value.hash();
+	}
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include "Rational.h"
+#include <vector>
+
+// Sum of many Rational values kept as numerator / common denominator. The denominator is
+// the LCM of the denominators seen so far, so a term whose denominator divides it costs
+// one multiply-add and no GCD; the sum is reduced once, by getSum. The scale of small
+// denominators is kept in a table, they cost no division either.
+class RationalAccumulator
+{
+private:
+	static const int64_t SCALE_TABLE = 64;
+
+	Integer numerator_, denominator_;
+	std::vector<Integer> scales_;  // denominator_ / q for q < SCALE_TABLE, 0 until needed
+	bool nan_;
+
+	Integer scaleFor(const Integer& q);
+	void addFraction(const Integer& p, const Integer& q);
+
+public:
+	RationalAccumulator();
+
+	void add(const Rational& value);
+	void sub(const Rational& value);
+
+	// Adds a * b, e.g. one term of a dot product
+	void addProduct(const Rational& a, const Rational& b);
+
+	// Adds a[i] * b[i] for i < count
+	void addDot(const Rational* a, const Rational* b, size_t count);
+
+	Rational getSum() const;
+	bool isNaN() const;
+	void reset();
+};
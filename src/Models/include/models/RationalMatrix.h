@@ -0,0 +1,66 @@
+#pragma once
+#include "Rational.h"
+#include <vector>
+
+// Dense matrix of Rational (or Integer) entries with exact determinant, rank and solve by
+// fraction-free Bareiss elimination. Each row is first scaled to integers by the LCM of its
+// denominators; every step then divides exactly by the previous pivot, so entries stay
+// minors of the scaled matrix (bounded by Hadamard's inequality) and no GCD is taken until
+// the result is built.
+class RationalMatrix
+{
+private:
+	size_t rows_, cols_;
+	std::vector<Rational> entries_;  // row after row
+
+	// Codes of the descriptors in RationalMatrix.cpp
+	enum RationalMatrixError
+	{
+		OK = 0,
+		WRONG_SIZE = 1,
+		NAN_ENTRY = 2,
+		SINGULAR = 3
+	};
+
+	static void report(RationalMatrixError code);
+
+	// Rows scaled to integers, with b as an extra column if given, the product of the row
+	// scales in scale. False for a NaN entry.
+	bool toIntegers(const std::vector<Rational>* b, std::vector<Integer>& res, Integer& scale) const;
+
+public:
+	RationalMatrix(size_t rows, size_t cols);
+
+	// entries row after row, rows * cols of them
+	RationalMatrix(size_t rows, size_t cols, std::vector<Rational> entries);
+
+	size_t getRows() const
+	{
+		return rows_;
+	}
+
+	size_t getCols() const
+	{
+		return cols_;
+	}
+
+	// row < getRows(), col < getCols()
+	const Rational& get(size_t row, size_t col) const
+	{
+		return entries_[row * cols_ + col];
+	}
+
+	void set(size_t row, size_t col, const Rational& value)
+	{
+		entries_[row * cols_ + col] = value;
+	}
+
+	// NaN for a matrix that isn't square or has a NaN entry
+	Rational determinant() const;
+
+	// 0 for a matrix with a NaN entry
+	size_t rank() const;
+
+	// x with this * x = b for a square nonsingular matrix, false (and x untouched) otherwise
+	bool solve(const std::vector<Rational>& b, std::vector<Rational>& x) const;
+};
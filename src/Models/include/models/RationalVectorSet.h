@@ -0,0 +1,37 @@
+#pragma once
+#include "Rational.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Hash and equality of exact rational vectors: equal coordinates in any form (lazy,
+// unreduced) give equal keys, NaN coordinates equal each other and report nothing
+struct RationalVectorHash
+{
+	size_t operator()(const std::vector<Rational>& vector) const
+	{
+		size_t res = vector.size();
+		for (const Rational& x : vector)
+			res = hashing::combine(res, x.hash());
+		return res;
+	}
+};
+
+struct RationalVectorEqual
+{
+	bool operator()(const std::vector<Rational>& a, const std::vector<Rational>& b) const
+	{
+		if (a.size() != b.size())
+			return false;
+		for (size_t i = 0; i < a.size(); i++)
+			if (a[i].compareTotal(b[i]) != 0)
+				return false;
+		return true;
+	}
+};
+
+// Exact dedupe in expected O(1) per vector instead of a scan with comparisons
+typedef std::unordered_set<std::vector<Rational>, RationalVectorHash, RationalVectorEqual> RationalVectorSet;
+
+template<typename T>
+using RationalVectorMap = std::unordered_map<std::vector<Rational>, T, RationalVectorHash, RationalVectorEqual>;
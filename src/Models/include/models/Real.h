@@ -1,40 +1,287 @@
 #pragma once
 #include "Rational.h"
+#include <algorithm>
+#include <type_traits>
+#include <utility>
 
+// Interval [a, b] of rationals, constexpr as Rational
 class Real
 {
 private:
 	Rational a_, b_;
-	
+
+	// Codes of the descriptors in Real.cpp
+	enum RealError
+	{
+		OK = 0,
+		EMPTY_INTERVAL = 1,
+		ADD_WITH_NAN = 2,
+		SUB_WITH_NAN = 3,
+		MULT_WITH_NAN = 4,
+		DIV_WITH_NAN = 5,
+		ZERO_IN_NAN = 6,
+		DIVIDED_BY_ZERO = 7
+	};
+
+	static void report(RealError code);
+
+	constexpr static bool failed(RealError code)
+	{
+		if (!std::is_constant_evaluated())
+			report(code);
+		return true;
+	}
+
 public:
-	Real(Rational a, Rational b);
-	Real(const Real& other);
-	Real& operator=(const Real& other);
-	~Real() = default;
-
-	Real& operator+=(const Real& other);
-	Real& operator-=(const Real& other);
-	Real& operator*=(const Real& other);
-	Real& operator/=(const Real& other);
-	Real operator-();
-
-	bool operator==(const Real& other) const;
-	bool operator!=(const Real& other) const;
-	bool operator>(const Real& other) const;
-	bool operator>=(const Real& other) const;
-	bool operator<(const Real& other) const;
-	bool operator<=(const Real& other) const;
-
-	bool isNaN() const;
-	bool containsZero() const;
+	constexpr Real(Rational a, Rational b)
+		: a_(std::move(a)), b_(std::move(b))
+	{
+		if (a_.isNaN() || b_.isNaN())
+		{
+			a_ = RATIONAL_NaN;
+			b_ = RATIONAL_NaN;
+			return;
+		}
+
+		if (a_ > b_ && failed(EMPTY_INTERVAL))
+			std::swap(a_, b_);
+	}
+
+	constexpr Real(const Real& other) = default;
+	constexpr Real(Real&& other) noexcept = default;
+	constexpr Real& operator=(const Real& other) = default;
+	constexpr Real& operator=(Real&& other) noexcept = default;
+	constexpr ~Real() = default;
+
+	constexpr Real& operator+=(const Real& other)
+	{
+		if ((isNaN() || other.isNaN()) && failed(ADD_WITH_NAN))
+			return *this;
+
+		a_ += other.a_;
+		b_ += other.b_;
+
+		return *this;
+	}
+
+	constexpr Real& operator-=(const Real& other)
+	{
+		if ((isNaN() || other.isNaN()) && failed(SUB_WITH_NAN))
+			return *this;
+
+		a_ -= other.b_;
+		b_ -= other.a_;
+
+		return *this;
+	}
+
+	constexpr Real& operator*=(const Real& other)
+	{
+		if ((isNaN() || other.isNaN()) && failed(MULT_WITH_NAN))
+			return *this;
+
+		// Signs of the bounds pick the two products that are the ends, only an interval
+		// with zero inside times another one needs all four
+		int sa = a_.sign(), sb = b_.sign(), sc = other.a_.sign(), sd = other.b_.sign();
+		const Rational& c = other.a_;
+		const Rational& d = other.b_;
+		Rational a(0), b(0);
+		if (sa >= 0)
+		{
+			if (sc >= 0)
+			{
+				a = a_ * c;
+				b = b_ * d;
+			}
+			else if (sd <= 0)
+			{
+				a = b_ * c;
+				b = a_ * d;
+			}
+			else
+			{
+				a = b_ * c;
+				b = b_ * d;
+			}
+		}
+		else if (sb <= 0)
+		{
+			if (sc >= 0)
+			{
+				a = a_ * d;
+				b = b_ * c;
+			}
+			else if (sd <= 0)
+			{
+				a = b_ * d;
+				b = a_ * c;
+			}
+			else
+			{
+				a = a_ * d;
+				b = a_ * c;
+			}
+		}
+		else
+		{
+			if (sc >= 0)
+			{
+				a = a_ * d;
+				b = b_ * d;
+			}
+			else if (sd <= 0)
+			{
+				a = b_ * c;
+				b = a_ * c;
+			}
+			else
+			{
+				a = std::min(a_ * d, b_ * c);
+				b = std::max(a_ * c, b_ * d);
+			}
+		}
+
+		a_ = std::move(a);
+		b_ = std::move(b);
+
+		return *this;
+	}
+
+	constexpr Real& operator/=(const Real& other)
+	{
+		if ((isNaN() || other.isNaN()) && failed(DIV_WITH_NAN))
+			return *this;
+		if (other.containsZero() && failed(DIVIDED_BY_ZERO))
+			return *this;
+		*this *= Real(Rational(1) / other.b_, Rational(1) / other.a_);
+		return *this;
+	}
+
+	constexpr Real operator-() const
+	{
+		return Real(-b_, -a_);
+	}
+
+	constexpr bool operator==(const Real& other) const
+	{
+		return (a_ == other.a_) && (b_ == other.b_);
+	}
+
+	constexpr bool operator!=(const Real& other) const
+	{
+		return (a_ != other.a_) || (b_ != other.b_);
+	}
+
+	constexpr bool operator>(const Real& other) const
+	{
+		return a_ > other.b_;
+	}
+
+	constexpr bool operator>=(const Real& other) const
+	{
+		return (*this > other) || (*this == other);
+	}
+
+	constexpr bool operator<(const Real& other) const
+	{
+		return b_ < other.a_;
+	}
+
+	constexpr bool operator<=(const Real& other) const
+	{
+		return (*this < other) || (*this == other);
+	}
+
+	constexpr bool isNaN() const
+	{
+		return (a_.isNaN()) && (b_.isNaN());
+	}
+
+	// Lexicographic on (lower, upper) with NaN first: a total order for sorted containers,
+	// where < only orders disjoint intervals
+	constexpr int compareTotal(const Real& other) const
+	{
+		int res = a_.compareTotal(other.a_);
+		return res != 0 ? res : b_.compareTotal(other.b_);
+	}
+
+	size_t hash() const;
+
+	constexpr const Rational& getLower() const
+	{
+		return a_;
+	}
+
+	constexpr const Rational& getUpper() const
+	{
+		return b_;
+	}
+
+	constexpr bool containsZero() const
+	{
+		if (isNaN() && failed(ZERO_IN_NAN))
+			return false;
+
+		return a_.sign() <= 0 && b_.sign() >= 0;
+	}
+
+	// "[a, b]" as printed by <<, or "NaN". Read back with any spaces inside the brackets;
+	// a > b is invalid_argument.
+	std::to_chars_result toChars(char* first, char* last) const;
+	static std::from_chars_result fromChars(const char* first, const char* last, Real& res);
+
+	// Many values: written with separator between them, read separated by whitespace
+	static std::to_chars_result toChars(char* first, char* last, std::span<const Real> values, char separator = '\n');
+	static std::from_chars_result fromChars(const char* first, const char* last, std::span<Real> values, size_t& count);
 
 	friend std::ostream& operator<<(std::ostream& stream, const Real& real);
 };
 
-Real operator+(Real a, const Real& b);
-Real operator-(Real a, const Real& b);
-Real operator*(Real a, const Real& b);
-Real operator/(Real a, const Real& b);
-Real operator*(Rational m, const Real& a);
+constexpr Real operator+(Real a, const Real& b)
+{
+	a += b;
+	return a;
+}
+
+constexpr Real operator-(Real a, const Real& b)
+{
+	a -= b;
+	return a;
+}
+
+constexpr Real operator*(Real a, const Real& b)
+{
+	a *= b;
+	return a;
+}
+
+constexpr Real operator/(Real a, const Real& b)
+{
+	a /= b;
+	return a;
+}
+
+constexpr Real operator*(Rational m, const Real& a)
+{
+	return Real(m, m) * a;
+}
+
+inline constexpr Real REAL_NaN = Real(RATIONAL_NaN, RATIONAL_NaN);
+
+// Real keys for std::map and std::set
+struct RealTotalLess
+{
+	constexpr bool operator()(const Real& a, const Real& b) const
+	{
+		return a.compareTotal(b) < 0;
+	}
+};
 
-const Real REAL_NaN = Real(RATIONAL_NaN, RATIONAL_NaN);
\ No newline at end of file
+template<>
+struct std::hash<Real>
+{
+	size_t operator()(const Real& value) const
+	{
+		return value.hash();
+	}
+};
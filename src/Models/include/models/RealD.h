@@ -0,0 +1,315 @@
+#pragma once
+#include "Real.h"
+#include "Rounding.h"
+#include <limits>
+
+// Interval [a, b] of doubles with the operators of Real. Every bound is rounded outwards,
+// so the exact result of the same operations on Real is always inside. Overflowing bounds
+// become infinite, which Real can't hold.
+class RealD
+{
+private:
+	double a_, b_;
+
+	// Codes of the descriptors in RealD.cpp
+	enum RealDError
+	{
+		OK = 0,
+		EMPTY_INTERVAL = 1,
+		ADD_WITH_NAN = 2,
+		SUB_WITH_NAN = 3,
+		MULT_WITH_NAN = 4,
+		DIV_WITH_NAN = 5,
+		ZERO_IN_NAN = 6,
+		DIVIDED_BY_ZERO = 7
+	};
+
+	static void report(RealDError code);
+
+	constexpr void setNaN()
+	{
+		a_ = b_ = std::numeric_limits<double>::quiet_NaN();
+	}
+
+public:
+	constexpr RealD(double a, double b)
+		: a_(a), b_(b)
+	{
+		if (a != a || b != b)
+			setNaN();
+		else if (a > b)
+		{
+			if (!std::is_constant_evaluated())
+				report(EMPTY_INTERVAL);
+			std::swap(a_, b_);
+		}
+	}
+
+	constexpr explicit RealD(double a)
+		: RealD(a, a)
+	{}
+
+	// The smallest enclosing interval
+	explicit RealD(const Real& real);
+
+	// Exact, REAL_NaN for NaN or unbounded intervals
+	Real toReal() const;
+
+	constexpr RealD(const RealD& other) = default;
+	constexpr RealD& operator=(const RealD& other) = default;
+	~RealD() = default;
+
+	RealD& operator+=(const RealD& other)
+	{
+		if (isNaN() || other.isNaN())
+		{
+			report(ADD_WITH_NAN);
+			return *this;
+		}
+
+		a_ = rounding::addDown(a_, other.a_);
+		b_ = rounding::addUp(b_, other.b_);
+
+		return *this;
+	}
+
+	RealD& operator-=(const RealD& other)
+	{
+		if (isNaN() || other.isNaN())
+		{
+			report(SUB_WITH_NAN);
+			return *this;
+		}
+
+		double a = rounding::subDown(a_, other.b_);
+		b_ = rounding::subUp(b_, other.a_);
+		a_ = a;
+
+		return *this;
+	}
+
+	// Same sign cases as Real
+	RealD& operator*=(const RealD& other)
+	{
+		if (isNaN() || other.isNaN())
+		{
+			report(MULT_WITH_NAN);
+			return *this;
+		}
+
+		double c = other.a_, d = other.b_;
+		double a, b;
+		if (a_ >= 0)
+		{
+			if (c >= 0)
+			{
+				a = rounding::mulDown(a_, c);
+				b = rounding::mulUp(b_, d);
+			}
+			else if (d <= 0)
+			{
+				a = rounding::mulDown(b_, c);
+				b = rounding::mulUp(a_, d);
+			}
+			else
+			{
+				a = rounding::mulDown(b_, c);
+				b = rounding::mulUp(b_, d);
+			}
+		}
+		else if (b_ <= 0)
+		{
+			if (c >= 0)
+			{
+				a = rounding::mulDown(a_, d);
+				b = rounding::mulUp(b_, c);
+			}
+			else if (d <= 0)
+			{
+				a = rounding::mulDown(b_, d);
+				b = rounding::mulUp(a_, c);
+			}
+			else
+			{
+				a = rounding::mulDown(a_, d);
+				b = rounding::mulUp(a_, c);
+			}
+		}
+		else
+		{
+			if (c >= 0)
+			{
+				a = rounding::mulDown(a_, d);
+				b = rounding::mulUp(b_, d);
+			}
+			else if (d <= 0)
+			{
+				a = rounding::mulDown(b_, c);
+				b = rounding::mulUp(a_, c);
+			}
+			else
+			{
+				a = std::min(rounding::mulDown(a_, d), rounding::mulDown(b_, c));
+				b = std::max(rounding::mulUp(a_, c), rounding::mulUp(b_, d));
+			}
+		}
+
+		a_ = a;
+		b_ = b;
+
+		return *this;
+	}
+
+	// Divisors without zero only: either all positive or all negative
+	RealD& operator/=(const RealD& other)
+	{
+		if (isNaN() || other.isNaN())
+		{
+			report(DIV_WITH_NAN);
+			return *this;
+		}
+		if (other.containsZero())
+		{
+			report(DIVIDED_BY_ZERO);
+			return *this;
+		}
+
+		double c = other.a_, d = other.b_;
+		double a, b;
+		if (c > 0)
+		{
+			if (a_ >= 0)
+			{
+				a = rounding::divDown(a_, d);
+				b = rounding::divUp(b_, c);
+			}
+			else if (b_ <= 0)
+			{
+				a = rounding::divDown(a_, c);
+				b = rounding::divUp(b_, d);
+			}
+			else
+			{
+				a = rounding::divDown(a_, c);
+				b = rounding::divUp(b_, c);
+			}
+		}
+		else
+		{
+			if (a_ >= 0)
+			{
+				a = rounding::divDown(b_, d);
+				b = rounding::divUp(a_, c);
+			}
+			else if (b_ <= 0)
+			{
+				a = rounding::divDown(b_, c);
+				b = rounding::divUp(a_, d);
+			}
+			else
+			{
+				a = rounding::divDown(b_, d);
+				b = rounding::divUp(a_, d);
+			}
+		}
+
+		a_ = a;
+		b_ = b;
+
+		return *this;
+	}
+
+	RealD operator-() const
+	{
+		return RealD(-b_, -a_);
+	}
+
+	constexpr bool operator==(const RealD& other) const
+	{
+		return (a_ == other.a_) && (b_ == other.b_);
+	}
+
+	constexpr bool operator!=(const RealD& other) const
+	{
+		return (a_ != other.a_) || (b_ != other.b_);
+	}
+
+	constexpr bool operator>(const RealD& other) const
+	{
+		return a_ > other.b_;
+	}
+
+	constexpr bool operator>=(const RealD& other) const
+	{
+		return (*this > other) || (*this == other);
+	}
+
+	constexpr bool operator<(const RealD& other) const
+	{
+		return b_ < other.a_;
+	}
+
+	constexpr bool operator<=(const RealD& other) const
+	{
+		return (*this < other) || (*this == other);
+	}
+
+	constexpr bool isNaN() const
+	{
+		return a_ != a_;
+	}
+
+	bool containsZero() const
+	{
+		if (isNaN())
+		{
+			report(ZERO_IN_NAN);
+			return false;
+		}
+
+		return a_ <= 0 && b_ >= 0;
+	}
+
+	constexpr double getLower() const
+	{
+		return a_;
+	}
+
+	constexpr double getUpper() const
+	{
+		return b_;
+	}
+
+	friend std::ostream& operator<<(std::ostream& stream, const RealD& real);
+};
+
+inline RealD operator+(RealD a, const RealD& b)
+{
+	a += b;
+	return a;
+}
+
+inline RealD operator-(RealD a, const RealD& b)
+{
+	a -= b;
+	return a;
+}
+
+inline RealD operator*(RealD a, const RealD& b)
+{
+	a *= b;
+	return a;
+}
+
+inline RealD operator/(RealD a, const RealD& b)
+{
+	a /= b;
+	return a;
+}
+
+inline RealD operator*(double m, const RealD& a)
+{
+	return RealD(m, m) * a;
+}
+
+inline constexpr RealD REALD_NaN = RealD(std::numeric_limits<double>::quiet_NaN());
@@ -0,0 +1,140 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Directed rounding of double operations without touching the FPU mode: the result is
+// computed to nearest and its exact error, found by error-free transforms, decides
+// whether to step one ulp outwards. Where the error isn't representable (overflow,
+// underflow) the step is taken anyway, so the bound is always kept.
+// Expects the default rounding mode and no -ffast-math.
+namespace rounding
+{
+	// Error terms are exact for operands and results inside these bounds
+	constexpr double TINY = 0x1p-969;
+	constexpr double HUGE_RESULT = 0x1p1023;
+	constexpr double HUGE_OPERAND = 0x1p995;
+
+	// Knuth's TwoSum: a + b - s exactly, NaN if s overflowed
+	inline double sumError(double a, double b, double s)
+	{
+		double bb = s - a;
+		return (a - (s - bb)) + (b - bb);
+	}
+
+	// a * b - p exactly, NaN where it can't be represented
+	inline double productError(double a, double b, double p)
+	{
+		if (a == 0 || b == 0)
+			return 0;
+		if (!(std::fabs(p) >= TINY && std::fabs(p) <= HUGE_RESULT))
+			return NAN;
+#ifdef __FMA__
+		return std::fma(a, b, -p);
+#else
+		// Dekker's product on halves from Veltkamp's split
+		if (!(std::fabs(a) < HUGE_OPERAND && std::fabs(b) < HUGE_OPERAND))
+			return NAN;
+		const double SPLIT = 134217729.0;  // 2^27 + 1
+		double ca = SPLIT * a, cb = SPLIT * b;
+		double ah = ca - (ca - a), al = a - ah;
+		double bh = cb - (cb - b), bl = b - bh;
+		return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+	}
+
+	// a - q * b exactly for q = a / b rounded, NaN where it can't be represented
+	inline double quotientRemainder(double a, double b, double q)
+	{
+		if (a == 0)
+			return 0;
+		if (!(std::fabs(a) >= TINY && std::fabs(q) >= TINY))
+			return NAN;
+#ifdef __FMA__
+		return std::fma(-q, b, a);
+#else
+		double p = q * b;
+		return (a - p) - productError(q, b, p);
+#endif
+	}
+
+	// std::nextafter towards -infinity without the library call
+	inline double nextDown(double value)
+	{
+		if (value != value || value == -INFINITY)
+			return value;
+		if (value == 0)
+			return -std::numeric_limits<double>::denorm_min();
+		uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		bits = value > 0 ? bits - 1 : bits + 1;
+		std::memcpy(&value, &bits, sizeof(bits));
+		return value;
+	}
+
+	inline double nextUp(double value)
+	{
+		return -nextDown(-value);
+	}
+
+	// Steps down unless the error says the result is already below the exact value
+	inline double down(double res, double error)
+	{
+		return error < 0 || error != error ? nextDown(res) : res;
+	}
+
+	inline double up(double res, double error)
+	{
+		return error > 0 || error != error ? nextUp(res) : res;
+	}
+
+	inline double addDown(double a, double b)
+	{
+		double s = a + b;
+		return down(s, sumError(a, b, s));
+	}
+
+	inline double addUp(double a, double b)
+	{
+		double s = a + b;
+		return up(s, sumError(a, b, s));
+	}
+
+	inline double subDown(double a, double b)
+	{
+		return addDown(a, -b);
+	}
+
+	inline double subUp(double a, double b)
+	{
+		return addUp(a, -b);
+	}
+
+	inline double mulDown(double a, double b)
+	{
+		double p = a * b;
+		return down(p, productError(a, b, p));
+	}
+
+	inline double mulUp(double a, double b)
+	{
+		double p = a * b;
+		return up(p, productError(a, b, p));
+	}
+
+	// a / b = q + r / b, so the sign of r / b is the sign of the error
+	inline double divDown(double a, double b)
+	{
+		double q = a / b;
+		double r = quotientRemainder(a, b, q);
+		return down(q, b < 0 ? -r : r);
+	}
+
+	inline double divUp(double a, double b)
+	{
+		double q = a / b;
+		double r = quotientRemainder(a, b, q);
+		return up(q, b < 0 ? -r : r);
+	}
+}
@@ -0,0 +1,244 @@
+#include "numeric/AsyncLogger.h"
+#include "MpscRing.h"
+#include "RotatingFile.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <string>
+#include <cstring>
+#include <limits>
+#include <exception>
+
+namespace {
+	struct Record
+	{
+		RESULT_CODE code;
+		size_t length;
+		char text[AsyncLogger::MESSAGE_SIZE];
+	};
+
+	// Logger whose writer runs on this thread
+	thread_local AsyncLogger const* ownWriter = nullptr;
+
+	class AsyncLoggerImpl : public AsyncLogger
+	{
+	private:
+		MpscRing<Record> ring_;
+		OVERFLOW_POLICY overflow_;
+		std::string fileName_;
+		LogFileParams fileParams_;
+		RotatingFile out_;
+		std::mutex fileMutex_;
+
+		std::atomic<size_t> clients_;
+		std::atomic<size_t> dropped_;
+		std::atomic<size_t> written_;
+		std::atomic<bool> sleeping_;
+		std::atomic<bool> stop_;
+		std::mutex mutex_;
+		std::condition_variable wake_;
+		std::condition_variable done_;
+		std::thread writer_;
+
+		void wakeWriter();
+		void run();
+		bool writeBatch(std::string& batch, size_t& reported);
+
+	public:
+		AsyncLoggerImpl(Params const& params);
+		~AsyncLoggerImpl();
+
+		void attach(void* pClient) override;
+		void destroyLogger(void* pClient) override;
+		void log(char const* pMsg, RESULT_CODE err) override;
+		RESULT_CODE setLogFile(char const* pLogFile) override;
+		RESULT_CODE setLogFile(char const* pLogFile, LogFileParams const& params) override;
+		void flush() override;
+		size_t getDropped() const override;
+	};
+
+	AsyncLoggerImpl::AsyncLoggerImpl(Params const& params)
+		: ring_(params.capacity), overflow_(params.overflow), fileName_(params.fileName != nullptr ? params.fileName : "log.txt"),
+		fileParams_(params.file),
+		clients_(1), dropped_(0), written_(0), sleeping_(false), stop_(false)
+	{
+		writer_ = std::thread(&AsyncLoggerImpl::run, this);
+	}
+
+	// Every record queued so far is written before the thread exits
+	AsyncLoggerImpl::~AsyncLoggerImpl()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		wake_.notify_one();
+		writer_.join();
+	}
+
+	void AsyncLoggerImpl::wakeWriter()
+	{
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleeping_.load(std::memory_order_relaxed))
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			wake_.notify_one();
+		}
+	}
+
+	bool AsyncLoggerImpl::writeBatch(std::string& batch, size_t& reported)
+	{
+		size_t dropped = dropped_.load(std::memory_order_relaxed);
+		if (dropped != reported)
+		{
+			batch += "[AsyncLogger] " + std::to_string(dropped - reported) + " records dropped\n";
+			reported = dropped;
+		}
+
+		std::lock_guard<std::mutex> lock(fileMutex_);
+		if (batch.empty())
+		{
+			out_.flushIfDue();
+			return false;
+		}
+
+		if (!out_.isOpen())
+			out_.open(fileName_.c_str(), fileParams_);
+		out_.write(batch.data(), batch.size());
+		batch.clear();
+		return true;
+	}
+
+	void AsyncLoggerImpl::run()
+	{
+		ownWriter = this;
+		std::string batch;
+		size_t reported = 0;
+		for (;;)
+		{
+			while (ring_.tryPop([&](Record const& record) {
+				batch.append(record.text, record.length);
+				if (record.code != RESULT_CODE::SUCCESS)
+					(batch += ' ') += codeName(record.code);
+				batch += '\n';
+			}))
+			{}
+
+			// Idle: no new record may come to end a rate-limit period, report the periods that are over
+			if (!writeBatch(batch, reported))
+				LogStats::flushExpiredSummaries(this);
+			written_.store(ring_.popped(), std::memory_order_release);
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				done_.notify_all();
+			}
+
+			std::unique_lock<std::mutex> lock(mutex_);
+			if (stop_ && ring_.popped() == ring_.pushed())
+				break;
+
+			sleeping_ = true;
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!stop_ && ring_.popped() == ring_.pushed())
+				wake_.wait_for(lock, std::chrono::milliseconds(50));
+			sleeping_ = false;
+		}
+	}
+
+	void AsyncLoggerImpl::attach(void* /*pClient*/)
+	{
+		clients_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void AsyncLoggerImpl::destroyLogger(void* /*pClient*/)
+	{
+		if (clients_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			LogStats::release(this);
+			delete this;
+		}
+	}
+
+	void AsyncLoggerImpl::log(char const* pMsg, RESULT_CODE err)
+	{
+		if (pMsg == nullptr || !isEnabled(levelOf(err)))
+			return;
+
+		auto fill = [pMsg, err](Record& record) {
+			record.code = err;
+			size_t length = strlen(pMsg);
+			record.length = length < MESSAGE_SIZE - 1 ? length : MESSAGE_SIZE - 1;
+			memcpy(record.text, pMsg, record.length);
+		};
+
+		while (!ring_.tryPush(fill))
+		{
+			// The writer logs its own summaries, it can't wait for itself
+			if (overflow_ == OVERFLOW_POLICY::DROP || ownWriter == this)
+			{
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			wakeWriter();
+			std::this_thread::yield();
+		}
+
+		wakeWriter();
+	}
+
+	RESULT_CODE AsyncLoggerImpl::setLogFile(char const* pLogFile)
+	{
+		return setLogFile(pLogFile, fileParams_);
+	}
+
+	RESULT_CODE AsyncLoggerImpl::setLogFile(char const* pLogFile, LogFileParams const& params)
+	{
+		if (pLogFile == nullptr)
+			return RESULT_CODE::BAD_REFERENCE;
+
+		std::lock_guard<std::mutex> lock(fileMutex_);
+		if (out_.isOpen())
+			return RESULT_CODE::MULTIPLE_DEFINITION;
+
+		if (!out_.open(pLogFile, params))
+			return RESULT_CODE::FILE_ERROR;
+
+		return RESULT_CODE::SUCCESS;
+	}
+
+	void AsyncLoggerImpl::flush()
+	{
+		LogStats::flushSummaries(this);
+		size_t target = ring_.pushed();
+		std::unique_lock<std::mutex> lock(mutex_);
+		wake_.notify_one();
+		done_.wait(lock, [&]() { return written_.load(std::memory_order_acquire) >= target; });
+		lock.unlock();
+
+		std::lock_guard<std::mutex> fileLock(fileMutex_);
+		out_.flush();
+	}
+
+	size_t AsyncLoggerImpl::getDropped() const
+	{
+		return dropped_.load(std::memory_order_relaxed);
+	}
+}
+
+// The ring and the writer thread report failure only by throwing
+AsyncLogger* AsyncLogger::createLogger(void* /*pClient*/, Params const& params)
+{
+	if (params.capacity == 0 || params.capacity > std::numeric_limits<size_t>::max() / 2 / sizeof(Record))
+		return nullptr;
+
+	try
+	{
+		return new AsyncLoggerImpl(params);
+	}
+	catch (std::exception const&)
+	{
+		return nullptr;
+	}
+}
@@ -0,0 +1,212 @@
+#include "numeric/BinaryLogger.h"
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+	// Unbuffered: records are buffered by the logger, so a failed write shows in the fwrite result
+	bool writeHeader(std::FILE* file)
+	{
+		std::setvbuf(file, nullptr, _IONBF, 0);
+
+		BinaryLogHeader header;
+		memcpy(header.magic, BinaryLogHeader::magicValue(), sizeof(header.magic));
+		header.version = BinaryLogHeader::VERSION;
+		header.messages = (uint32_t)MESSAGE_ID::COUNT;
+		return std::fwrite(&header, sizeof(header), 1, file) == 1;
+	}
+
+	// Cuts a torn write off the end of the file, false if it stays
+	bool truncate(std::FILE* file, long size)
+	{
+		std::fseek(file, size, SEEK_SET);
+#ifdef _WIN32
+		return _chsize_s(_fileno(file), size) == 0;
+#else
+		return ftruncate(fileno(file), size) == 0;
+#endif
+	}
+
+	uint32_t threadNumber()
+	{
+		static std::atomic<uint32_t> next{ 1 };
+		thread_local uint32_t number = next.fetch_add(1, std::memory_order_relaxed);
+		return number;
+	}
+
+	class BinaryLoggerImpl : public BinaryLogger
+	{
+	private:
+		static const size_t BUFFER_SIZE = 64 << 10;
+
+		std::FILE* file_;
+		std::vector<char> buffer_;
+		size_t records_;     // in the buffer
+		long written_;       // bytes of whole buffers in the file
+		std::mutex mutex_;
+		std::atomic<size_t> clients_;
+		std::atomic<size_t> dropped_;
+
+		void append(void const* data, size_t size);
+		void writeBuffer();
+		void write(MESSAGE_ID id, RESULT_CODE code, int64_t const* args, size_t argc, char const* text, size_t length);
+
+	public:
+		BinaryLoggerImpl(std::FILE* file);
+		~BinaryLoggerImpl();
+
+		void attach(void* pClient) override;
+		void destroyLogger(void* pClient) override;
+		void log(char const* pMsg, RESULT_CODE err) override;
+		void logRecord(MESSAGE_ID id, RESULT_CODE code, int64_t const* args, size_t argc) override;
+		RESULT_CODE setLogFile(char const* pLogFile) override;
+		void flush() override;
+		size_t getDropped() const override;
+	};
+
+	BinaryLoggerImpl::BinaryLoggerImpl(std::FILE* file)
+		: file_(file), records_(0), written_(sizeof(BinaryLogHeader)), clients_(1), dropped_(0)
+	{
+		buffer_.reserve(BUFFER_SIZE);
+	}
+
+	BinaryLoggerImpl::~BinaryLoggerImpl()
+	{
+		writeBuffer();
+		std::fclose(file_);
+	}
+
+	void BinaryLoggerImpl::append(void const* data, size_t size)
+	{
+		buffer_.insert(buffer_.end(), (char const*)data, (char const*)data + size);
+	}
+
+	// A short write loses the records of the buffer and is cut off, so the file stays
+	// readable up to its last whole buffer
+	void BinaryLoggerImpl::writeBuffer()
+	{
+		if (!buffer_.empty())
+		{
+			size_t written = std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+			if (written == buffer_.size())
+				written_ += (long)written;
+			else
+			{
+				dropped_.fetch_add(records_, std::memory_order_relaxed);
+				std::clearerr(file_);
+				truncate(file_, written_);
+			}
+		}
+		buffer_.clear();
+		records_ = 0;
+	}
+
+	void BinaryLoggerImpl::write(MESSAGE_ID id, RESULT_CODE code, int64_t const* args, size_t argc, char const* text, size_t length)
+	{
+		static const char zeros[8] = {};
+
+		BinaryRecord record;
+		record.timestamp = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+		record.thread = threadNumber();
+		record.id = (uint16_t)id;
+		record.code = (uint8_t)code;
+		record.argc = (uint8_t)(argc < BinaryRecord::MAX_ARGS ? argc : BinaryRecord::MAX_ARGS);
+
+		size_t padding = text != nullptr ? (8 - length % 8) % 8 : 0;
+		size_t size = sizeof(record) + record.argc * sizeof(int64_t) + length + padding;
+
+		// A record never spans two writes
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (buffer_.size() + size > BUFFER_SIZE)
+			writeBuffer();
+		append(&record, sizeof(record));
+		append(args, record.argc * sizeof(int64_t));
+		if (text != nullptr)
+		{
+			append(text, length);
+			append(zeros, padding);
+		}
+		records_++;
+	}
+
+	void BinaryLoggerImpl::attach(void* /*pClient*/)
+	{
+		clients_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void BinaryLoggerImpl::destroyLogger(void* /*pClient*/)
+	{
+		if (clients_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			LogStats::release(this);
+			delete this;
+		}
+	}
+
+	void BinaryLoggerImpl::log(char const* pMsg, RESULT_CODE err)
+	{
+		if (pMsg == nullptr || !isEnabled(levelOf(err)))
+			return;
+
+		size_t length = strlen(pMsg);
+		if (length > BinaryRecord::MAX_TEXT)
+			length = BinaryRecord::MAX_TEXT;
+		int64_t arg = (int64_t)length;
+		write(MESSAGE_ID::TEXT, err, &arg, 1, pMsg, length);
+	}
+
+	void BinaryLoggerImpl::logRecord(MESSAGE_ID id, RESULT_CODE code, int64_t const* args, size_t argc)
+	{
+		if (id == MESSAGE_ID::TEXT || id >= MESSAGE_ID::COUNT || !isEnabled(levelOf(code)))
+			return;
+
+		write(id, code, args, argc, nullptr, 0);
+	}
+
+	RESULT_CODE BinaryLoggerImpl::setLogFile(char const* pLogFile)
+	{
+		return pLogFile == nullptr ? RESULT_CODE::BAD_REFERENCE : RESULT_CODE::MULTIPLE_DEFINITION;
+	}
+
+	void BinaryLoggerImpl::flush()
+	{
+		LogStats::flushSummaries(this);
+		std::lock_guard<std::mutex> lock(mutex_);
+		writeBuffer();
+	}
+
+	size_t BinaryLoggerImpl::getDropped() const
+	{
+		return dropped_.load(std::memory_order_relaxed);
+	}
+}
+
+BinaryLogger* BinaryLogger::createLogger(void* /*pClient*/, char const* pFileName)
+{
+	if (pFileName == nullptr)
+		return nullptr;
+
+	std::FILE* file = std::fopen(pFileName, "wb");
+	if (file == nullptr)
+		return nullptr;
+	if (!writeHeader(file))
+	{
+		std::fclose(file);
+		return nullptr;
+	}
+
+	BinaryLogger* res = new (std::nothrow) BinaryLoggerImpl(file);
+	if (res == nullptr)
+		std::fclose(file);
+	return res;
+}
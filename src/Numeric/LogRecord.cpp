@@ -0,0 +1,124 @@
+#include "numeric/LogRecord.h"
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+	char const* const formats[] = {
+#define UI_LOG_MESSAGE_FORMAT(name, text) text,
+		UI_LOG_MESSAGES(UI_LOG_MESSAGE_FORMAT)
+#undef UI_LOG_MESSAGE_FORMAT
+	};
+
+	static_assert(sizeof(formats) / sizeof(formats[0]) == (size_t)MESSAGE_ID::COUNT, "one format per message");
+}
+
+char const* messageFormat(MESSAGE_ID id)
+{
+	if (id >= MESSAGE_ID::COUNT)
+		return nullptr;
+	return formats[(size_t)id];
+}
+
+char const* codeName(RESULT_CODE code)
+{
+	switch (code)
+	{
+	case RESULT_CODE::SUCCESS:
+		return "SUCCESS";
+	case RESULT_CODE::BAD_REFERENCE:
+		return "BAD_REFERENCE";
+	case RESULT_CODE::CALCULATION_ERROR:
+		return "CALCULATION_ERROR";
+	case RESULT_CODE::DIVISION_BY_ZERO:
+		return "DIVISION_BY_ZERO";
+	case RESULT_CODE::FILE_ERROR:
+		return "FILE_ERROR";
+	case RESULT_CODE::MULTIPLE_DEFINITION:
+		return "MULTIPLE_DEFINITION";
+	case RESULT_CODE::NAN_VALUE:
+		return "NAN_VALUE";
+	case RESULT_CODE::NOT_FOUND:
+		return "NOT_FOUND";
+	case RESULT_CODE::OUT_OF_BOUNDS:
+		return "OUT_OF_BOUNDS";
+	case RESULT_CODE::OUT_OF_MEMORY:
+		return "OUT_OF_MEMORY";
+	case RESULT_CODE::WRONG_ARGUMENT:
+		return "WRONG_ARGUMENT";
+	case RESULT_CODE::WRONG_DIM:
+		return "WRONG_DIM";
+	}
+	return "UNKNOWN";
+}
+
+std::string formatMessage(MESSAGE_ID id, int64_t const* args, size_t argc)
+{
+	char const* format = messageFormat(id);
+	if (format == nullptr)
+		return "unknown message " + std::to_string((unsigned)id);
+
+	std::string res;
+	size_t arg = 0;
+	for (char const* pos = format; *pos != 0; pos++)
+	{
+		if (pos[0] == '{' && pos[1] == '}' && arg < argc)
+		{
+			res += std::to_string(args[arg++]);
+			pos++;
+		}
+		else if (strncmp(pos, "{msg}", 5) == 0 && arg < argc)
+		{
+			char const* nested = args[arg] >= 0 && args[arg] < (int64_t)MESSAGE_ID::COUNT ? messageFormat((MESSAGE_ID)args[arg]) : "?";
+			res += nested;
+			arg++;
+			pos += 4;
+		}
+		else
+			res += *pos;
+	}
+	return res;
+}
+
+RESULT_CODE decodeBinaryLog(char const* pFileName, std::ostream& out)
+{
+	if (pFileName == nullptr)
+		return RESULT_CODE::BAD_REFERENCE;
+
+	std::ifstream in(pFileName, std::ifstream::in | std::ifstream::binary);
+	BinaryLogHeader header;
+	if (!in.read((char*)&header, sizeof(header))
+		|| memcmp(header.magic, BinaryLogHeader::magicValue(), sizeof(header.magic)) != 0
+		|| header.version != BinaryLogHeader::VERSION)
+		return RESULT_CODE::FILE_ERROR;
+
+	BinaryRecord record;
+	int64_t args[BinaryRecord::MAX_ARGS];
+	std::vector<char> text;
+	while (in.read((char*)&record, sizeof(record)))
+	{
+		if (record.argc > BinaryRecord::MAX_ARGS || !in.read((char*)args, record.argc * sizeof(int64_t)))
+			return RESULT_CODE::FILE_ERROR;
+
+		std::string msg;
+		if (record.id == (uint16_t)MESSAGE_ID::TEXT)
+		{
+			if (record.argc != 1 || args[0] < 0 || args[0] > (int64_t)BinaryRecord::MAX_TEXT)
+				return RESULT_CODE::FILE_ERROR;
+			text.resize((size_t)(args[0] + 7) / 8 * 8);
+			if (!in.read(text.data(), (std::streamsize)text.size()))
+				return RESULT_CODE::FILE_ERROR;
+			msg.assign(text.data(), (size_t)args[0]);
+		}
+		else
+			msg = formatMessage((MESSAGE_ID)record.id, args, record.argc);
+
+		char stamp[32];
+		std::snprintf(stamp, sizeof(stamp), "%llu.%09llu", (unsigned long long)(record.timestamp / 1000000000),
+			(unsigned long long)(record.timestamp % 1000000000));
+		out << stamp << " t" << record.thread << " " << msg << " " << codeName((RESULT_CODE)record.code) << "\n";
+	}
+
+	return in.eof() && in.gcount() == 0 ? RESULT_CODE::SUCCESS : RESULT_CODE::FILE_ERROR;
+}
@@ -0,0 +1,191 @@
+#include "numeric/LogStats.h"
+#include "numeric/LogLevel.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+	const size_t CODES = 32;
+
+	struct Window
+	{
+		std::atomic<uint64_t> start{ 0 };  // ms, steady clock
+		std::atomic<size_t> count{ 0 };
+		std::atomic<size_t> suppressed{ 0 };
+		std::atomic<size_t> totalSuppressed{ 0 };
+		std::atomic<size_t> total{ 0 };
+		std::atomic<int> code{ 0 };
+		std::atomic<ILogger*> logger{ nullptr };  // where the suppressed records were going
+	};
+
+	std::atomic<size_t> burst{ LogStats::Limit().burst };
+	std::atomic<size_t> periodMs{ LogStats::Limit().periodMs };
+	std::atomic<size_t> codeCounts[CODES];
+	Window windows[(size_t)MESSAGE_ID::COUNT];
+
+	// Threads calling a logger taken from a window, release() waits for them
+	std::atomic<size_t> reporting{ 0 };
+
+	uint64_t nowMs()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void summarize(ILogger* pLogger, MESSAGE_ID id, Window& window, size_t suppressed, uint64_t ms)
+	{
+		RESULT_CODE code = (RESULT_CODE)window.code.load(std::memory_order_relaxed);
+		if (isLogEnabled(pLogger, levelOf(code)))
+			logRecord(pLogger, MESSAGE_ID::SUPPRESSED, code, suppressed, ms, (int64_t)id);
+	}
+
+	void report(ILogger* pLogger, MESSAGE_ID id, Window& window, uint64_t now)
+	{
+		size_t suppressed = window.suppressed.exchange(0, std::memory_order_relaxed);
+		if (suppressed != 0)
+			summarize(pLogger, id, window, suppressed, now - window.start.load(std::memory_order_relaxed));
+	}
+
+	// Reports the windows of pLogger and lets them go
+	void flushOwned(ILogger* pLogger, bool expiredOnly)
+	{
+		if (pLogger == nullptr)
+			return;
+
+		uint64_t now = nowMs();
+		size_t period = periodMs.load(std::memory_order_relaxed);
+		for (size_t id = 0; id < (size_t)MESSAGE_ID::COUNT; id++)
+		{
+			Window& window = windows[id];
+			if (window.logger.load(std::memory_order_relaxed) != pLogger
+				|| (expiredOnly && now - window.start.load(std::memory_order_relaxed) < period))
+				continue;
+
+			report(pLogger, (MESSAGE_ID)id, window, now);
+			ILogger* owner = pLogger;
+			window.logger.compare_exchange_strong(owner, nullptr);
+		}
+	}
+}
+
+void LogStats::setLimit(Limit const& limit)
+{
+	burst.store(limit.burst, std::memory_order_relaxed);
+	periodMs.store(limit.periodMs, std::memory_order_relaxed);
+}
+
+LogStats::Limit LogStats::getLimit()
+{
+	Limit res;
+	res.burst = burst.load(std::memory_order_relaxed);
+	res.periodMs = periodMs.load(std::memory_order_relaxed);
+	return res;
+}
+
+size_t LogStats::getCount(RESULT_CODE code)
+{
+	size_t index = (size_t)code;
+	return index < CODES ? codeCounts[index].load(std::memory_order_relaxed) : 0;
+}
+
+size_t LogStats::getCount(MESSAGE_ID id)
+{
+	return id < MESSAGE_ID::COUNT ? windows[(size_t)id].total.load(std::memory_order_relaxed) : 0;
+}
+
+size_t LogStats::getSuppressed(MESSAGE_ID id)
+{
+	return id < MESSAGE_ID::COUNT ? windows[(size_t)id].totalSuppressed.load(std::memory_order_relaxed) : 0;
+}
+
+void LogStats::reset()
+{
+	for (std::atomic<size_t>& counter : codeCounts)
+		counter.store(0, std::memory_order_relaxed);
+
+	for (Window& window : windows)
+	{
+		window.start.store(0, std::memory_order_relaxed);
+		window.count.store(0, std::memory_order_relaxed);
+		window.suppressed.store(0, std::memory_order_relaxed);
+		window.totalSuppressed.store(0, std::memory_order_relaxed);
+		window.total.store(0, std::memory_order_relaxed);
+		window.logger.store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+void LogStats::flushSummaries(ILogger* pLogger)
+{
+	flushOwned(pLogger, false);
+}
+
+void LogStats::flushExpiredSummaries(ILogger* pLogger)
+{
+	flushOwned(pLogger, true);
+}
+
+// Once the windows let pLogger go no thread can take it from them, the ones that took it
+// before are waited for
+void LogStats::release(ILogger* pLogger)
+{
+	flushOwned(pLogger, false);
+	while (reporting.load() != 0)
+		std::this_thread::yield();
+}
+
+void LogStats::count(RESULT_CODE code)
+{
+	size_t index = (size_t)code;
+	if (index < CODES)
+		codeCounts[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogStats::count(MESSAGE_ID id, RESULT_CODE code)
+{
+	count(code);
+	if (id < MESSAGE_ID::COUNT)
+		windows[(size_t)id].total.fetch_add(1, std::memory_order_relaxed);
+}
+
+// The thread that ends a period reports what the period suppressed to the logger it was suppressed for
+bool LogStats::admit(MESSAGE_ID id, RESULT_CODE code, ILogger* pLogger)
+{
+	size_t limit = burst.load(std::memory_order_relaxed);
+	if (limit == 0 || id >= MESSAGE_ID::COUNT)
+		return true;
+
+	Window& window = windows[(size_t)id];
+	uint64_t now = nowMs();
+	uint64_t start = window.start.load(std::memory_order_relaxed);
+	if (now - start >= periodMs.load(std::memory_order_relaxed)
+		&& window.start.compare_exchange_strong(start, now, std::memory_order_relaxed))
+	{
+		window.count.store(0, std::memory_order_relaxed);
+		size_t suppressed = window.suppressed.exchange(0, std::memory_order_relaxed);
+		if (suppressed != 0)
+		{
+			reporting.fetch_add(1);
+			ILogger* owner = window.logger.load();
+			summarize(owner != nullptr ? owner : pLogger, id, window, suppressed, now - start);
+			reporting.fetch_sub(1);
+		}
+	}
+
+	if (window.count.fetch_add(1, std::memory_order_relaxed) < limit)
+		return true;
+
+	// Records suppressed for another logger are reported to it before the window changes hands
+	if (window.logger.load(std::memory_order_relaxed) != pLogger)
+	{
+		reporting.fetch_add(1);
+		ILogger* owner = window.logger.exchange(pLogger);
+		if (owner != pLogger && owner != nullptr)
+			report(owner, id, window, now);
+		reporting.fetch_sub(1);
+	}
+
+	window.code.store((int)code, std::memory_order_relaxed);
+	window.suppressed.fetch_add(1, std::memory_order_relaxed);
+	window.totalSuppressed.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
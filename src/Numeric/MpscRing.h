@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+// Bounded lock-free ring for many producers and one consumer.
+// Every cell carries a sequence number: a producer claims a position with one CAS
+// and publishes the cell by bumping its sequence, the consumer reads cells in order.
+template<typename T>
+class MpscRing
+{
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+
+	std::vector<Cell> cells_;
+	size_t mask_;
+	alignas(64) std::atomic<size_t> enqueuePos_;
+	alignas(64) size_t dequeuePos_;
+
+public:
+	// capacity is rounded up to a power of two
+	explicit MpscRing(size_t capacity)
+		: enqueuePos_(0), dequeuePos_(0)
+	{
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+
+		cells_ = std::vector<Cell>(size);
+		mask_ = size - 1;
+		for (size_t i = 0; i < size; i++)
+			cells_[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	MpscRing(MpscRing const&) = delete;
+	MpscRing& operator=(MpscRing const&) = delete;
+
+	// Claims a cell and fills it with fill(T&), false if the ring is full
+	template<typename F>
+	bool tryPush(F fill)
+	{
+		size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell& cell = cells_[pos & mask_];
+			size_t seq = cell.sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+			if (diff == 0)
+			{
+				if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					fill(cell.value);
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+				return false;
+			else
+				pos = enqueuePos_.load(std::memory_order_relaxed);
+		}
+	}
+
+	// Consumer side only: hands the oldest published value to read(T const&)
+	template<typename F>
+	bool tryPop(F read)
+	{
+		Cell& cell = cells_[dequeuePos_ & mask_];
+		size_t seq = cell.sequence.load(std::memory_order_acquire);
+		if (seq != dequeuePos_ + 1)
+			return false;
+
+		read(cell.value);
+		cell.sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+		dequeuePos_++;
+		return true;
+	}
+
+	// Positions claimed so far, a record counts once its push succeeds
+	size_t pushed() const
+	{
+		return enqueuePos_.load(std::memory_order_acquire);
+	}
+
+	size_t popped() const
+	{
+		return dequeuePos_;
+	}
+};
@@ -1,124 +1,125 @@
 #include "ILogger.h"
-#include <set>
+#include "numeric/LogLevel.h"
+#include "RotatingFile.h"
+#include <atomic>
+#include <mutex>
 #include <string>
-#include <fstream>
 
 namespace {
-	class MyLogger;
-
-	MyLogger* logger = nullptr;
-
-	class MyLogger : public ILogger
+	class MyLogger : public ILeveledLogger
 	{
 	private:
-		std::set<void*> clients;
+		std::atomic<size_t> clients{ 0 };
+		std::mutex mutex;  // guards the file and the transitions between 0 and 1 clients
 		std::string fileName = "log.txt";
-		std::ofstream out;
+		RotatingFile out;
+		std::string line;
 
 		MyLogger() = default;
 
+		// Nothing checks flushMs between calls, so little is kept back by default
+		static LogFileParams defaultParams()
+		{
+			LogFileParams params;
+			params.bufferSize = 4 << 10;
+			return params;
+		}
+
+		// Lives until exit, so a client racing with the last destroyLogger never sees freed memory
+		static MyLogger& instance()
+		{
+			static MyLogger logger;
+			return logger;
+		}
+
+		// Back to a fresh logger once the last client is gone
+		void reset()
+		{
+			out.close();
+			setLevel(LOG_LEVEL::INFO);
+		}
+
+		RESULT_CODE open(char const* pLogFile, LogFileParams const& params)
+		{
+			if (out.isOpen())
+				return RESULT_CODE::MULTIPLE_DEFINITION;
+
+			if (!out.open(pLogFile, params))
+				return RESULT_CODE::FILE_ERROR;
+
+			return RESULT_CODE::SUCCESS;
+		}
+
 	protected:
 		void writeCode(RESULT_CODE rc)
 		{
-			switch (rc)
-			{
-			case RESULT_CODE::BAD_REFERENCE:
-				out << " BAD_REFERENCE\n";
-				break;
-			case RESULT_CODE::CALCULATION_ERROR:
-				out << " CALCULATION_ERROR\n";
-				break;
-			case RESULT_CODE::DIVISION_BY_ZERO:
-				out << " DIVISION_BY_ZERO\n";
-				break;
-			case RESULT_CODE::FILE_ERROR:
-				out << " FILE_ERROR\n";
-				break;
-			case RESULT_CODE::MULTIPLE_DEFINITION:
-				out << " MULTIPLE_DEFINITION\n";
-				break;
-			case RESULT_CODE::NAN_VALUE:
-				out << " NAN_VALUE\n";
-				break;
-			case RESULT_CODE::NOT_FOUND:
-				out << " NOT_FOUND\n";
-				break;
-			case RESULT_CODE::OUT_OF_BOUNDS:
-				out << " OUT_OF_BOUNDS\n";
-				break;
-			case RESULT_CODE::OUT_OF_MEMORY:
-				out << " OUT_OF_MEMORY\n";
-				break;
-			case RESULT_CODE::SUCCESS:
-				out << "\n";
-				break;
-			case RESULT_CODE::WRONG_ARGUMENT:
-				out << " WRONG_ARGUMENT\n";
-				break;
-			case RESULT_CODE::WRONG_DIM:
-				out << " WRONG_DIM\n";
-				break;
-			}
+			if (rc != RESULT_CODE::SUCCESS)
+				(line += " ") += codeName(rc);
+			line += "\n";
 		}
 
 	public:
+		// Clients are counted, not stored: one CAS while the logger has clients
 		static MyLogger* createLogger(void* pClient)
 		{
-			if (logger == nullptr)
-				logger = new MyLogger();
-
-			if (pClient != nullptr)
-				logger->clients.insert(pClient);
-
-			return logger;
+			MyLogger& logger = instance();
+			if (pClient == nullptr)
+				return &logger;
+
+			size_t count = logger.clients.load(std::memory_order_relaxed);
+			while (count != 0)
+				if (logger.clients.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel))
+					return &logger;
+
+			std::lock_guard<std::mutex> lock(logger.mutex);
+			logger.clients.fetch_add(1, std::memory_order_relaxed);
+			return &logger;
 		}
 
 		void destroyLogger(void* pClient) override
 		{
-			if (pClient != nullptr)
-				clients.erase(clients.find(pClient));
+			if (pClient != nullptr && clients.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return;
 
-			if (clients.empty())
-			{
-				delete logger;
-				logger = nullptr;
-			}
+			LogStats::release(this);
+			std::lock_guard<std::mutex> lock(mutex);
+			if (clients.load(std::memory_order_relaxed) == 0)
+				reset();
 		}
 
 		void log(char const* pMsg, RESULT_CODE err) override
 		{
-			if (pMsg != nullptr)
+			if (pMsg != nullptr && isEnabled(levelOf(err)))
 			{
-				if (!out.is_open())
-				{
-					out.open(fileName, std::ofstream::out);
-					if (!out.is_open())
-						return;
-				}
-				out << pMsg << "\n";
+				std::lock_guard<std::mutex> lock(mutex);
+				if (!out.isOpen() && !out.open(fileName.c_str(), defaultParams()))
+					return;
+
+				line.assign(pMsg);
+				writeCode(err);
+				out.write(line.data(), line.size());
 			}
 		}
 
 		RESULT_CODE setLogFile(char const* pLogFile) override
+		{
+			return setLogFile(pLogFile, defaultParams());
+		}
+
+		RESULT_CODE setLogFile(char const* pLogFile, LogFileParams const& params) override
 		{
 			if (pLogFile == nullptr)
 				return RESULT_CODE::BAD_REFERENCE;
 
-			if (out.is_open())
-				return RESULT_CODE::MULTIPLE_DEFINITION;
-
-			out.open(pLogFile, std::ofstream::out);
-
-			if (!out.is_open())
-				return RESULT_CODE::FILE_ERROR;
-
-			return RESULT_CODE::SUCCESS;
+			std::lock_guard<std::mutex> lock(mutex);
+			return open(pLogFile, params);
 		}
 
-		~MyLogger()
+		void flush() override
 		{
-			if (out.is_open())
-				out.close();
+			LogStats::flushSummaries(this);
+			std::lock_guard<std::mutex> lock(mutex);
+			out.flush();
 		}
 	};
 }
@@ -129,6 +130,11 @@ ILogger* ILogger::createLogger(void* pClient)
 	return MyLogger::createLogger(pClient);
 }
 
+ILeveledLogger* ILeveledLogger::createLogger(void* pClient)
+{
+	return MyLogger::createLogger(pClient);
+}
+
 
 ILogger::~ILogger()
 {}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "RotatingFile.h"
+#include <cstdio>
+
+RotatingFile::RotatingFile()
+	: size_(0)
+{}
+
+RotatingFile::~RotatingFile()
+{
+	close();
+}
+
+bool RotatingFile::open(char const* pFileName, LogFileParams const& params)
+{
+	close();
+	params_ = params;
+	fileName_ = pFileName;
+	out_.open(fileName_, std::ofstream::out | std::ofstream::binary);
+	size_ = 0;
+	written_ = std::chrono::steady_clock::now();
+	if (params_.bufferSize != 0)
+		buffer_.reserve(params_.bufferSize);
+	return out_.is_open();
+}
+
+bool RotatingFile::isOpen() const
+{
+	return out_.is_open();
+}
+
+void RotatingFile::close()
+{
+	if (out_.is_open())
+	{
+		writeBuffer();
+		out_.close();
+	}
+	buffer_.clear();
+}
+
+void RotatingFile::writeBuffer()
+{
+	if (!buffer_.empty())
+	{
+		out_.write(buffer_.data(), (std::streamsize)buffer_.size());
+		out_.flush();
+		buffer_.clear();
+	}
+	written_ = std::chrono::steady_clock::now();
+}
+
+// name.(maxFiles - 1) is dropped, every older file moves one place up
+void RotatingFile::rotate()
+{
+	writeBuffer();
+	out_.close();
+
+	if (params_.maxFiles > 1)
+	{
+		std::string last = fileName_ + "." + std::to_string(params_.maxFiles - 1);
+		std::remove(last.c_str());
+		for (size_t i = params_.maxFiles - 1; i > 1; i--)
+		{
+			std::string from = fileName_ + "." + std::to_string(i - 1);
+			std::string to = fileName_ + "." + std::to_string(i);
+			std::rename(from.c_str(), to.c_str());
+		}
+		std::rename(fileName_.c_str(), (fileName_ + ".1").c_str());
+	}
+
+	out_.open(fileName_, std::ofstream::out | std::ofstream::binary);
+	size_ = 0;
+}
+
+void RotatingFile::write(char const* pData, size_t size)
+{
+	if (!out_.is_open())
+		return;
+
+	if (params_.maxSize != 0 && size_ != 0 && size_ + size > params_.maxSize)
+	{
+		rotate();
+		if (!out_.is_open())
+			return;
+	}
+
+	buffer_.append(pData, size);
+	size_ += size;
+	if (buffer_.size() >= params_.bufferSize)
+		writeBuffer();
+	else
+		flushIfDue();
+}
+
+void RotatingFile::flushIfDue()
+{
+	if (!buffer_.empty() && std::chrono::steady_clock::now() - written_ >= std::chrono::milliseconds(params_.flushMs))
+		writeBuffer();
+}
+
+void RotatingFile::flush()
+{
+	if (out_.is_open())
+		writeBuffer();
+}
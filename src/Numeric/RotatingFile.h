@@ -0,0 +1,38 @@
+#pragma once
+#include "numeric/LogFile.h"
+#include <string>
+#include <fstream>
+#include <chrono>
+
+// Buffered log file rotated by size, see LogFileParams. Not thread safe, loggers lock around it.
+class RotatingFile
+{
+private:
+	LogFileParams params_;
+	std::string fileName_;
+	std::ofstream out_;
+	std::string buffer_;
+	size_t size_;  // bytes of the current file, written or buffered
+	std::chrono::steady_clock::time_point written_;
+
+	void writeBuffer();
+	void rotate();
+
+public:
+	RotatingFile();
+	~RotatingFile();
+
+	RotatingFile(RotatingFile const&) = delete;
+	RotatingFile& operator=(RotatingFile const&) = delete;
+
+	// Truncates the file, false if it can't be opened
+	bool open(char const* pFileName, LogFileParams const& params);
+	bool isOpen() const;
+	void close();
+
+	void write(char const* pData, size_t size);
+
+	// Writes the buffer if flushMs have passed, for loggers that wake up without new lines
+	void flushIfDue();
+	void flush();
+};
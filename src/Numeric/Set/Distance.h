@@ -0,0 +1,49 @@
+#pragma once
+#include "IVector.h"
+#include <cmath>
+
+// Same predicate as IVector::sub(a, b)->norm(norm) < tolerance, without temporaries.
+// Partial sums only grow, so the scan stops as soon as the answer is known.
+inline bool isNear(double const* a, double const* b, size_t dim, IVector::NORM norm, double tolerance)
+{
+	double value = 0;
+
+	switch (norm)
+	{
+	case IVector::NORM::NORM_1:
+		for (size_t i = 0; i < dim; i++)
+		{
+			value += fabs(a[i] - b[i]);
+			if (value >= tolerance)
+				return false;
+		}
+		break;
+
+	case IVector::NORM::NORM_2:
+		for (size_t i = 0; i < dim; i++)
+		{
+			double d = a[i] - b[i];
+			value += d * d;
+			if ((i & 7) == 7 && sqrt(value) >= tolerance)
+				return false;
+		}
+		value = sqrt(value);
+		break;
+
+	case IVector::NORM::NORM_INF:
+		for (size_t i = 0; i < dim; i++)
+		{
+			double d = fabs(a[i] - b[i]);
+			if (d >= tolerance)
+				return false;
+			if (value < d)
+				value = d;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return value < tolerance;
+}
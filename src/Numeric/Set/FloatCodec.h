@@ -0,0 +1,475 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+// Lossless compression of a block of vectors, column by column. Every column of
+// the block is a segment (uint32 byte length, mode byte, bit stream) holding
+// the smallest of three encodings:
+//   RAW      dim doubles as they are, for incompressible columns
+//   DECIMAL  all values are exactly k / 10^e: e, base and width, then k - base
+//            in width bits each (frame of reference, tiny ranges after Morton sort)
+//   XOR      Gorilla-style: first value raw, every next one XORed with the previous:
+//              '0'                                       same value
+//              '10' + bits                               fits the previous window
+//              '11' + 6 bits lead + 6 bits len-1 + bits  new window
+class BitWriter
+{
+private:
+	std::vector<uint8_t>& out_;
+	uint64_t acc_ = 0;
+	unsigned filled_ = 0;
+
+	void emit(uint64_t word, unsigned bytes)
+	{
+		for (unsigned i = 0; i < bytes; i++)
+			out_.push_back((uint8_t)(word >> (56 - 8 * i)));
+	}
+
+public:
+	BitWriter(std::vector<uint8_t>& out)
+		: out_(out)
+	{}
+
+	// Appends the low count bits of value, count <= 64
+	void write(uint64_t value, unsigned count)
+	{
+		if (count == 0)
+			return;
+		if (count < 64)
+			value &= (1ull << count) - 1;
+
+		unsigned space = 64 - filled_;
+		if (count < space)
+		{
+			acc_ = (acc_ << count) | value;
+			filled_ += count;
+			return;
+		}
+
+		unsigned rest = count - space;
+		acc_ = (space == 64 ? 0 : acc_ << space) | (value >> rest);
+		emit(acc_, 8);
+		acc_ = rest == 0 ? 0 : value & ((1ull << rest) - 1);
+		filled_ = rest;
+	}
+
+	void flush()
+	{
+		if (filled_ == 0)
+			return;
+		emit(acc_ << (64 - filled_), (filled_ + 7) / 8);
+		acc_ = 0;
+		filled_ = 0;
+	}
+};
+
+class BitReader
+{
+private:
+	uint8_t const* pos_;
+	uint8_t const* end_;
+	uint64_t buf_ = 0;
+	unsigned avail_ = 0;
+	bool overrun_ = false;
+
+	void refill()
+	{
+		size_t left = (size_t)(end_ - pos_);
+		if (left >= 8)
+		{
+			uint64_t word = 0;
+			for (unsigned i = 0; i < 8; i++)
+				word = (word << 8) | pos_[i];
+			pos_ += 8;
+			buf_ = word;
+			avail_ = 64;
+			return;
+		}
+
+		if (left == 0)
+			overrun_ = true;
+		buf_ = 0;
+		for (size_t i = 0; i < left; i++)
+			buf_ |= (uint64_t)pos_[i] << (56 - 8 * i);
+		pos_ = end_;
+		avail_ = left == 0 ? 64 : (unsigned)(8 * left);
+	}
+
+public:
+	BitReader(uint8_t const* bytes, size_t size)
+		: pos_(bytes), end_(bytes + size)
+	{}
+
+	// Reads count bits, count <= 64
+	uint64_t read(unsigned count)
+	{
+		if (count == 0)
+			return 0;
+
+		if (count <= avail_)
+		{
+			uint64_t res = buf_ >> (64 - count);
+			buf_ = count == 64 ? 0 : buf_ << count;
+			avail_ -= count;
+			return res;
+		}
+
+		unsigned have = avail_;
+		uint64_t high = have == 0 ? 0 : buf_ >> (64 - have);
+		unsigned need = count - have;
+		refill();
+		if (need > avail_)
+		{
+			// Fewer bits are left than asked for, the missing ones read as zeros
+			overrun_ = true;
+			avail_ = need;
+		}
+		uint64_t low = buf_ >> (64 - need);
+		buf_ = need == 64 ? 0 : buf_ << need;
+		avail_ -= need;
+		return need == 64 ? low : (high << need) | low;
+	}
+
+	bool overrun() const
+	{
+		return overrun_;
+	}
+};
+
+inline uint64_t doubleBits(double x)
+{
+	uint64_t bits;
+	memcpy(&bits, &x, sizeof(bits));
+	return bits;
+}
+
+inline double bitsDouble(uint64_t bits)
+{
+	double x;
+	memcpy(&x, &bits, sizeof(x));
+	return x;
+}
+
+inline unsigned leadingZeros(uint64_t x)
+{
+#if defined(__GNUC__)
+	return (unsigned)__builtin_clzll(x);
+#else
+	unsigned n = 0;
+	while (!(x & (1ull << 63)))
+	{
+		x <<= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+inline unsigned trailingZeros(uint64_t x)
+{
+#if defined(__GNUC__)
+	return (unsigned)__builtin_ctzll(x);
+#else
+	unsigned n = 0;
+	while (!(x & 1))
+	{
+		x >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+enum class COLUMN_MODE : uint8_t
+{
+	XOR = 0,
+	DECIMAL = 1,
+	RAW = 2
+};
+
+static const unsigned DECIMAL_DIGITS = 15;
+static const unsigned DECIMAL_HEADER_BITS = 4 + 64 + 7;
+
+inline double decimalScale(unsigned e)
+{
+	static const double scale[DECIMAL_DIGITS + 1] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+	};
+	return scale[e];
+}
+
+// Finds the fewest digits e with x == k / 10^e for every value, bit for bit
+inline bool findDecimal(double const* coords, size_t count, size_t stride, unsigned& digits, int64_t& lo, int64_t& hi)
+{
+	for (unsigned e = 0; e <= DECIMAL_DIGITS; e++)
+	{
+		double scale = decimalScale(e);
+		bool exact = true;
+		for (size_t v = 0; v < count && exact; v++)
+		{
+			double x = coords[v * stride];
+			double scaled = x * scale;
+			if (!(scaled > -9007199254740992.0 && scaled < 9007199254740992.0))
+			{
+				exact = false;
+				break;
+			}
+			int64_t k = (int64_t)(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+			exact = doubleBits((double)k / scale) == doubleBits(x);
+			if (v == 0 || k < lo)
+				lo = k;
+			if (v == 0 || k > hi)
+				hi = k;
+		}
+
+		if (exact)
+		{
+			digits = e;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+inline void encodeDecimal(double const* coords, size_t count, size_t stride, unsigned digits, int64_t lo, int64_t hi, std::vector<uint8_t>& out)
+{
+	uint64_t range = (uint64_t)hi - (uint64_t)lo;
+	unsigned width = range == 0 ? 0 : 64 - leadingZeros(range);
+	double scale = decimalScale(digits);
+
+	BitWriter writer(out);
+	writer.write(digits, 4);
+	writer.write((uint64_t)lo, 64);
+	writer.write(width, 7);
+	for (size_t v = 0; v < count; v++)
+	{
+		double scaled = coords[v * stride] * scale;
+		int64_t k = (int64_t)(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+		writer.write((uint64_t)k - (uint64_t)lo, width);
+	}
+	writer.flush();
+}
+
+inline void encodeXor(double const* coords, size_t count, size_t stride, std::vector<uint8_t>& out)
+{
+	BitWriter writer(out);
+	uint64_t prev = doubleBits(coords[0]);
+	unsigned lead = 65;
+	unsigned trail = 0;
+	writer.write(prev, 64);
+
+	for (size_t v = 1; v < count; v++)
+	{
+		uint64_t cur = doubleBits(coords[v * stride]);
+		uint64_t x = cur ^ prev;
+		prev = cur;
+		if (x == 0)
+		{
+			writer.write(0, 1);
+			continue;
+		}
+
+		unsigned l = leadingZeros(x);
+		unsigned t = trailingZeros(x);
+		if (l > 63)
+			l = 63;
+
+		if (lead <= 64 && l >= lead && t >= trail)
+		{
+			writer.write(2, 2);
+			writer.write(x >> trail, 64 - lead - trail);
+		}
+		else
+		{
+			unsigned len = 64 - l - t;
+			writer.write(3, 2);
+			writer.write(l, 6);
+			writer.write(len - 1, 6);
+			writer.write(x >> t, len);
+			lead = l;
+			trail = t;
+		}
+	}
+	writer.flush();
+}
+
+inline void appendSegment(COLUMN_MODE mode, std::vector<uint8_t> const& bits, std::vector<uint8_t>& out)
+{
+	uint32_t size = (uint32_t)bits.size() + 1;
+	for (unsigned i = 0; i < 4; i++)
+		out.push_back((uint8_t)(size >> (8 * i)));
+	out.push_back((uint8_t)mode);
+	out.insert(out.end(), bits.begin(), bits.end());
+}
+
+// Appends the encoding of count vectors (dim coordinates each) to out
+inline void encodeBlock(double const* coords, size_t count, size_t dim, std::vector<uint8_t>& out)
+{
+	if (count == 0)
+		return;
+
+	std::vector<uint8_t> xorBits;
+	std::vector<uint8_t> decimalBits;
+	std::vector<uint8_t> rawBits(count * sizeof(double));
+	for (size_t d = 0; d < dim; d++)
+	{
+		xorBits.clear();
+		encodeXor(coords + d, count, dim, xorBits);
+
+		unsigned digits;
+		int64_t lo = 0;
+		int64_t hi = 0;
+		decimalBits.clear();
+		if (findDecimal(coords + d, count, dim, digits, lo, hi))
+			encodeDecimal(coords + d, count, dim, digits, lo, hi, decimalBits);
+
+		if (!decimalBits.empty() && decimalBits.size() <= xorBits.size() && decimalBits.size() <= rawBits.size())
+			appendSegment(COLUMN_MODE::DECIMAL, decimalBits, out);
+		else if (xorBits.size() < rawBits.size())
+			appendSegment(COLUMN_MODE::XOR, xorBits, out);
+		else
+		{
+			for (size_t v = 0; v < count; v++)
+				memcpy(rawBits.data() + v * sizeof(double), coords + v * dim + d, sizeof(double));
+			appendSegment(COLUMN_MODE::RAW, rawBits, out);
+		}
+	}
+}
+
+inline uint64_t loadBigEndian(uint8_t const* bytes)
+{
+	uint64_t word;
+	memcpy(&word, bytes, sizeof(word));
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	return __builtin_bswap64(word);
+#elif defined(__GNUC__)
+	return word;
+#else
+	uint64_t res = 0;
+	for (unsigned i = 0; i < 8; i++)
+		res = (res << 8) | bytes[i];
+	return res;
+#endif
+}
+
+// Values are unpacked with one unaligned load each while 8 bytes remain,
+// k / 10^e is exact by construction, so decoding is a shift, an add and a division
+inline bool decodeDecimal(uint8_t const* bytes, size_t size, size_t count, size_t stride, double* coords)
+{
+	BitReader reader(bytes, size);
+	unsigned digits = (unsigned)reader.read(4);
+	uint64_t lo = reader.read(64);
+	unsigned width = (unsigned)reader.read(7);
+	if (reader.overrun() || digits > DECIMAL_DIGITS || width > 57)
+		return false;
+	if ((DECIMAL_HEADER_BITS + (uint64_t)count * width + 7) / 8 > size)
+		return false;
+
+	double scale = decimalScale(digits);
+	uint64_t mask = width == 0 ? 0 : ~0ull >> (64 - width);
+	size_t fast = size < 8 ? 0 : count;
+	while (fast > 0 && (DECIMAL_HEADER_BITS + (fast - 1) * width) / 8 + 8 > size)
+		fast--;
+
+	size_t v = 0;
+	uint64_t bit = DECIMAL_HEADER_BITS;
+	if (width == 0)
+		fast = count;
+	for (; v < fast; v++, bit += width)
+	{
+		uint64_t word = width == 0 ? 0 : loadBigEndian(bytes + bit / 8);
+		int64_t k = (int64_t)(lo + ((word >> (64 - width - bit % 8)) & mask));
+		coords[v * stride] = digits == 0 ? (double)k : (double)k / scale;
+	}
+
+	// the tail, too close to the end for a full load
+	for (; v < count; v++, bit += width)
+	{
+		uint64_t word = 0;
+		size_t first = (size_t)(bit / 8);
+		for (size_t i = 0; i < 8; i++)
+			word = (word << 8) | (first + i < size ? bytes[first + i] : 0);
+		int64_t k = (int64_t)(lo + ((word >> (64 - width - bit % 8)) & mask));
+		coords[v * stride] = digits == 0 ? (double)k : (double)k / scale;
+	}
+
+	return true;
+}
+
+inline bool decodeRaw(uint8_t const* bytes, size_t size, size_t count, size_t stride, double* coords)
+{
+	if (size != count * sizeof(double))
+		return false;
+	for (size_t v = 0; v < count; v++)
+		memcpy(coords + v * stride, bytes + v * sizeof(double), sizeof(double));
+	return true;
+}
+
+inline bool decodeXor(uint8_t const* bytes, size_t size, size_t count, size_t stride, double* coords)
+{
+	BitReader reader(bytes, size);
+	uint64_t prev = reader.read(64);
+	unsigned lead = 0;
+	unsigned trail = 0;
+	coords[0] = bitsDouble(prev);
+
+	for (size_t v = 1; v < count; v++)
+	{
+		if (reader.read(1) != 0)
+		{
+			if (reader.read(1) != 0)
+			{
+				lead = (unsigned)reader.read(6);
+				unsigned len = (unsigned)reader.read(6) + 1;
+				if (lead + len > 64)
+					return false;
+				trail = 64 - lead - len;
+			}
+			prev ^= reader.read(64 - lead - trail) << trail;
+		}
+		coords[v * stride] = bitsDouble(prev);
+	}
+
+	return !reader.overrun();
+}
+
+// Smallest possible encoding of a column: segment length and mode
+static const size_t MIN_SEGMENT_SIZE = 5;
+
+// Decodes count vectors into coords, false if the bytes are malformed
+inline bool decodeBlock(uint8_t const* bytes, size_t size, size_t count, size_t dim, double* coords)
+{
+	if (count == 0)
+		return true;
+
+	uint8_t const* end = bytes + size;
+	for (size_t d = 0; d < dim; d++)
+	{
+		if ((size_t)(end - bytes) < MIN_SEGMENT_SIZE)
+			return false;
+
+		uint32_t length = 0;
+		for (unsigned i = 0; i < 4; i++)
+			length |= (uint32_t)bytes[i] << (8 * i);
+		bytes += 4;
+		if (length == 0 || length > (size_t)(end - bytes))
+			return false;
+
+		COLUMN_MODE mode = (COLUMN_MODE)bytes[0];
+		bool ok = false;
+		if (mode == COLUMN_MODE::DECIMAL)
+			ok = decodeDecimal(bytes + 1, length - 1, count, dim, coords + d);
+		else if (mode == COLUMN_MODE::XOR)
+			ok = decodeXor(bytes + 1, length - 1, count, dim, coords + d);
+		else if (mode == COLUMN_MODE::RAW)
+			ok = decodeRaw(bytes + 1, length - 1, count, dim, coords + d);
+		if (!ok)
+			return false;
+		bytes += length;
+	}
+
+	return true;
+}
@@ -1,40 +1,43 @@
 #include "ISet.h"
 #include "SetImpl.cpp"
+#include "numeric/SetSnapshot.h"
+#include "numeric/LogLevel.h"
 #include <string>
 
-RESULT_CODE validateData(ISet const* pOperand1, ISet const* pOperand2, double tolerance, std::string fun, ILogger* logger)
+// Nothing is formatted or logged on success
+RESULT_CODE validateData(ISet const* pOperand1, ISet const* pOperand2, double tolerance, char const* fun, ILogger* logger)
 {
 	RESULT_CODE code = RESULT_CODE::SUCCESS;
-	std::string msg;
+	char const* msg = nullptr;
 
 	if (pOperand1 == nullptr)
 	{
-		msg = "In " + fun + " pOperand1 is nullptr";
+		msg = " pOperand1 is nullptr";
 		code = RESULT_CODE::WRONG_ARGUMENT;
 	}
 	else if (pOperand2 == nullptr)
 	{
-		msg = "In " + fun + " pOperand2 is nullptr";
+		msg = " pOperand2 is nullptr";
 		code = RESULT_CODE::WRONG_ARGUMENT;
 	}
 	else if (pOperand1->getDim() == 0)
 	{
-		msg = "In " + fun + " pOperand1 dim = 0";
+		msg = " pOperand1 dim = 0";
 		code = RESULT_CODE::WRONG_DIM;
 	}
 	else if (pOperand2->getDim() == 0)
 	{
-		msg = "In " + fun + " pOperand2 dim = 0";
+		msg = " pOperand2 dim = 0";
 		code = RESULT_CODE::WRONG_DIM;
 	}
 	else if (pOperand1->getDim() != pOperand2->getDim())
 	{
-		msg = "In " + fun + " pOperand1 dim is not equal pOperand2 dim";
+		msg = " pOperand1 dim is not equal pOperand2 dim";
 		code = RESULT_CODE::WRONG_DIM;
 	}
 
-	if (logger != nullptr)
-		logger->log(msg.c_str(), code);
+	if (code != RESULT_CODE::SUCCESS)
+		UI_LOG_FAILURE(logger, (std::string("In ") + fun + msg).c_str(), code);
 	return code;
 }
 
@@ -48,6 +51,16 @@ ISet* ISet::createSet(ILogger* pLogger)
 	return res;
 }
 
+OrderedSet* OrderedSet::createSet(LAYOUT layout, ILogger* pLogger)
+{
+	OrderedSet* res = new (std::nothrow) SetImpl(layout);
+	if (res == nullptr)
+		if (pLogger != nullptr)
+			pLogger->log("In [OrderedSet::createSet] not enough memory for [OrderedSet* res]", RESULT_CODE::OUT_OF_MEMORY);
+
+	return res;
+}
+
 ISet* ISet::add(ISet const* pOperand1, ISet const* pOperand2, IVector::NORM norm, double tolerance, ILogger* pLogger)
 {
 	RESULT_CODE code = validateData(pOperand1, pOperand2, tolerance, "[ISet::add]", pLogger);
@@ -56,8 +69,21 @@ ISet* ISet::add(ISet const* pOperand1, ISet const* pOperand2, IVector::NORM norm
 
 	ISet* res = pOperand1->clone();
 	if (res == nullptr)
+	{
 		if (pLogger != nullptr)
 			pLogger->log("In [ISet:add] not enough memory for [ISet* res]", RESULT_CODE::OUT_OF_MEMORY);
+		return nullptr;
+	}
+
+	SetImpl* fastRes = dynamic_cast<SetImpl*>(res);
+	SetImpl const* fastOperand = dynamic_cast<SetImpl const*>(pOperand2);
+	if (fastRes != nullptr && fastOperand != nullptr)
+	{
+		size_t size = fastOperand->getSize();
+		for (size_t slot = 0; slot < size; slot++)
+			fastRes->insert(fastOperand->slot(slot), fastOperand->getDim(), norm, tolerance);
+		return res;
+	}
 
 	size_t size = pOperand2->getSize();
 	for (size_t indx = 0; indx < size; indx++)
@@ -78,10 +104,30 @@ ISet* ISet::intersect(ISet const* pOperand1, ISet const* pOperand2, IVector::NOR
 	if (code != RESULT_CODE::SUCCESS)
 		return nullptr;
 
-	ISet* res = ISet::createSet(pLogger);
+	// The result takes the layout of the first operand, its inserts are searched the same way
+	SetImpl const* fastOperand1 = dynamic_cast<SetImpl const*>(pOperand1);
+	SetImpl const* fastOperand2 = dynamic_cast<SetImpl const*>(pOperand2);
+	ISet* res = fastOperand1 != nullptr ? OrderedSet::createSet(fastOperand1->getLayout(), pLogger) : ISet::createSet(pLogger);
 	if (res == nullptr)
+	{
 		if (pLogger != nullptr)
 			pLogger->log("In [ISet:intersect] not enough memory for [ISet* res]", RESULT_CODE::OUT_OF_MEMORY);
+		return nullptr;
+	}
+
+	SetImpl* fastRes = dynamic_cast<SetImpl*>(res);
+	if (fastOperand1 != nullptr && fastOperand2 != nullptr)
+	{
+		size_t dim = fastOperand1->getDim();
+		size_t size = fastOperand1->getSize();
+		for (size_t slot = 0; slot < size; slot++)
+		{
+			size_t found;
+			if (fastOperand2->findSlot(fastOperand1->slot(slot), norm, tolerance, found))
+				fastRes->insert(fastOperand2->slot(found), dim, norm, tolerance);
+		}
+		return res;
+	}
 
 	size_t size = pOperand1->getSize();
 	for (size_t indx = 0; indx < size; indx++)
@@ -111,8 +157,21 @@ ISet* ISet::sub(ISet const* pOperand1, ISet const* pOperand2, IVector::NORM norm
 
 	ISet* res = pOperand1->clone();
 	if (res == nullptr)
+	{
 		if (pLogger != nullptr)
 			pLogger->log("In [ISet:sub] not enough memory for [ISet* res]", RESULT_CODE::OUT_OF_MEMORY);
+		return nullptr;
+	}
+
+	SetImpl* fastRes = dynamic_cast<SetImpl*>(res);
+	SetImpl const* fastOperand = dynamic_cast<SetImpl const*>(pOperand2);
+	if (fastRes != nullptr && fastOperand != nullptr)
+	{
+		size_t size = fastOperand->getSize();
+		for (size_t slot = 0; slot < size && fastRes->getSize() > 0; slot++)
+			fastRes->erase(fastOperand->slot(slot), fastOperand->getDim(), norm, tolerance);
+		return res;
+	}
 
 	size_t size = pOperand2->getSize();
 	for (size_t indx = 0; indx < size; indx++)
@@ -165,3 +224,146 @@ ISet* ISet::symSub(ISet const* pOperand1, ISet const* pOperand2, IVector::NORM n
 
 ISet::~ISet()
 {}
+
+RESULT_CODE SetSnapshot::save(ISet const* pSet, char const* pFileName, ILogger* pLogger)
+{
+	if (pSet == nullptr || pFileName == nullptr)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [SetSnapshot::save] pSet or pFileName is nullptr", RESULT_CODE::BAD_REFERENCE);
+		return RESULT_CODE::BAD_REFERENCE;
+	}
+
+	RESULT_CODE code = RESULT_CODE::SUCCESS;
+	SetImpl const* impl = dynamic_cast<SetImpl const*>(pSet);
+	if (impl != nullptr)
+		code = impl->save(pFileName);
+	else
+	{
+		SnapshotWriter writer;
+		code = writer.open(pFileName, pSet->getDim(), 0);
+		size_t size = pSet->getSize();
+		std::vector<double> coords(pSet->getDim());
+		for (size_t indx = 0; indx < size && code == RESULT_CODE::SUCCESS; indx++)
+		{
+			IVector* vec = nullptr;
+			code = pSet->get(vec, indx);
+			if (code != RESULT_CODE::SUCCESS)
+				break;
+			for (size_t i = 0; i < coords.size(); i++)
+				coords[i] = vec->getCoord(i);
+			delete vec;
+			code = writer.append(coords.data(), 1);
+		}
+		if (code == RESULT_CODE::SUCCESS)
+			code = writer.finish(nullptr, 0);
+	}
+
+	if (code != RESULT_CODE::SUCCESS && pLogger != nullptr)
+		pLogger->log("In [SetSnapshot::save] failed to write the snapshot", code);
+	return code;
+}
+
+RESULT_CODE SetSnapshot::saveCompressed(ISet const* pSet, char const* pFileName, size_t blockSize, ILogger* pLogger)
+{
+	if (pSet == nullptr || pFileName == nullptr)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [SetSnapshot::saveCompressed] pSet or pFileName is nullptr", RESULT_CODE::BAD_REFERENCE);
+		return RESULT_CODE::BAD_REFERENCE;
+	}
+
+	if (blockSize == 0 || blockSize > SnapshotBlockTable::MAX_BLOCK_SIZE)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [SetSnapshot::saveCompressed] blockSize should be in [1, 65536]", RESULT_CODE::WRONG_ARGUMENT);
+		return RESULT_CODE::WRONG_ARGUMENT;
+	}
+
+	if (pSet->getSize() == 0)
+		return save(pSet, pFileName, pLogger);
+
+	RESULT_CODE code = RESULT_CODE::SUCCESS;
+	SetImpl const* impl = dynamic_cast<SetImpl const*>(pSet);
+	if (impl != nullptr)
+		code = impl->saveCompressed(pFileName, blockSize);
+	else
+	{
+		size_t dim = pSet->getDim();
+		size_t size = pSet->getSize();
+		std::vector<double> coords(size * dim);
+		for (size_t indx = 0; indx < size && code == RESULT_CODE::SUCCESS; indx++)
+		{
+			IVector* vec = nullptr;
+			code = pSet->get(vec, indx);
+			if (code != RESULT_CODE::SUCCESS)
+				break;
+			for (size_t i = 0; i < dim; i++)
+				coords[indx * dim + i] = vec->getCoord(i);
+			delete vec;
+		}
+		if (code == RESULT_CODE::SUCCESS)
+			code = SetImpl::saveCompressed(coords.data(), size, dim, pFileName, blockSize);
+	}
+
+	if (code != RESULT_CODE::SUCCESS && pLogger != nullptr)
+		pLogger->log("In [SetSnapshot::saveCompressed] failed to write the snapshot", code);
+	return code;
+}
+
+ISet* SetSnapshot::loadMapped(char const* pFileName, ILogger* pLogger)
+{
+	if (pFileName == nullptr)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [SetSnapshot::loadMapped] pFileName is nullptr", RESULT_CODE::BAD_REFERENCE);
+		return nullptr;
+	}
+
+	RESULT_CODE code;
+	ISet* res = SetImpl::loadMapped(pFileName, code);
+	if (res == nullptr && pLogger != nullptr)
+		pLogger->log("In [SetSnapshot::loadMapped] file is missing or not a valid snapshot", code);
+
+	return res;
+}
+
+RESULT_CODE SetSnapshot::save(IVector const* pVector, char const* pFileName, ILogger* pLogger)
+{
+	if (pVector == nullptr || pFileName == nullptr)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [SetSnapshot::save] pVector or pFileName is nullptr", RESULT_CODE::BAD_REFERENCE);
+		return RESULT_CODE::BAD_REFERENCE;
+	}
+
+	std::vector<double> coords(pVector->getDim());
+	for (size_t i = 0; i < coords.size(); i++)
+		coords[i] = pVector->getCoord(i);
+
+	SnapshotWriter writer;
+	RESULT_CODE code = writer.open(pFileName, coords.size(), 0);
+	if (code == RESULT_CODE::SUCCESS)
+		code = writer.append(coords.data(), 1);
+	if (code == RESULT_CODE::SUCCESS)
+		code = writer.finish(nullptr, 0);
+
+	if (code != RESULT_CODE::SUCCESS && pLogger != nullptr)
+		pLogger->log("In [SetSnapshot::save] failed to write the snapshot", code);
+	return code;
+}
+
+IVector* SetSnapshot::loadVector(char const* pFileName, ILogger* pLogger)
+{
+	ISet* set = loadMapped(pFileName, pLogger);
+	if (set == nullptr)
+		return nullptr;
+
+	IVector* res = nullptr;
+	if (set->getSize() != 1 || set->get(res, 0) != RESULT_CODE::SUCCESS)
+		if (pLogger != nullptr)
+			pLogger->log("In [SetSnapshot::loadVector] snapshot doesn't hold exactly one vector", RESULT_CODE::FILE_ERROR);
+
+	delete set;
+	return res;
+}
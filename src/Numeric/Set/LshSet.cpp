@@ -0,0 +1,26 @@
+#include "numeric/LshSet.h"
+#include "LshSetImpl.cpp"
+
+LshSet* LshSet::createSet(Params const& params, ILogger* pLogger)
+{
+	if (params.tables == 0 || params.hashesPerTable == 0)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [LshSet::createSet] tables and hashesPerTable should be positive", RESULT_CODE::WRONG_ARGUMENT);
+		return nullptr;
+	}
+
+	if (!(params.bucketWidth > 0))
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [LshSet::createSet] bucketWidth should be positive", RESULT_CODE::WRONG_ARGUMENT);
+		return nullptr;
+	}
+
+	LshSet* res = new (std::nothrow) LshSetImpl(params);
+	if (res == nullptr)
+		if (pLogger != nullptr)
+			pLogger->log("In [LshSet::createSet] not enough memory for [LshSet* res]", RESULT_CODE::OUT_OF_MEMORY);
+
+	return res;
+}
@@ -0,0 +1,400 @@
+#include "numeric/LshSet.h"
+#include "Distance.h"
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+namespace
+{
+	class LshSetImpl : public LshSet
+	{
+	private:
+		typedef std::unordered_map<uint64_t, std::vector<size_t>> Table;
+
+		static constexpr double CELL_LIMIT = 0x1p62;  // cells past it are merged, the cast to int64_t stays defined
+
+		Params params_;
+		size_t dim_;
+		std::vector<double> data_;       // coordinates, dim_ per element
+		std::vector<uint64_t> keys_;     // bucket key per element and table
+		std::vector<double> proj_;       // tables * hashesPerTable projections of dim_
+		std::vector<double> offset_;     // tables * hashesPerTable shifts in [0, w)
+		std::vector<Table> tables_;
+		mutable std::vector<uint32_t> seen_;
+		mutable uint32_t epoch_;
+		ILogger* logger_;
+
+		void initProjections();
+		void hash(double const* coords, std::vector<int64_t>& cells, std::vector<double>& frac) const;
+		static uint64_t bucketKey(int64_t const* cells, size_t count);
+		void candidates(double const* coords, std::vector<size_t>& res) const;
+		bool find(double const* coords, IVector::NORM norm, double tolerance, size_t& index) const;
+		void unlink(size_t index);
+		void link(size_t index);
+		bool toCoords(IVector const* pVector, std::vector<double>& coords) const;
+
+	public:
+		LshSetImpl(Params const& params);
+		~LshSetImpl() override;
+
+		RESULT_CODE insert(const IVector* pVector, IVector::NORM norm, double tolerance) override;
+
+		RESULT_CODE get(IVector*& pVector, size_t index) const override;
+		RESULT_CODE get(IVector*& pVector, IVector const* pSample, IVector::NORM norm, double tolerance) const override;
+		size_t getDim() const override;
+		size_t getSize() const override;
+
+		void clear() override;
+		RESULT_CODE erase(size_t index) override;
+		RESULT_CODE erase(IVector const* pSample, IVector::NORM norm, double tolerance) override;
+
+		ISet* clone() const override;
+		Params getParams() const override;
+	};
+
+	LshSetImpl::LshSetImpl(Params const& params)
+		: params_(params), dim_(0), tables_(params.tables), epoch_(0)
+	{
+		if (params_.probes > params_.hashesPerTable)
+			params_.probes = params_.hashesPerTable;
+		logger_ = ILogger::createLogger(this);
+	}
+
+	LshSetImpl::~LshSetImpl()
+	{
+		logger_->destroyLogger(this);
+	}
+
+	void LshSetImpl::initProjections()
+	{
+		size_t count = params_.tables * params_.hashesPerTable;
+		std::mt19937_64 gen(params_.seed);
+		std::normal_distribution<double> normal(0.0, 1.0);
+		std::uniform_real_distribution<double> uniform(0.0, params_.bucketWidth);
+
+		proj_.resize(count * dim_);
+		for (double& p : proj_)
+			p = normal(gen);
+
+		offset_.resize(count);
+		for (double& b : offset_)
+			b = uniform(gen);
+	}
+
+	// h(v) = floor((a.v + b) / w) for each hash of each table, frac keeps the position inside the cell
+	void LshSetImpl::hash(double const* coords, std::vector<int64_t>& cells, std::vector<double>& frac) const
+	{
+		size_t count = params_.tables * params_.hashesPerTable;
+		cells.resize(count);
+		frac.resize(count);
+
+		for (size_t h = 0; h < count; h++)
+		{
+			double const* a = proj_.data() + h * dim_;
+			double dot = 0;
+			for (size_t i = 0; i < dim_; i++)
+				dot += a[i] * coords[i];
+
+			double x = (dot + offset_[h]) / params_.bucketWidth;
+			x = std::isnan(x) ? 0 : std::min(std::max(x, -CELL_LIMIT), CELL_LIMIT);
+			double cell = floor(x);
+			cells[h] = (int64_t)cell;
+			frac[h] = x - cell;
+		}
+	}
+
+	uint64_t LshSetImpl::bucketKey(int64_t const* cells, size_t count)
+	{
+		uint64_t key = 14695981039346656037ull;
+		for (size_t i = 0; i < count; i++)
+		{
+			key ^= (uint64_t)cells[i];
+			key *= 1099511628211ull;
+			key ^= key >> 29;
+		}
+		return key;
+	}
+
+	void LshSetImpl::candidates(double const* coords, std::vector<size_t>& res) const
+	{
+		res.clear();
+		if (data_.empty())
+			return;
+
+		std::vector<int64_t> cells;
+		std::vector<double> frac;
+		hash(coords, cells, frac);
+
+		if (seen_.size() < getSize())
+			seen_.resize(getSize(), 0);
+		if (++epoch_ == 0)
+		{
+			std::fill(seen_.begin(), seen_.end(), 0);
+			epoch_ = 1;
+		}
+
+		size_t k = params_.hashesPerTable;
+		std::vector<size_t> order(k);
+		for (size_t t = 0; t < params_.tables; t++)
+		{
+			int64_t* cell = cells.data() + t * k;
+			double const* pos = frac.data() + t * k;
+
+			// Home bucket first, then single-step moves across the nearest cell borders
+			for (size_t p = 0; p <= params_.probes; p++)
+			{
+				size_t j = 0;
+				int64_t shift = 0;
+				if (p > 0)
+				{
+					if (p == 1)
+					{
+						for (size_t i = 0; i < k; i++)
+							order[i] = i;
+						std::sort(order.begin(), order.end(), [pos](size_t x, size_t y)
+						{
+							return std::min(pos[x], 1 - pos[x]) < std::min(pos[y], 1 - pos[y]);
+						});
+					}
+					j = order[p - 1];
+					shift = pos[j] < 0.5 ? -1 : 1;
+					cell[j] += shift;
+				}
+
+				auto bucket = tables_[t].find(bucketKey(cell, k));
+				if (p > 0)
+					cell[j] -= shift;
+				if (bucket == tables_[t].end())
+					continue;
+
+				for (size_t id : bucket->second)
+				{
+					if (seen_[id] == epoch_)
+						continue;
+					seen_[id] = epoch_;
+					res.push_back(id);
+				}
+			}
+		}
+	}
+
+	bool LshSetImpl::find(double const* coords, IVector::NORM norm, double tolerance, size_t& index) const
+	{
+		if (norm != IVector::NORM::NORM_2)
+		{
+			for (size_t id = 0; id < getSize(); id++)
+				if (isNear(data_.data() + id * dim_, coords, dim_, norm, tolerance))
+				{
+					index = id;
+					return true;
+				}
+			return false;
+		}
+
+		std::vector<size_t> ids;
+		candidates(coords, ids);
+		for (size_t id : ids)
+			if (isNear(data_.data() + id * dim_, coords, dim_, norm, tolerance))
+			{
+				index = id;
+				return true;
+			}
+
+		return false;
+	}
+
+	void LshSetImpl::link(size_t index)
+	{
+		std::vector<int64_t> cells;
+		std::vector<double> frac;
+		hash(data_.data() + index * dim_, cells, frac);
+
+		size_t k = params_.hashesPerTable;
+		keys_.resize(getSize() * params_.tables);
+		for (size_t t = 0; t < params_.tables; t++)
+		{
+			uint64_t key = bucketKey(cells.data() + t * k, k);
+			keys_[index * params_.tables + t] = key;
+			tables_[t][key].push_back(index);
+		}
+	}
+
+	void LshSetImpl::unlink(size_t index)
+	{
+		for (size_t t = 0; t < params_.tables; t++)
+		{
+			auto bucket = tables_[t].find(keys_[index * params_.tables + t]);
+			std::vector<size_t>& ids = bucket->second;
+			ids.erase(std::find(ids.begin(), ids.end(), index));
+			if (ids.empty())
+				tables_[t].erase(bucket);
+		}
+	}
+
+	// False if a coordinate isn't finite: such a vector has no bucket
+	bool LshSetImpl::toCoords(IVector const* pVector, std::vector<double>& coords) const
+	{
+		bool finite = true;
+		coords.resize(pVector->getDim());
+		for (size_t i = 0; i < coords.size(); i++)
+		{
+			coords[i] = pVector->getCoord(i);
+			finite = finite && std::isfinite(coords[i]);
+		}
+		return finite;
+	}
+
+	RESULT_CODE LshSetImpl::insert(const IVector* pVector, IVector::NORM norm, double tolerance)
+	{
+		if (pVector == nullptr || tolerance < 0)
+			return RESULT_CODE::WRONG_ARGUMENT;
+
+		if (data_.empty())
+		{
+			if (pVector->getDim() == 0)
+				return RESULT_CODE::WRONG_DIM;
+			if (dim_ != pVector->getDim())
+			{
+				dim_ = pVector->getDim();
+				initProjections();
+			}
+		}
+		else if (dim_ != pVector->getDim())
+			return RESULT_CODE::WRONG_DIM;
+
+		std::vector<double> coords;
+		if (!toCoords(pVector, coords))
+			return RESULT_CODE::NAN_VALUE;
+
+		size_t index;
+		if (find(coords.data(), norm, tolerance, index))
+			return RESULT_CODE::SUCCESS;
+
+		data_.insert(data_.end(), coords.begin(), coords.end());
+		link(getSize() - 1);
+
+		return RESULT_CODE::SUCCESS;
+	}
+
+	RESULT_CODE LshSetImpl::get(IVector*& pVector, size_t index) const
+	{
+		if (index >= getSize())
+		{
+			pVector = nullptr;
+			return RESULT_CODE::OUT_OF_BOUNDS;
+		}
+
+		pVector = IVector::createVector(dim_, const_cast<double*>(data_.data() + index * dim_), logger_);
+		if (pVector == nullptr)
+			return RESULT_CODE::OUT_OF_MEMORY;
+		return RESULT_CODE::SUCCESS;
+	}
+
+	RESULT_CODE LshSetImpl::get(IVector*& pVector, IVector const* pSample, IVector::NORM norm, double tolerance) const
+	{
+		pVector = nullptr;
+		if (pSample == nullptr || tolerance < 0)
+			return RESULT_CODE::WRONG_ARGUMENT;
+
+		if (pSample->getDim() != getDim())
+			return RESULT_CODE::WRONG_DIM;
+
+		std::vector<double> coords;
+		if (!toCoords(pSample, coords))
+			return RESULT_CODE::NAN_VALUE;
+
+		size_t index;
+		if (find(coords.data(), norm, tolerance, index))
+			return get(pVector, index);
+
+		return RESULT_CODE::SUCCESS;
+	}
+
+	size_t LshSetImpl::getDim() const
+	{
+		return data_.empty() ? 0 : dim_;
+	}
+
+	size_t LshSetImpl::getSize() const
+	{
+		return dim_ == 0 ? 0 : data_.size() / dim_;
+	}
+
+	void LshSetImpl::clear()
+	{
+		data_.clear();
+		keys_.clear();
+		for (Table& table : tables_)
+			table.clear();
+	}
+
+	// Last element takes the place of the erased one
+	RESULT_CODE LshSetImpl::erase(size_t index)
+	{
+		size_t size = getSize();
+		if (index >= size)
+			return RESULT_CODE::OUT_OF_BOUNDS;
+
+		unlink(index);
+		size_t last = size - 1;
+		if (index != last)
+		{
+			for (size_t t = 0; t < params_.tables; t++)
+			{
+				uint64_t key = keys_[last * params_.tables + t];
+				std::vector<size_t>& ids = tables_[t][key];
+				*std::find(ids.begin(), ids.end(), last) = index;
+				keys_[index * params_.tables + t] = key;
+			}
+			std::copy(data_.begin() + last * dim_, data_.end(), data_.begin() + index * dim_);
+		}
+		data_.resize(last * dim_);
+		keys_.resize(last * params_.tables);
+
+		return RESULT_CODE::SUCCESS;
+	}
+
+	RESULT_CODE LshSetImpl::erase(IVector const* pSample, IVector::NORM norm, double tolerance)
+	{
+		if (pSample == nullptr || tolerance < 0)
+			return RESULT_CODE::WRONG_ARGUMENT;
+
+		if (pSample->getDim() != getDim())
+			return RESULT_CODE::WRONG_DIM;
+
+		std::vector<double> coords;
+		if (!toCoords(pSample, coords))
+			return RESULT_CODE::NAN_VALUE;
+
+		size_t index;
+		while (find(coords.data(), norm, tolerance, index))
+			erase(index);
+
+		return RESULT_CODE::SUCCESS;
+	}
+
+	ISet* LshSetImpl::clone() const
+	{
+		LshSetImpl* res = new (std::nothrow) LshSetImpl(params_);
+
+		if (res != nullptr)
+		{
+			res->dim_ = dim_;
+			res->data_ = data_;
+			res->keys_ = keys_;
+			res->proj_ = proj_;
+			res->offset_ = offset_;
+			res->tables_ = tables_;
+		}
+
+		return res;
+	}
+
+	LshSet::Params LshSetImpl::getParams() const
+	{
+		return params_;
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <memory>
+#include <cstddef>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory mapping of a whole file, unmapped with the last owner
+class MappedFile
+{
+private:
+	void* data_ = nullptr;
+	size_t size_ = 0;
+#ifdef _WIN32
+	HANDLE file_ = INVALID_HANDLE_VALUE;
+	HANDLE mapping_ = nullptr;
+#else
+	int fd_ = -1;
+#endif
+
+	MappedFile() = default;
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+
+public:
+	static std::shared_ptr<MappedFile> open(char const* pFileName)
+	{
+		std::shared_ptr<MappedFile> res(new (std::nothrow) MappedFile());
+		if (res == nullptr || pFileName == nullptr)
+			return nullptr;
+
+#ifdef _WIN32
+		res->file_ = CreateFileA(pFileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (res->file_ == INVALID_HANDLE_VALUE)
+			return nullptr;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(res->file_, &size) || size.QuadPart == 0)
+			return nullptr;
+		res->size_ = (size_t)size.QuadPart;
+
+		res->mapping_ = CreateFileMappingA(res->file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (res->mapping_ == nullptr)
+			return nullptr;
+
+		res->data_ = MapViewOfFile(res->mapping_, FILE_MAP_READ, 0, 0, 0);
+		if (res->data_ == nullptr)
+			return nullptr;
+#else
+		res->fd_ = ::open(pFileName, O_RDONLY);
+		if (res->fd_ < 0)
+			return nullptr;
+
+		struct stat st;
+		if (fstat(res->fd_, &st) != 0 || st.st_size == 0)
+			return nullptr;
+		res->size_ = (size_t)st.st_size;
+
+		void* data = mmap(nullptr, res->size_, PROT_READ, MAP_SHARED, res->fd_, 0);
+		if (data == MAP_FAILED)
+			return nullptr;
+		res->data_ = data;
+#endif
+
+		return res;
+	}
+
+	void const* data() const
+	{
+		return data_;
+	}
+
+	size_t size() const
+	{
+		return size_;
+	}
+
+	~MappedFile()
+	{
+#ifdef _WIN32
+		if (data_ != nullptr)
+			UnmapViewOfFile(data_);
+		if (mapping_ != nullptr)
+			CloseHandle(mapping_);
+		if (file_ != INVALID_HANDLE_VALUE)
+			CloseHandle(file_);
+#else
+		if (data_ != nullptr)
+			munmap(data_, size_);
+		if (fd_ >= 0)
+			close(fd_);
+#endif
+	}
+};
@@ -0,0 +1,135 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+// Z-order curve over the bounding box of a group of vectors: coordinates are quantized
+// inside the box and their bits interleaved. Up to 64 leading dimensions take part in
+// the key, the rest only break ties. A key never decreases when a coordinate grows, so
+// every vector inside a box has a key between the keys of the box corners.
+class MortonGrid
+{
+private:
+	static constexpr size_t MAX_DIMS = 64;
+
+	size_t dims_ = 0;
+	unsigned bits_ = 0;
+	double cells_ = 0;
+	std::vector<double> lo_;
+	std::vector<double> hi_;
+	bool finite_ = false;
+
+	// Monotone in x, clamped to the box
+	uint64_t cell(size_t d, double x) const
+	{
+		if (!(hi_[d] > lo_[d]) || !(x > lo_[d]))
+			return 0;
+		if (x >= hi_[d])
+			return (uint64_t)cells_;
+		return (uint64_t)((x - lo_[d]) / (hi_[d] - lo_[d]) * cells_);
+	}
+
+	uint64_t interleave(uint64_t const* q) const
+	{
+		uint64_t key = 0;
+		for (unsigned b = bits_; b-- > 0;)
+			for (size_t d = 0; d < dims_; d++)
+				key = (key << 1) | ((q[d] >> b) & 1);
+		return key;
+	}
+
+public:
+	void fit(double const* coords, size_t count, size_t dim)
+	{
+		dims_ = std::min(dim, MAX_DIMS);
+		bits_ = dims_ == 0 ? 0 : (unsigned)std::min((size_t)32, 64 / dims_);
+		cells_ = (double)((1ull << bits_) - 1);
+		lo_.assign(dims_, 0.0);
+		hi_.assign(dims_, 0.0);
+		finite_ = count != 0 && dims_ != 0;
+		if (!finite_)
+			return;
+
+		std::copy(coords, coords + dims_, lo_.begin());
+		std::copy(coords, coords + dims_, hi_.begin());
+		for (size_t s = 0; s < count; s++)
+			for (size_t d = 0; d < dims_; d++)
+			{
+				double x = coords[s * dim + d];
+				finite_ = finite_ && std::isfinite(x);
+				lo_[d] = std::min(lo_[d], x);
+				hi_[d] = std::max(hi_[d], x);
+			}
+		for (size_t d = 0; d < dims_; d++)
+			finite_ = finite_ && std::isfinite(hi_[d] - lo_[d]);
+
+		// Without a finite box (or one too wide for a double) every key is 0, the order is the input order
+		if (!finite_)
+			hi_ = lo_;
+	}
+
+	// False if the fitted vectors had a coordinate that isn't finite: keys can't be used for search
+	bool isValid() const
+	{
+		return finite_;
+	}
+
+	uint64_t key(double const* vec) const
+	{
+		uint64_t q[MAX_DIMS];
+		for (size_t d = 0; d < dims_; d++)
+			q[d] = cell(d, vec[d]);
+		return interleave(q);
+	}
+
+	// Keys of all vectors with |x - center| <= radius in every coordinate lie in [first, last].
+	// The box is widened by a few ulps so that rounding in a distance computed by the caller
+	// can't leave a near vector out. False if the box isn't a box (NaN bounds).
+	bool keyRange(double const* center, double radius, uint64_t& first, uint64_t& last) const
+	{
+		uint64_t lo[MAX_DIMS], hi[MAX_DIMS];
+		for (size_t d = 0; d < dims_; d++)
+		{
+			double r = radius * (1 + 1e-9) + std::fabs(center[d]) * 1e-15;
+			double a = center[d] - r, b = center[d] + r;
+			if (std::isnan(a) || std::isnan(b))
+				return false;
+			lo[d] = cell(d, a);
+			hi[d] = cell(d, b);
+		}
+		first = interleave(lo);
+		last = interleave(hi);
+		return true;
+	}
+
+	// Fits the grid to the vectors and sorts them along the curve: order[s] is the vector at
+	// position s, keys[s] its key
+	void sort(double const* coords, size_t count, size_t dim, std::vector<size_t>& order, std::vector<uint64_t>& keys)
+	{
+		fit(coords, count, dim);
+
+		std::vector<std::pair<uint64_t, size_t>> pairs(count);
+		for (size_t s = 0; s < count; s++)
+			pairs[s] = std::make_pair(key(coords + s * dim), s);
+		std::sort(pairs.begin(), pairs.end());
+
+		order.resize(count);
+		keys.resize(count);
+		for (size_t s = 0; s < count; s++)
+		{
+			keys[s] = pairs[s].first;
+			order[s] = pairs[s].second;
+		}
+	}
+};
+
+// Order of count vectors along the Z-order curve over their bounding box
+inline void mortonOrder(double const* coords, size_t count, size_t dim, std::vector<size_t>& order)
+{
+	MortonGrid grid;
+	std::vector<uint64_t> keys;
+	grid.sort(coords, count, dim, order, keys);
+}
@@ -1,22 +1,65 @@
 #include "ISet.h"
+#include "numeric/OrderedSet.h"
+#include "Distance.h"
+#include "MappedFile.h"
+#include "Morton.h"
+#include "SnapshotFormat.h"
 #include <vector>
+#include <memory>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
 
 namespace
 {
-	class SetImpl : public ISet
+	class SetImpl : public OrderedSet
 	{
 	private:
+		static const size_t MIN_PENDING = 64;
+
+		LAYOUT layout_;
 		size_t dim_;
-		std::vector<IVector*> data_;
+		size_t size_;
+		std::vector<double> data_;      // coordinates in storage order, dim_ per slot
+		std::shared_ptr<MappedFile> mapping_;
+		double const* mapped_;          // used instead of data_ while the snapshot is unchanged
+		std::vector<size_t> slotOf_;    // index -> slot, MORTON only
+		std::vector<size_t> indexOf_;   // slot -> index, MORTON only
+		size_t sorted_;                 // slots [0, sorted_) are in curve order
+		MortonGrid grid_;               // curve of the last reorder(), MORTON only
+		std::vector<uint64_t> keys_;    // curve keys of slots [0, sorted_)
 		ILogger* logger_;
-		
+
+		double const* coords() const;
+		void detach();
+		void compact(std::vector<bool> const& removed);
+		void range(double const* coords, double tolerance, size_t& first, size_t& last) const;
+
+		// Calls found(slot) for the slots near coords in storage order, until it returns true
+		template<typename F>
+		bool scan(double const* coords, IVector::NORM norm, double tolerance, F found) const
+		{
+			size_t first, last;
+			range(coords, tolerance, first, last);
+			double const* base = this->coords();
+			for (size_t s = first; s < last; s++)
+				if (isNear(base + s * dim_, coords, dim_, norm, tolerance) && found(s))
+					return true;
+			for (size_t s = sorted_; s < size_; s++)
+				if (isNear(base + s * dim_, coords, dim_, norm, tolerance) && found(s))
+					return true;
+			return false;
+		}
+		void rekey();
+		static void toCoords(IVector const* pVector, std::vector<double>& coords);
+
 	public:
-		SetImpl();
+		SetImpl(LAYOUT layout = LAYOUT::INSERTION);
 		~SetImpl() override;
 
 		RESULT_CODE insert(const IVector* pVector, IVector::NORM norm, double tolerance) override;
 
-		RESULT_CODE get(IVector*& pVector, size_t index) const override; 
+		RESULT_CODE get(IVector*& pVector, size_t index) const override;
 		RESULT_CODE get(IVector*& pVector, IVector const* pSample, IVector::NORM norm, double tolerance) const override;
 		size_t getDim() const override;
 		size_t getSize() const override;
@@ -26,10 +69,27 @@ namespace
 		RESULT_CODE erase(IVector const* pSample, IVector::NORM norm, double tolerance) override;
 
 		ISet* clone() const override;
+
+		LAYOUT getLayout() const override;
+		void reorder() override;
+		size_t getSlot(size_t index) const override;
+		RESULT_CODE findAll(IVector const* pSample, IVector::NORM norm, double tolerance, std::vector<size_t>& indices) const override;
+
+		// Direct access to storage, slots are walked in memory order
+		double const* slot(size_t slot) const;
+		bool findSlot(double const* coords, IVector::NORM norm, double tolerance, size_t& slot) const;
+		RESULT_CODE insert(double const* coords, size_t dim, IVector::NORM norm, double tolerance);
+		RESULT_CODE erase(double const* coords, size_t dim, IVector::NORM norm, double tolerance);
+
+		RESULT_CODE save(char const* pFileName) const;
+		static SetImpl* loadMapped(char const* pFileName, RESULT_CODE& code);
+		RESULT_CODE saveCompressed(char const* pFileName, size_t blockSize) const;
+		static RESULT_CODE saveCompressed(double const* coords, size_t count, size_t dim, char const* pFileName, size_t blockSize);
+		static SetImpl* loadCompressed(SnapshotHeader const& header, char const* base, RESULT_CODE& code);
 	};
 
-	SetImpl::SetImpl()
-		: dim_(0)
+	SetImpl::SetImpl(LAYOUT layout)
+		: layout_(layout), dim_(0), size_(0), mapped_(nullptr), sorted_(0)
 	{
 		logger_ = ILogger::createLogger(this);
 	}
@@ -39,54 +99,109 @@ namespace
 		clear();
 		logger_->destroyLogger(this);
 	}
-	
-	RESULT_CODE SetImpl::insert(const IVector* pVector, IVector::NORM norm, double tolerance)
+
+	void SetImpl::toCoords(IVector const* pVector, std::vector<double>& coords)
 	{
-		if (pVector == nullptr || tolerance < 0)
-			return RESULT_CODE::WRONG_ARGUMENT;
+		coords.resize(pVector->getDim());
+		for (size_t i = 0; i < coords.size(); i++)
+			coords[i] = pVector->getCoord(i);
+	}
 
-		if (data_.empty()) {
-			IVector* clone = pVector->clone();
-			if (clone == nullptr)
-				return RESULT_CODE::OUT_OF_MEMORY;
-			dim_ = pVector->getDim();
-			data_.push_back(clone);
-			return RESULT_CODE::SUCCESS;
-		}
+	double const* SetImpl::coords() const
+	{
+		return mapped_ != nullptr ? mapped_ : data_.data();
+	}
+
+	// Copy-on-write: the first change moves mapped coordinates to owned storage
+	void SetImpl::detach()
+	{
+		if (mapped_ == nullptr)
+			return;
+
+		data_.assign(mapped_, mapped_ + size_ * dim_);
+		mapped_ = nullptr;
+		mapping_.reset();
+	}
+
+	double const* SetImpl::slot(size_t slot) const
+	{
+		return coords() + slot * dim_;
+	}
+
+	// Slots [first, last) of the sorted part that can hold a vector near coords: those with
+	// curve keys between the corners of the tolerance box. The unsorted tail [sorted_, size_)
+	// is always searched.
+	void SetImpl::range(double const* coords, double tolerance, size_t& first, size_t& last) const
+	{
+		first = 0;
+		last = sorted_;
+		uint64_t lo, hi;
+		if (sorted_ == 0 || !grid_.isValid() || !grid_.keyRange(coords, tolerance, lo, hi))
+			return;
+
+		first = std::lower_bound(keys_.begin(), keys_.end(), lo) - keys_.begin();
+		last = std::upper_bound(keys_.begin() + first, keys_.end(), hi) - keys_.begin();
+	}
+
+	bool SetImpl::findSlot(double const* coords, IVector::NORM norm, double tolerance, size_t& slot) const
+	{
+		return scan(coords, norm, tolerance, [&](size_t s) { slot = s; return true; });
+	}
 
-		if (dim_ != pVector->getDim())
+	RESULT_CODE SetImpl::insert(double const* coords, size_t dim, IVector::NORM norm, double tolerance)
+	{
+		if (tolerance < 0)
+			return RESULT_CODE::WRONG_ARGUMENT;
+
+		if (dim == 0)
 			return RESULT_CODE::WRONG_DIM;
 
-		for (IVector* vec : data_)
+		if (size_ == 0)
+			dim_ = dim;
+		else if (dim_ != dim)
+			return RESULT_CODE::WRONG_DIM;
+		else
 		{
-			IVector* diff = IVector::sub(vec, pVector, logger_);
-			if (diff == nullptr)
-				return RESULT_CODE::CALCULATION_ERROR;
-			if (diff->norm(norm) < tolerance)
-			{
-				delete diff;
+			size_t found;
+			if (findSlot(coords, norm, tolerance, found))
 				return RESULT_CODE::SUCCESS;
-			}
-			delete diff;
 		}
-		
-		IVector* clone = pVector->clone();
-		if (clone == nullptr)
-			return RESULT_CODE::OUT_OF_MEMORY;
-		data_.push_back(clone);
+
+		detach();
+		size_t size = size_++;
+		data_.insert(data_.end(), coords, coords + dim);
+		if (layout_ == LAYOUT::MORTON)
+		{
+			slotOf_.push_back(size);
+			indexOf_.push_back(size);
+			size_t pending = size + 1 - sorted_;
+			if (pending > MIN_PENDING && pending > sorted_ / 8)
+				reorder();
+		}
 
 		return RESULT_CODE::SUCCESS;
 	}
 
+	RESULT_CODE SetImpl::insert(const IVector* pVector, IVector::NORM norm, double tolerance)
+	{
+		if (pVector == nullptr || tolerance < 0)
+			return RESULT_CODE::WRONG_ARGUMENT;
+
+		std::vector<double> coords;
+		toCoords(pVector, coords);
+		return insert(coords.data(), coords.size(), norm, tolerance);
+	}
+
 	RESULT_CODE SetImpl::get(IVector*& pVector, size_t index) const
 	{
-		if (index > data_.size())
+		if (index >= getSize())
 		{
 			pVector = nullptr;
 			return RESULT_CODE::OUT_OF_BOUNDS;
 		}
 
-		pVector = data_[index]->clone();
+		size_t s = layout_ == LAYOUT::MORTON ? slotOf_[index] : index;
+		pVector = IVector::createVector(dim_, const_cast<double*>(slot(s)), logger_);
 		if (pVector == nullptr)
 			return RESULT_CODE::OUT_OF_MEMORY;
 		return RESULT_CODE::SUCCESS;
@@ -94,32 +209,22 @@ namespace
 
 	RESULT_CODE SetImpl::get(IVector *& pVector, IVector const* pSample, IVector::NORM norm, double tolerance) const
 	{
+		pVector = nullptr;
 		if (pSample == nullptr || tolerance < 0)
-		{
-			pVector == nullptr;
 			return RESULT_CODE::WRONG_ARGUMENT;
-		}
 
 		if (pSample->getDim() != dim_)
-		{
-			pVector == nullptr;
 			return RESULT_CODE::WRONG_DIM;
-		}
 
-		for (IVector* vec : data_)
+		std::vector<double> coords;
+		toCoords(pSample, coords);
+
+		size_t found;
+		if (findSlot(coords.data(), norm, tolerance, found))
 		{
-			IVector* diff = IVector::sub(vec, pSample, logger_);
-			if (diff == nullptr)
-				return RESULT_CODE::CALCULATION_ERROR;
-			if (diff->norm(norm) < tolerance)
-			{
-				delete diff;
-				pVector = vec->clone();
-				if (pVector == nullptr)
-					return RESULT_CODE::OUT_OF_MEMORY;
-				return RESULT_CODE::SUCCESS;
-			}
-			delete diff;
+			pVector = IVector::createVector(dim_, const_cast<double*>(slot(found)), logger_);
+			if (pVector == nullptr)
+				return RESULT_CODE::OUT_OF_MEMORY;
 		}
 
 		return RESULT_CODE::SUCCESS;
@@ -132,29 +237,94 @@ namespace
 
 	size_t SetImpl::getSize() const
 	{
-		return data_.size();
+		return size_;
 	}
 
 	void SetImpl::clear()
 	{
-		for (IVector* vec : data_)
-		{
-			delete vec;
-		}
 		data_.clear();
+		mapping_.reset();
+		mapped_ = nullptr;
+		size_ = 0;
+		slotOf_.clear();
+		indexOf_.clear();
+		sorted_ = 0;
+		grid_ = MortonGrid();
+		keys_.clear();
 		dim_ = 0;
 	}
 
+	// Drops removed slots in one pass and renumbers the rest
+	void SetImpl::compact(std::vector<bool> const& removed)
+	{
+		detach();
+		size_t size = getSize();
+		std::vector<size_t> newSlot(size);
+		size_t kept = 0;
+		size_t sorted = 0;
+		for (size_t s = 0; s < size; s++)
+		{
+			if (removed[s])
+				continue;
+			if (s < sorted_)
+				keys_[sorted++] = keys_[s];
+			newSlot[s] = kept;
+			if (kept != s)
+				std::copy(data_.begin() + s * dim_, data_.begin() + (s + 1) * dim_, data_.begin() + kept * dim_);
+			kept++;
+		}
+		data_.resize(kept * dim_);
+		size_ = kept;
+
+		if (layout_ == LAYOUT::MORTON)
+		{
+			size_t index = 0;
+			for (size_t i = 0; i < size; i++)
+				if (!removed[slotOf_[i]])
+					slotOf_[index++] = newSlot[slotOf_[i]];
+			slotOf_.resize(kept);
+			indexOf_.resize(kept);
+			for (size_t i = 0; i < kept; i++)
+				indexOf_[slotOf_[i]] = i;
+			sorted_ = sorted;
+			keys_.resize(sorted);
+		}
+
+		if (size_ == 0)
+			clear();
+	}
+
 	RESULT_CODE SetImpl::erase(size_t index)
 	{
-		if (index >= data_.size())
+		if (index >= getSize())
 			return RESULT_CODE::OUT_OF_BOUNDS;
 
-		delete data_[index];
-		data_.erase(data_.begin() + index);
+		std::vector<bool> removed(getSize(), false);
+		removed[layout_ == LAYOUT::MORTON ? slotOf_[index] : index] = true;
+		compact(removed);
+
+		return RESULT_CODE::SUCCESS;
+	}
+
+	RESULT_CODE SetImpl::erase(double const* coords, size_t dim, IVector::NORM norm, double tolerance)
+	{
+		if (tolerance < 0)
+			return RESULT_CODE::WRONG_ARGUMENT;
+
+		if (dim != dim_)
+			return RESULT_CODE::WRONG_DIM;
+
+		std::vector<bool> removed;
+		scan(coords, norm, tolerance, [&](size_t s) {
+			if (removed.empty())
+				removed.resize(size_, false);
+			removed[s] = true;
+			return false;
+		});
+
+		if (!removed.empty())
+			compact(removed);
 
-		if (data_.empty())
-			dim_ = 0;
 		return RESULT_CODE::SUCCESS;
 	}
 
@@ -162,43 +332,268 @@ namespace
 	{
 		if (pSample == nullptr || tolerance < 0)
 			return RESULT_CODE::WRONG_ARGUMENT;
-		
+
+		std::vector<double> coords;
+		toCoords(pSample, coords);
+		return erase(coords.data(), coords.size(), norm, tolerance);
+	}
+
+	ISet* SetImpl::clone() const
+	{
+		SetImpl* res = new (std::nothrow) SetImpl(layout_);
+
+		if (res != nullptr)
+		{
+			res->dim_ = dim_;
+			res->size_ = size_;
+			res->data_ = data_;
+			res->mapping_ = mapping_;
+			res->mapped_ = mapped_;
+			res->slotOf_ = slotOf_;
+			res->indexOf_ = indexOf_;
+			res->sorted_ = sorted_;
+			res->grid_ = grid_;
+			res->keys_ = keys_;
+		}
+
+		return res;
+	}
+
+	OrderedSet::LAYOUT SetImpl::getLayout() const
+	{
+		return layout_;
+	}
+
+	size_t SetImpl::getSlot(size_t index) const
+	{
+		return layout_ == LAYOUT::MORTON ? slotOf_[index] : index;
+	}
+
+	RESULT_CODE SetImpl::findAll(IVector const* pSample, IVector::NORM norm, double tolerance, std::vector<size_t>& indices) const
+	{
+		indices.clear();
+		if (pSample == nullptr || tolerance < 0)
+			return RESULT_CODE::WRONG_ARGUMENT;
+
 		if (pSample->getDim() != dim_)
 			return RESULT_CODE::WRONG_DIM;
 
-		for (auto iter = data_.begin(); iter != data_.end();)
+		std::vector<double> coords;
+		toCoords(pSample, coords);
+		scan(coords.data(), norm, tolerance, [&](size_t s) {
+			indices.push_back(layout_ == LAYOUT::MORTON ? indexOf_[s] : s);
+			return false;
+		});
+		return RESULT_CODE::SUCCESS;
+	}
+
+	// Curve keys of a sorted snapshot, the grid is fitted again. Storage stays unsorted if
+	// the keys aren't in order, which happens when erases shrank the box before the save.
+	void SetImpl::rekey()
+	{
+		double const* base = coords();
+		grid_.fit(base, size_, dim_);
+		keys_.resize(size_);
+		for (size_t s = 0; s < size_; s++)
+			keys_[s] = grid_.key(base + s * dim_);
+
+		sorted_ = size_;
+		if (!std::is_sorted(keys_.begin(), keys_.end()))
 		{
-			IVector* diff = IVector::sub(*iter, pSample, logger_);
-			if (diff == nullptr)
-				return RESULT_CODE::CALCULATION_ERROR;
-			if (diff->norm(norm) < tolerance)
-			{
-				delete *iter;
-				iter = data_.erase(iter);
-			}
-			else
-				iter++;
+			sorted_ = 0;
+			keys_.clear();
+		}
+	}
+
+	void SetImpl::reorder()
+	{
+		size_t size = getSize();
+		if (layout_ != LAYOUT::MORTON || sorted_ == size)
+			return;
+
+		double const* base = coords();
+		std::vector<size_t> order;
+		grid_.sort(base, size, dim_, order, keys_);
 
-			delete diff;
+		std::vector<double> data(size * dim_);
+		std::vector<size_t> indexOf(size);
+		for (size_t s = 0; s < size; s++)
+		{
+			size_t old = order[s];
+			std::copy(base + old * dim_, base + (old + 1) * dim_, data.begin() + s * dim_);
+			indexOf[s] = indexOf_[old];
+			slotOf_[indexOf[s]] = s;
 		}
+		data_.swap(data);
+		mapped_ = nullptr;
+		mapping_.reset();
+		indexOf_.swap(indexOf);
+		sorted_ = size;
+	}
 
-		if (data_.empty())
-			dim_ = 0;
+	RESULT_CODE SetImpl::save(char const* pFileName) const
+	{
+		uint32_t flags = 0;
+		if (layout_ == LAYOUT::MORTON)
+			flags |= SnapshotHeader::LAYOUT_MORTON;
+		if (layout_ == LAYOUT::MORTON && sorted_ == size_)
+			flags |= SnapshotHeader::SORTED;
 
-		return RESULT_CODE::SUCCESS;
+		SnapshotWriter writer;
+		RESULT_CODE code = writer.open(pFileName, dim_, flags);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		code = writer.append(coords(), size_);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		if (layout_ != LAYOUT::MORTON)
+			return writer.finish(nullptr, 0);
+
+		std::vector<uint64_t> index(slotOf_.begin(), slotOf_.end());
+		return writer.finish(index.data(), index.size() * sizeof(uint64_t));
 	}
 
-	ISet* SetImpl::clone() const
+	RESULT_CODE SetImpl::saveCompressed(char const* pFileName, size_t blockSize) const
 	{
-		SetImpl* res = new SetImpl();
+		return saveCompressed(coords(), size_, dim_, pFileName, blockSize);
+	}
 
-		if (res != nullptr)
+	// Vectors are written in Morton order so neighbours in a block differ in few bits
+	RESULT_CODE SetImpl::saveCompressed(double const* coords, size_t count, size_t dim, char const* pFileName, size_t blockSize)
+	{
+		std::vector<size_t> order;
+		mortonOrder(coords, count, dim, order);
+
+		SnapshotWriter writer;
+		RESULT_CODE code = writer.open(pFileName, dim, SnapshotHeader::COMPRESSED);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		std::vector<uint64_t> index(1, blockSize);
+		index.push_back(0);
+		std::vector<double> block;
+		std::vector<uint8_t> bytes;
+		for (size_t first = 0; first < count; first += blockSize)
 		{
-			res->dim_ = dim_;
-			for (IVector* vec : data_)
-				res->data_.push_back(vec->clone());
+			size_t n = std::min(blockSize, count - first);
+			block.resize(n * dim);
+			for (size_t v = 0; v < n; v++)
+				std::copy(coords + order[first + v] * dim, coords + (order[first + v] + 1) * dim, block.begin() + v * dim);
+
+			bytes.clear();
+			encodeBlock(block.data(), n, dim, bytes);
+			code = writer.appendBlock(bytes.data(), bytes.size(), n);
+			if (code != RESULT_CODE::SUCCESS)
+				return code;
+			index.push_back(index.back() + bytes.size());
+		}
+
+		return writer.finish(index.data(), index.size() * sizeof(uint64_t));
+	}
+
+	// Coordinates are served straight from the mapping, only the MORTON index is copied
+	SetImpl* SetImpl::loadMapped(char const* pFileName, RESULT_CODE& code)
+	{
+		std::shared_ptr<MappedFile> mapping = MappedFile::open(pFileName);
+		if (mapping == nullptr || mapping->size() < sizeof(SnapshotHeader))
+		{
+			code = RESULT_CODE::FILE_ERROR;
+			return nullptr;
+		}
+
+		SnapshotHeader header;
+		memcpy(&header, mapping->data(), sizeof(header));
+		code = header.validate(mapping->size());
+		if (code != RESULT_CODE::SUCCESS)
+			return nullptr;
+
+		if ((header.flags & SnapshotHeader::COMPRESSED) != 0)
+			return loadCompressed(header, (char const*)mapping->data(), code);
+
+		bool morton = (header.flags & SnapshotHeader::LAYOUT_MORTON) != 0;
+		if ((header.dim == 0 && header.count != 0)
+			|| (header.dim != 0 && header.count > header.dataSize / sizeof(double) / header.dim)
+			|| header.dataSize != header.count * header.dim * sizeof(double)
+			|| (morton && header.indexSize != header.count * sizeof(uint64_t)))
+		{
+			code = RESULT_CODE::FILE_ERROR;
+			return nullptr;
+		}
+
+		SetImpl* res = new (std::nothrow) SetImpl(morton ? LAYOUT::MORTON : LAYOUT::INSERTION);
+		if (res == nullptr)
+		{
+			code = RESULT_CODE::OUT_OF_MEMORY;
+			return nullptr;
+		}
+
+		char const* base = (char const*)mapping->data();
+		res->dim_ = header.count != 0 ? header.dim : 0;
+		res->size_ = header.count;
+		if (header.count != 0)
+		{
+			res->mapped_ = (double const*)(base + header.dataOffset);
+			res->mapping_ = mapping;
+		}
+
+		if (morton)
+		{
+			uint64_t const* index = (uint64_t const*)(base + header.indexOffset);
+			res->slotOf_.assign(index, index + header.count);
+			res->indexOf_.assign(header.count, header.count);
+			for (size_t i = 0; i < header.count; i++)
+			{
+				if (index[i] >= header.count || res->indexOf_[index[i]] != header.count)
+				{
+					delete res;
+					code = RESULT_CODE::FILE_ERROR;
+					return nullptr;
+				}
+				res->indexOf_[index[i]] = i;
+			}
+			if ((header.flags & SnapshotHeader::SORTED) != 0)
+				res->rekey();
+		}
+
+		code = RESULT_CODE::SUCCESS;
+		return res;
+	}
+
+	// Compressed snapshots can't be served in place, blocks are decoded straight into owned storage
+	SetImpl* SetImpl::loadCompressed(SnapshotHeader const& header, char const* base, RESULT_CODE& code)
+	{
+		SnapshotBlockTable table;
+		code = table.parse(header, base + header.indexOffset);
+		if (code != RESULT_CODE::SUCCESS)
+			return nullptr;
+
+		SetImpl* res = new (std::nothrow) SetImpl(LAYOUT::INSERTION);
+		if (res == nullptr)
+		{
+			code = RESULT_CODE::OUT_OF_MEMORY;
+			return nullptr;
+		}
+
+		res->data_.resize(header.count * header.dim);
+
+		uint8_t const* data = (uint8_t const*)(base + header.dataOffset);
+		for (size_t b = 0; b < table.blockCount(); b++)
+		{
+			uint64_t count = table.vectorsIn(b, header.count);
+			if (!decodeBlock(data + table.offsets[b], table.offsets[b + 1] - table.offsets[b], count, header.dim,
+				res->data_.data() + b * table.blockSize * header.dim))
+			{
+				delete res;
+				code = RESULT_CODE::FILE_ERROR;
+				return nullptr;
+			}
 		}
 
+		res->dim_ = header.dim;
+		res->size_ = header.count;
+		code = RESULT_CODE::SUCCESS;
 		return res;
 	}
-}
\ No newline at end of file
+}
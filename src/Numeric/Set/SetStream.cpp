@@ -0,0 +1,59 @@
+#include "numeric/SetStream.h"
+#include "numeric/LogLevel.h"
+#include "SetStreamImpl.cpp"
+
+namespace
+{
+	RESULT_CODE runStream(SetStreamImpl::OPERATION op, char const* pOperand1, char const* pOperand2, char const* pResult,
+		IVector::NORM norm, double tolerance, SetStream::Params const& params, char const* fun, ILogger* pLogger)
+	{
+		RESULT_CODE code = RESULT_CODE::SUCCESS;
+		char const* msg = nullptr;
+
+		if (pOperand1 == nullptr || pOperand2 == nullptr || pResult == nullptr)
+		{
+			msg = "file name is nullptr";
+			code = RESULT_CODE::BAD_REFERENCE;
+		}
+		else if (tolerance < 0)
+		{
+			msg = "tolerance is negative";
+			code = RESULT_CODE::WRONG_ARGUMENT;
+		}
+		else if (params.memoryLimit == 0)
+		{
+			msg = "memoryLimit = 0";
+			code = RESULT_CODE::WRONG_ARGUMENT;
+		}
+		else
+		{
+			SetStreamImpl stream(op, norm, tolerance, params);
+			code = stream.run(pOperand1, pOperand2, pResult);
+			if (code == RESULT_CODE::WRONG_DIM)
+				msg = "operands dim should be the same and not 0";
+			else if (code == RESULT_CODE::OUT_OF_MEMORY)
+				msg = "memoryLimit is too small for vectors that can't be split further";
+			else if (code != RESULT_CODE::SUCCESS)
+				msg = "failed to read operands or write runs and result";
+		}
+
+		if (code != RESULT_CODE::SUCCESS)
+			UI_LOG_FAILURE(pLogger, ("In " + std::string(fun) + " " + msg).c_str(), code);
+		return code;
+	}
+}
+
+RESULT_CODE SetStream::add(char const* pOperand1, char const* pOperand2, char const* pResult, IVector::NORM norm, double tolerance, Params const& params, ILogger* pLogger)
+{
+	return runStream(SetStreamImpl::OPERATION::ADD, pOperand1, pOperand2, pResult, norm, tolerance, params, "[SetStream::add]", pLogger);
+}
+
+RESULT_CODE SetStream::intersect(char const* pOperand1, char const* pOperand2, char const* pResult, IVector::NORM norm, double tolerance, Params const& params, ILogger* pLogger)
+{
+	return runStream(SetStreamImpl::OPERATION::INTERSECT, pOperand1, pOperand2, pResult, norm, tolerance, params, "[SetStream::intersect]", pLogger);
+}
+
+RESULT_CODE SetStream::sub(char const* pOperand1, char const* pOperand2, char const* pResult, IVector::NORM norm, double tolerance, Params const& params, ILogger* pLogger)
+{
+	return runStream(SetStreamImpl::OPERATION::SUB, pOperand1, pOperand2, pResult, norm, tolerance, params, "[SetStream::sub]", pLogger);
+}
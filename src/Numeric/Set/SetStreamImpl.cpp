@@ -0,0 +1,608 @@
+#include "numeric/SetStream.h"
+#include "Distance.h"
+#include "SnapshotFormat.h"
+#include <vector>
+#include <map>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace
+{
+	// Vectors of one slab, looked up through a window on the split coordinate:
+	// for every supported norm |a[axis] - b[axis]| <= ||a - b||. Vectors aren't copied
+	// and must outlive the index.
+	class SlabIndex
+	{
+	private:
+		size_t dim_;
+		size_t axis_;
+		double tolerance_;
+		std::multimap<double, double const*> byAxis_;
+
+	public:
+		// Memory of one entry: a tree node with the allocator's overhead
+		static constexpr size_t ENTRY_BYTES = 64;
+
+		SlabIndex(size_t dim, size_t axis, double tolerance)
+			: dim_(dim), axis_(axis), tolerance_(tolerance)
+		{}
+
+		void add(double const* coords)
+		{
+			byAxis_.insert(std::make_pair(coords[axis_], coords));
+		}
+
+		void add(std::vector<double> const& coords)
+		{
+			for (size_t i = 0; i < coords.size(); i += dim_)
+				add(coords.data() + i);
+		}
+
+		double const* find(double const* coords, IVector::NORM norm) const
+		{
+			auto end = byAxis_.upper_bound(coords[axis_] + tolerance_);
+			for (auto it = byAxis_.lower_bound(coords[axis_] - tolerance_); it != end; ++it)
+				if (isNear(it->second, coords, dim_, norm, tolerance_))
+					return it->second;
+			return nullptr;
+		}
+	};
+
+	// Vectors of a spilled run of count vectors, a missing file is an empty run
+	class RunReader
+	{
+	private:
+		FILE* file_;
+		size_t dim_;
+		uint64_t count_;
+		uint64_t read_;
+		bool failed_;
+
+	public:
+		RunReader(std::string const& name, size_t dim, uint64_t count)
+			: file_(fopen(name.c_str(), "rb")), dim_(dim), count_(count), read_(0), failed_(false)
+		{}
+
+		~RunReader()
+		{
+			if (file_ != nullptr)
+				fclose(file_);
+		}
+
+		uint64_t read(double* coords, uint64_t count)
+		{
+			if (file_ == nullptr)
+				return 0;
+
+			uint64_t res = fread(coords, dim_ * sizeof(double), (size_t)count, file_);
+			failed_ = failed_ || ferror(file_) != 0;
+			read_ += res;
+			return res;
+		}
+
+		// Every vector of the run was read
+		bool complete() const
+		{
+			return !failed_ && read_ == count_;
+		}
+	};
+
+	class SetStreamImpl
+	{
+	public:
+		enum class OPERATION { ADD, INTERSECT, SUB };
+
+	private:
+		enum RUN { OWN1, HALO1, OWN2, HALO2, RUN_COUNT };
+
+		static constexpr size_t MAX_SAMPLE = 1 << 16;
+		static constexpr size_t MAX_CHUNK = 1024;
+		static constexpr size_t MAX_DEPTH = 32;
+
+		// Slabs of one split of [lower, upper) on the axis: slab s holds values in
+		// [borders[s - 1], borders[s]). A slab too large for memory is split again.
+		struct Partition
+		{
+			std::string prefix;
+			double lower;
+			double upper;
+			std::vector<double> borders;
+			std::vector<uint64_t> counts;  // vectors in each run, RUN_COUNT * slabs
+
+			size_t slabs() const
+			{
+				return borders.size() + 1;
+			}
+
+			double lowerOf(size_t slab) const
+			{
+				return slab == 0 ? lower : borders[slab - 1];
+			}
+
+			double upperOf(size_t slab) const
+			{
+				return slab == borders.size() ? upper : borders[slab];
+			}
+
+			size_t slabOf(double x) const
+			{
+				return std::upper_bound(borders.begin(), borders.end(), x) - borders.begin();
+			}
+
+			uint64_t countOf(RUN run, size_t slab) const
+			{
+				return counts[run * slabs() + slab];
+			}
+
+			std::string runName(RUN run, size_t slab) const
+			{
+				return prefix + std::to_string((int)run) + "_" + std::to_string(slab) + ".run";
+			}
+		};
+
+		OPERATION op_;
+		IVector::NORM norm_;
+		double tolerance_;
+		SetStream::Params params_;
+		std::string prefix_;
+		std::vector<std::string> spilled_;  // every run name that may exist
+
+		size_t dim_;
+		size_t axis_;
+		size_t vectorBytes_;
+		size_t bufferSize_;
+		std::vector<std::vector<double>> buffers_;  // RUN_COUNT * slabs spill buffers
+
+		uint64_t slabBytes(Partition const& part, size_t slab, size_t carried) const;
+		uint64_t slabCount(uint64_t bytes, uint64_t budget, size_t sampled) const;
+		void chooseBorders(std::vector<double>& sample, uint64_t slabs, Partition& part) const;
+		RESULT_CODE startSpill(Partition& part, uint64_t budget);
+		RESULT_CODE flush(Partition const& part, RUN run, size_t slab);
+		RESULT_CODE push(Partition& part, RUN run, size_t slab, double const* coords);
+		template<typename Reader>
+		RESULT_CODE spill(Reader& reader, Partition& part, RUN run, RUN halo);
+		RESULT_CODE finishSpill(Partition const& part);
+		RESULT_CODE split(Partition const& part, size_t slab, uint64_t budget, Partition& child);
+		RESULT_CODE load(Partition const& part, RUN run, size_t slab, std::vector<double>& data) const;
+		RESULT_CODE process(Partition const& part, size_t slab, std::vector<double>& carry, SnapshotWriter& writer);
+		RESULT_CODE processAll(Partition& part, size_t depth, std::vector<double>& carry, SnapshotWriter& writer);
+
+	public:
+		SetStreamImpl(OPERATION op, IVector::NORM norm, double tolerance, SetStream::Params const& params);
+		~SetStreamImpl();
+
+		RESULT_CODE run(char const* pOperand1, char const* pOperand2, char const* pResult);
+	};
+
+	SetStreamImpl::SetStreamImpl(OPERATION op, IVector::NORM norm, double tolerance, SetStream::Params const& params)
+		: op_(op), norm_(norm), tolerance_(tolerance), params_(params), dim_(0), axis_(0), vectorBytes_(0), bufferSize_(0)
+	{
+		uint64_t stamp = (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+		prefix_ = std::string(params_.tempDir != nullptr ? params_.tempDir : ".") + "/setstream_"
+			+ std::to_string((uintptr_t)this) + "_" + std::to_string(stamp) + "_";
+	}
+
+	SetStreamImpl::~SetStreamImpl()
+	{
+		for (std::string const& name : spilled_)
+			std::remove(name.c_str());
+	}
+
+	// Peak memory of processing a slab: its runs and the carried vectors, their index entries
+	// and at most as many accepted copies
+	uint64_t SetStreamImpl::slabBytes(Partition const& part, size_t slab, size_t carried) const
+	{
+		size_t slabs = part.slabs();
+		uint64_t count = carried + part.counts[OWN1 * slabs + slab] + part.counts[OWN2 * slabs + slab]
+			+ part.counts[(op_ == OPERATION::ADD ? HALO1 : HALO2) * slabs + slab];
+		return count * (2 * vectorBytes_ + SlabIndex::ENTRY_BYTES);
+	}
+
+	// Slabs for bytes of runs to take about half of the budget each, leaving room for halos
+	// and carried vectors. Every slab needs a spill buffer of a vector per run and a share of
+	// the sample. 1 if the runs fit.
+	uint64_t SetStreamImpl::slabCount(uint64_t bytes, uint64_t budget, size_t sampled) const
+	{
+		if (bytes <= budget)
+			return 1;
+
+		uint64_t slabs = std::max<uint64_t>(2, (2 * bytes + budget - 1) / budget);
+		uint64_t buffers = budget / vectorBytes_ > RUN_COUNT ? (budget / vectorBytes_ - 1) / RUN_COUNT : 1;
+		return std::max<uint64_t>(1, std::min<uint64_t>(slabs, std::min<uint64_t>(sampled, buffers)));
+	}
+
+	// Borders at quantiles of the sampled axis values, at least 3 tolerances apart (and from
+	// the ends of the range) so a slab only meets its direct neighbours. Fewer borders than
+	// asked for where values are too close.
+	void SetStreamImpl::chooseBorders(std::vector<double>& sample, uint64_t slabs, Partition& part) const
+	{
+		part.borders.clear();
+		std::sort(sample.begin(), sample.end());
+		double last = part.lower;
+		for (uint64_t j = 1; j < slabs; j++)
+		{
+			double border = sample[sample.size() * j / slabs];
+			if (border > last && border - last >= 3 * tolerance_ && part.upper - border >= 3 * tolerance_)
+			{
+				part.borders.push_back(border);
+				last = border;
+			}
+		}
+	}
+
+	// Spill buffers share the budget with the chunk being read
+	RESULT_CODE SetStreamImpl::startSpill(Partition& part, uint64_t budget)
+	{
+		size_t slabs = part.slabs();
+		bufferSize_ = (size_t)std::min<uint64_t>(MAX_CHUNK, budget / (RUN_COUNT * slabs + 1) / vectorBytes_);
+		if (bufferSize_ == 0)
+			return RESULT_CODE::OUT_OF_MEMORY;
+
+		buffers_.assign(RUN_COUNT * slabs, std::vector<double>());
+		part.counts.assign(RUN_COUNT * slabs, 0);
+		for (size_t slab = 0; slab < slabs; slab++)
+			for (int run = 0; run < RUN_COUNT; run++)
+				spilled_.push_back(part.runName((RUN)run, slab));
+		return RESULT_CODE::SUCCESS;
+	}
+
+	RESULT_CODE SetStreamImpl::flush(Partition const& part, RUN run, size_t slab)
+	{
+		std::vector<double>& buffer = buffers_[run * part.slabs() + slab];
+		if (buffer.empty())
+			return RESULT_CODE::SUCCESS;
+
+		FILE* file = fopen(part.runName(run, slab).c_str(), "ab");
+		if (file == nullptr)
+			return RESULT_CODE::FILE_ERROR;
+		size_t written = fwrite(buffer.data(), sizeof(double), buffer.size(), file);
+		fclose(file);
+		if (written != buffer.size())
+			return RESULT_CODE::FILE_ERROR;
+
+		buffer.clear();
+		return RESULT_CODE::SUCCESS;
+	}
+
+	RESULT_CODE SetStreamImpl::push(Partition& part, RUN run, size_t slab, double const* coords)
+	{
+		std::vector<double>& buffer = buffers_[run * part.slabs() + slab];
+		buffer.insert(buffer.end(), coords, coords + dim_);
+		part.counts[run * part.slabs() + slab]++;
+		if (buffer.size() >= bufferSize_ * dim_)
+			return flush(part, run, slab);
+		return RESULT_CODE::SUCCESS;
+	}
+
+	// Sorts vectors into slab runs; with a halo run the ones near a border are copied into the
+	// neighbour's halo. Without one, halo vectors of a parent slab are only routed to their slab.
+	template<typename Reader>
+	RESULT_CODE SetStreamImpl::spill(Reader& reader, Partition& part, RUN run, RUN halo)
+	{
+		size_t slabs = part.slabs();
+		bool lowerHalo = halo != RUN_COUNT && slabs > 1;
+		bool upperHalo = halo == HALO2 && slabs > 1;
+
+		std::vector<double> chunk(bufferSize_ * dim_);
+		uint64_t count;
+		RESULT_CODE code = RESULT_CODE::SUCCESS;
+		while (code == RESULT_CODE::SUCCESS && (count = reader.read(chunk.data(), bufferSize_)) != 0)
+			for (uint64_t i = 0; i < count && code == RESULT_CODE::SUCCESS; i++)
+			{
+				double const* vec = chunk.data() + i * dim_;
+				double x = vec[axis_];
+				size_t slab = part.slabOf(x);
+				code = push(part, run, slab, vec);
+
+				if (lowerHalo && code == RESULT_CODE::SUCCESS && slab > 0 && x - part.lowerOf(slab) < tolerance_)
+					code = push(part, halo, slab - 1, vec);
+				if (upperHalo && code == RESULT_CODE::SUCCESS && slab + 1 < slabs && part.upperOf(slab) - x <= tolerance_)
+					code = push(part, halo, slab + 1, vec);
+			}
+
+		if (code == RESULT_CODE::SUCCESS && !reader.complete())
+			code = RESULT_CODE::FILE_ERROR;
+		return code;
+	}
+
+	RESULT_CODE SetStreamImpl::finishSpill(Partition const& part)
+	{
+		RESULT_CODE code = RESULT_CODE::SUCCESS;
+		for (size_t slab = 0; slab < part.slabs() && code == RESULT_CODE::SUCCESS; slab++)
+			for (int run = 0; run < RUN_COUNT && code == RESULT_CODE::SUCCESS; run++)
+				code = flush(part, (RUN)run, slab);
+		buffers_.clear();
+		return code;
+	}
+
+	// Splits a slab whose runs don't fit by quantiles of its own vectors. Halo vectors of the
+	// slab go to the halo runs of the outer child slabs.
+	RESULT_CODE SetStreamImpl::split(Partition const& part, size_t slab, uint64_t budget, Partition& child)
+	{
+		child.prefix = part.prefix + std::to_string(slab) + "_";
+		child.lower = part.lowerOf(slab);
+		child.upper = part.upperOf(slab);
+
+		// Half of the budget for the sample, the rest for the chunk being read
+		size_t limit = (size_t)std::min<uint64_t>(MAX_SAMPLE, budget / 2 / sizeof(double));
+		size_t chunkSize = (size_t)std::min<uint64_t>(MAX_CHUNK, budget / 2 / vectorBytes_);
+		if (limit == 0 || chunkSize == 0)
+			return RESULT_CODE::OUT_OF_MEMORY;
+
+		std::vector<double> sample;
+		std::vector<double> chunk(chunkSize * dim_);
+		std::mt19937_64 gen(slab);
+		uint64_t seen = 0;
+		for (RUN run : { OWN1, OWN2 })
+		{
+			RunReader reader(part.runName(run, slab), dim_, part.countOf(run, slab));
+			uint64_t count;
+			while ((count = reader.read(chunk.data(), chunkSize)) != 0)
+				for (uint64_t i = 0; i < count; i++)
+				{
+					double x = chunk[i * dim_ + axis_];
+					if (std::isnan(x))
+						continue;
+					if (sample.size() < limit)
+						sample.push_back(x);
+					else if (uint64_t pos = gen() % (seen + 1); pos < limit)
+						sample[pos] = x;
+					seen++;
+				}
+			if (!reader.complete())
+				return RESULT_CODE::FILE_ERROR;
+		}
+		chunk = std::vector<double>();
+
+		chooseBorders(sample, slabCount(slabBytes(part, slab, 0), budget, sample.size()), child);
+		sample = std::vector<double>();
+		if (child.borders.empty())
+			return RESULT_CODE::OUT_OF_MEMORY;
+
+		RESULT_CODE code = startSpill(child, budget);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		RUN ownHalo[2] = { op_ == OPERATION::ADD ? HALO1 : RUN_COUNT, op_ == OPERATION::ADD ? RUN_COUNT : HALO2 };
+		RUN runs[4] = { OWN1, OWN2, HALO1, HALO2 };
+		for (int r = 0; r < 4 && code == RESULT_CODE::SUCCESS; r++)
+		{
+			RunReader reader(part.runName(runs[r], slab), dim_, part.countOf(runs[r], slab));
+			code = spill(reader, child, runs[r], r < 2 ? ownHalo[r] : RUN_COUNT);
+		}
+		if (code == RESULT_CODE::SUCCESS)
+			code = finishSpill(child);
+		return code;
+	}
+
+	RESULT_CODE SetStreamImpl::load(Partition const& part, RUN run, size_t slab, std::vector<double>& data) const
+	{
+		data.resize(part.countOf(run, slab) * dim_);
+		RunReader reader(part.runName(run, slab), dim_, part.countOf(run, slab));
+		reader.read(data.data(), part.countOf(run, slab));
+		return reader.complete() ? RESULT_CODE::SUCCESS : RESULT_CODE::FILE_ERROR;
+	}
+
+	// carry holds result vectors of the previous slab that may still be near this one
+	RESULT_CODE SetStreamImpl::process(Partition const& part, size_t slab, std::vector<double>& carry, SnapshotWriter& writer)
+	{
+		std::vector<double> own1, halo1, own2, halo2;
+		RESULT_CODE code = load(part, OWN1, slab, own1);
+		if (code == RESULT_CODE::SUCCESS)
+			code = load(part, OWN2, slab, own2);
+		if (code == RESULT_CODE::SUCCESS && op_ == OPERATION::ADD)
+			code = load(part, HALO1, slab, halo1);
+		if (code == RESULT_CODE::SUCCESS && op_ != OPERATION::ADD)
+			code = load(part, HALO2, slab, halo2);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		std::vector<double> accepted;
+		switch (op_)
+		{
+		case OPERATION::ADD:
+		{
+			SlabIndex pool(dim_, axis_, tolerance_);
+			pool.add(carry);
+			pool.add(own1);
+			pool.add(halo1);
+			accepted = own1;
+			for (size_t i = 0; i < own2.size(); i += dim_)
+				if (pool.find(own2.data() + i, norm_) == nullptr)
+				{
+					pool.add(own2.data() + i);
+					accepted.insert(accepted.end(), own2.begin() + i, own2.begin() + i + dim_);
+				}
+			break;
+		}
+
+		case OPERATION::INTERSECT:
+		{
+			SlabIndex other(dim_, axis_, tolerance_);
+			other.add(own2);
+			other.add(halo2);
+			SlabIndex pool(dim_, axis_, tolerance_);
+			pool.add(carry);
+			std::vector<double const*> found;
+			for (size_t i = 0; i < own1.size(); i += dim_)
+			{
+				double const* vec = other.find(own1.data() + i, norm_);
+				if (vec != nullptr && pool.find(vec, norm_) == nullptr)
+				{
+					pool.add(vec);
+					found.push_back(vec);
+				}
+			}
+			for (double const* vec : found)
+				accepted.insert(accepted.end(), vec, vec + dim_);
+			break;
+		}
+
+		case OPERATION::SUB:
+		{
+			SlabIndex other(dim_, axis_, tolerance_);
+			other.add(own2);
+			other.add(halo2);
+			for (size_t i = 0; i < own1.size(); i += dim_)
+				if (other.find(own1.data() + i, norm_) == nullptr)
+					accepted.insert(accepted.end(), own1.begin() + i, own1.begin() + i + dim_);
+			break;
+		}
+		}
+
+		code = writer.append(accepted.data(), accepted.size() / dim_);
+
+		carry.clear();
+		double border = part.upperOf(slab) - 2 * tolerance_;
+		for (size_t i = 0; i < accepted.size(); i += dim_)
+			if (accepted[i + axis_] >= border)
+				carry.insert(carry.end(), accepted.begin() + i, accepted.begin() + i + dim_);
+
+		return code;
+	}
+
+	// Slabs in order, each one either processed or split again if it doesn't fit
+	RESULT_CODE SetStreamImpl::processAll(Partition& part, size_t depth, std::vector<double>& carry, SnapshotWriter& writer)
+	{
+		RESULT_CODE code = RESULT_CODE::SUCCESS;
+		for (size_t slab = 0; slab < part.slabs() && code == RESULT_CODE::SUCCESS; slab++)
+		{
+			uint64_t carryBytes = carry.size() * sizeof(double);
+			if (slabBytes(part, slab, carry.size() / dim_) <= params_.memoryLimit)
+				code = process(part, slab, carry, writer);
+			else if (depth == MAX_DEPTH || carryBytes >= params_.memoryLimit)
+				code = RESULT_CODE::OUT_OF_MEMORY;
+			else
+			{
+				Partition child;
+				code = split(part, slab, params_.memoryLimit - carryBytes, child);
+				if (code == RESULT_CODE::SUCCESS)
+					code = processAll(child, depth + 1, carry, writer);
+			}
+
+			for (int run = 0; run < RUN_COUNT; run++)
+				std::remove(part.runName((RUN)run, slab).c_str());
+		}
+		return code;
+	}
+
+	RESULT_CODE SetStreamImpl::run(char const* pOperand1, char const* pOperand2, char const* pResult)
+	{
+		SnapshotReader reader1, reader2;
+		RESULT_CODE code = reader1.open(pOperand1);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+		code = reader2.open(pOperand2);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		dim_ = (size_t)reader1.header().dim;
+		if (dim_ == 0 || reader2.header().dim != dim_)
+			return RESULT_CODE::WRONG_DIM;
+		vectorBytes_ = dim_ * sizeof(double);
+
+		// One pass for the range of every coordinate and a sample of whole vectors, half of
+		// the budget each for the sample and the chunk being read
+		uint64_t budget = params_.memoryLimit;
+		size_t limit = (size_t)std::min<uint64_t>(MAX_SAMPLE, budget / 2 / vectorBytes_);
+		size_t chunkSize = (size_t)std::min<uint64_t>(MAX_CHUNK, budget / 2 / vectorBytes_);
+		if (chunkSize == 0)
+			return RESULT_CODE::OUT_OF_MEMORY;
+
+		std::vector<double> lo(dim_, std::numeric_limits<double>::infinity());
+		std::vector<double> hi(dim_, -std::numeric_limits<double>::infinity());
+		std::vector<double> sample;
+		std::vector<double> chunk(chunkSize * dim_);
+		std::mt19937_64 gen(dim_);
+		uint64_t seen = 0;
+		for (SnapshotReader* reader : { &reader1, &reader2 })
+		{
+			uint64_t count;
+			while ((count = reader->read(chunk.data(), chunkSize)) != 0)
+				for (uint64_t i = 0; i < count; i++)
+				{
+					double const* vec = chunk.data() + i * dim_;
+					for (size_t d = 0; d < dim_; d++)
+					{
+						lo[d] = std::min(lo[d], vec[d]);
+						hi[d] = std::max(hi[d], vec[d]);
+					}
+					if (sample.size() < limit * dim_)
+						sample.insert(sample.end(), vec, vec + dim_);
+					else if (uint64_t pos = gen() % (seen + 1); pos < limit)
+						std::copy(vec, vec + dim_, sample.begin() + pos * dim_);
+					seen++;
+				}
+			if (!reader->complete())
+				return RESULT_CODE::FILE_ERROR;
+			code = reader->rewind();
+			if (code != RESULT_CODE::SUCCESS)
+				return code;
+		}
+		chunk = std::vector<double>();
+
+		Partition root;
+		root.prefix = prefix_;
+		root.lower = -std::numeric_limits<double>::infinity();
+		root.upper = std::numeric_limits<double>::infinity();
+		root.counts.assign(RUN_COUNT, 0);
+		root.counts[OWN1] = reader1.header().count;
+		root.counts[OWN2] = reader2.header().count;
+		uint64_t slabs = slabCount(slabBytes(root, 0, 0), budget, sample.size() / dim_);
+
+		// Split on the coordinate whose sample gives the most borders, the widest finite
+		// range first. A single slab that doesn't fit is split again by processAll.
+		axis_ = 0;
+		double widest = -1;
+		for (size_t d = 0; d < dim_; d++)
+			if (std::isfinite(hi[d] - lo[d]) && hi[d] - lo[d] > widest)
+			{
+				widest = hi[d] - lo[d];
+				axis_ = d;
+			}
+
+		std::vector<double> values;
+		Partition candidate = root;
+		for (size_t n = 0; n < dim_ && slabs > 1 && root.borders.size() + 1 < slabs; n++)
+		{
+			size_t d = (axis_ + n) % dim_;
+			values.clear();
+			for (size_t i = d; i < sample.size(); i += dim_)
+				if (!std::isnan(sample[i]))
+					values.push_back(sample[i]);
+			chooseBorders(values, slabs, candidate);
+			if (candidate.borders.size() > root.borders.size())
+			{
+				root.borders.swap(candidate.borders);
+				axis_ = d;
+			}
+		}
+		sample = std::vector<double>();
+		values = std::vector<double>();
+
+		code = startSpill(root, budget);
+		if (code == RESULT_CODE::SUCCESS)
+			code = spill(reader1, root, OWN1, op_ == OPERATION::ADD ? HALO1 : RUN_COUNT);
+		if (code == RESULT_CODE::SUCCESS)
+			code = spill(reader2, root, OWN2, op_ == OPERATION::ADD ? RUN_COUNT : HALO2);
+		if (code == RESULT_CODE::SUCCESS)
+			code = finishSpill(root);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		SnapshotWriter writer;
+		code = writer.open(pResult, dim_, 0);
+		std::vector<double> carry;
+		if (code == RESULT_CODE::SUCCESS)
+			code = processAll(root, 0, carry, writer);
+		if (code == RESULT_CODE::SUCCESS)
+			code = writer.finish(nullptr, 0);
+		return code;
+	}
+}
@@ -0,0 +1,50 @@
+#include "numeric/SnapshotBlocks.h"
+#include "SnapshotBlocksImpl.cpp"
+
+SnapshotBlocks* SnapshotBlocks::open(char const* pFileName, ILogger* pLogger)
+{
+	if (pFileName == nullptr)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [SnapshotBlocks::open] pFileName is nullptr", RESULT_CODE::BAD_REFERENCE);
+		return nullptr;
+	}
+
+	std::shared_ptr<MappedFile> mapping = MappedFile::open(pFileName);
+	SnapshotHeader header;
+	RESULT_CODE code = RESULT_CODE::FILE_ERROR;
+	if (mapping != nullptr && mapping->size() >= sizeof(header))
+	{
+		memcpy(&header, mapping->data(), sizeof(header));
+		code = header.validate(mapping->size());
+	}
+
+	if (code != RESULT_CODE::SUCCESS)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [SnapshotBlocks::open] file is missing or not a valid snapshot", code);
+		return nullptr;
+	}
+
+	SnapshotBlocksImpl* res = new (std::nothrow) SnapshotBlocksImpl(mapping, header);
+	if (res == nullptr)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [SnapshotBlocks::open] not enough memory for [SnapshotBlocks* res]", RESULT_CODE::OUT_OF_MEMORY);
+		return nullptr;
+	}
+
+	code = res->init();
+	if (code != RESULT_CODE::SUCCESS)
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [SnapshotBlocks::open] broken block table", code);
+		delete res;
+		return nullptr;
+	}
+
+	return res;
+}
+
+SnapshotBlocks::~SnapshotBlocks()
+{}
@@ -0,0 +1,104 @@
+#include "numeric/SnapshotBlocks.h"
+#include "MappedFile.h"
+#include "SnapshotFormat.h"
+#include <memory>
+#include <cstring>
+
+namespace
+{
+	class SnapshotBlocksImpl : public SnapshotBlocks
+	{
+	private:
+		std::shared_ptr<MappedFile> mapping_;
+		SnapshotHeader header_;
+		SnapshotBlockTable table_;
+		bool compressed_;
+
+		uint8_t const* data() const;
+
+	public:
+		SnapshotBlocksImpl(std::shared_ptr<MappedFile> const& mapping, SnapshotHeader const& header);
+		RESULT_CODE init();
+
+		size_t getDim() const override;
+		size_t getSize() const override;
+		size_t getBlockCount() const override;
+		size_t getBlockSize() const override;
+		size_t getBlockLength(size_t block) const override;
+		RESULT_CODE decodeBlock(size_t block, double* coords) const override;
+	};
+
+	SnapshotBlocksImpl::SnapshotBlocksImpl(std::shared_ptr<MappedFile> const& mapping, SnapshotHeader const& header)
+		: mapping_(mapping), header_(header), compressed_((header.flags & SnapshotHeader::COMPRESSED) != 0)
+	{}
+
+	RESULT_CODE SnapshotBlocksImpl::init()
+	{
+		if (compressed_)
+			return table_.parse(header_, (char const*)mapping_->data() + header_.indexOffset);
+
+		if ((header_.dim == 0 && header_.count != 0)
+			|| (header_.dim != 0 && header_.count > header_.dataSize / sizeof(double) / header_.dim))
+			return RESULT_CODE::FILE_ERROR;
+
+		// plain coordinates: fixed-size blocks at computed offsets
+		table_.blockSize = BLOCK_SIZE;
+		uint64_t vecSize = header_.dim * sizeof(double);
+		for (uint64_t first = 0; first < header_.count; first += BLOCK_SIZE)
+			table_.offsets.push_back(first * vecSize);
+		table_.offsets.push_back(header_.count * vecSize);
+		return RESULT_CODE::SUCCESS;
+	}
+
+	uint8_t const* SnapshotBlocksImpl::data() const
+	{
+		return (uint8_t const*)mapping_->data() + header_.dataOffset;
+	}
+
+	size_t SnapshotBlocksImpl::getDim() const
+	{
+		return header_.dim;
+	}
+
+	size_t SnapshotBlocksImpl::getSize() const
+	{
+		return header_.count;
+	}
+
+	size_t SnapshotBlocksImpl::getBlockCount() const
+	{
+		return table_.blockCount();
+	}
+
+	size_t SnapshotBlocksImpl::getBlockSize() const
+	{
+		return table_.blockSize;
+	}
+
+	size_t SnapshotBlocksImpl::getBlockLength(size_t block) const
+	{
+		if (block >= table_.blockCount())
+			return 0;
+		return table_.vectorsIn(block, header_.count);
+	}
+
+	RESULT_CODE SnapshotBlocksImpl::decodeBlock(size_t block, double* coords) const
+	{
+		if (coords == nullptr)
+			return RESULT_CODE::BAD_REFERENCE;
+		if (block >= table_.blockCount())
+			return RESULT_CODE::OUT_OF_BOUNDS;
+
+		uint8_t const* bytes = data() + table_.offsets[block];
+		uint64_t size = table_.offsets[block + 1] - table_.offsets[block];
+		if (!compressed_)
+		{
+			memcpy(coords, bytes, size);
+			return RESULT_CODE::SUCCESS;
+		}
+
+		if (!::decodeBlock(bytes, size, getBlockLength(block), header_.dim, coords))
+			return RESULT_CODE::FILE_ERROR;
+		return RESULT_CODE::SUCCESS;
+	}
+}
@@ -0,0 +1,313 @@
+#pragma once
+#include "ILogger.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "FloatCodec.h"
+
+// On-disk layout of a set snapshot (native byte order):
+//   [0, 64)               SnapshotHeader
+//   [dataOffset, +size)   coordinates, dim doubles per vector, 64-byte aligned
+//                         (COMPRESSED: encoded blocks, see FloatCodec.h)
+//   [indexOffset, +size)  optional index section, 64-byte aligned
+struct SnapshotHeader
+{
+	static const uint32_t VERSION = 1;
+	static const size_t ALIGNMENT = 64;
+
+	enum FLAGS : uint32_t
+	{
+		LAYOUT_MORTON = 1,  // index section holds uint64 slot of each insertion index
+		SORTED = 2,         // coordinates are fully sorted along the curve
+		COMPRESSED = 4      // index section holds the block table (see SnapshotBlockTable)
+	};
+
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;
+	uint64_t dim;
+	uint64_t count;
+	uint64_t dataOffset;
+	uint64_t dataSize;
+	uint64_t indexOffset;
+	uint64_t indexSize;
+
+	static void const* magicValue()
+	{
+		return "UISNAP\r\n";
+	}
+
+	// Checks the header against the size of the whole file
+	RESULT_CODE validate(uint64_t fileSize) const
+	{
+		if (memcmp(magic, magicValue(), sizeof(magic)) != 0 || version != VERSION)
+			return RESULT_CODE::FILE_ERROR;
+
+		if (dataOffset % ALIGNMENT != 0 || indexOffset % ALIGNMENT != 0)
+			return RESULT_CODE::FILE_ERROR;
+
+		if (dataOffset > fileSize || dataSize > fileSize - dataOffset
+			|| indexOffset > fileSize || indexSize > fileSize - indexOffset)
+			return RESULT_CODE::FILE_ERROR;
+
+		return RESULT_CODE::SUCCESS;
+	}
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header must stay 64 bytes");
+
+// Index section of a COMPRESSED snapshot: uint64 vectors per block,
+// then blocks + 1 uint64 offsets of the encoded blocks within the data section
+struct SnapshotBlockTable
+{
+	static const uint64_t MAX_BLOCK_SIZE = 1 << 16;
+
+	uint64_t blockSize = 0;
+	std::vector<uint64_t> offsets;
+
+	RESULT_CODE parse(SnapshotHeader const& header, void const* index)
+	{
+		if (header.indexSize < sizeof(uint64_t) || header.indexSize % sizeof(uint64_t) != 0 || header.dim == 0)
+			return RESULT_CODE::FILE_ERROR;
+
+		uint64_t const* words = (uint64_t const*)index;
+		uint64_t count = header.indexSize / sizeof(uint64_t) - 1;
+		blockSize = words[0];
+		if (blockSize == 0 || count == 0 || count - 1 != (header.count + blockSize - 1) / blockSize)
+			return RESULT_CODE::FILE_ERROR;
+
+		if (blockSize > MAX_BLOCK_SIZE)
+			return RESULT_CODE::FILE_ERROR;
+
+		offsets.assign(words + 1, words + 1 + count);
+		if (offsets.front() != 0 || offsets.back() != header.dataSize)
+			return RESULT_CODE::FILE_ERROR;
+		for (size_t i = 1; i < offsets.size(); i++)
+			if (offsets[i] < offsets[i - 1] || offsets[i] - offsets[i - 1] < header.dim * MIN_SEGMENT_SIZE)
+				return RESULT_CODE::FILE_ERROR;
+
+		return RESULT_CODE::SUCCESS;
+	}
+
+	size_t blockCount() const
+	{
+		return offsets.empty() ? 0 : offsets.size() - 1;
+	}
+
+	uint64_t vectorsIn(size_t block, uint64_t count) const
+	{
+		uint64_t first = block * blockSize;
+		return count - first < blockSize ? count - first : blockSize;
+	}
+};
+
+// Streams vectors into a snapshot file, the count is patched in by finish()
+class SnapshotWriter
+{
+private:
+	std::ofstream out_;
+	SnapshotHeader header_;
+
+	void pad()
+	{
+		static const char zeros[SnapshotHeader::ALIGNMENT] = {};
+		uint64_t pos = (uint64_t)out_.tellp();
+		uint64_t rem = pos % SnapshotHeader::ALIGNMENT;
+		if (rem != 0)
+			out_.write(zeros, SnapshotHeader::ALIGNMENT - rem);
+	}
+
+public:
+	RESULT_CODE open(char const* pFileName, uint64_t dim, uint32_t flags)
+	{
+		if (pFileName == nullptr)
+			return RESULT_CODE::BAD_REFERENCE;
+
+		out_.open(pFileName, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+		if (!out_.is_open())
+			return RESULT_CODE::FILE_ERROR;
+
+		memset(&header_, 0, sizeof(header_));
+		memcpy(header_.magic, SnapshotHeader::magicValue(), sizeof(header_.magic));
+		header_.version = SnapshotHeader::VERSION;
+		header_.flags = flags;
+		header_.dim = dim;
+		header_.dataOffset = sizeof(SnapshotHeader);
+
+		out_.write((char const*)&header_, sizeof(header_));
+		return out_ ? RESULT_CODE::SUCCESS : RESULT_CODE::FILE_ERROR;
+	}
+
+	// count vectors of dim coordinates each
+	RESULT_CODE append(double const* coords, uint64_t count)
+	{
+		out_.write((char const*)coords, (std::streamsize)(count * header_.dim * sizeof(double)));
+		header_.count += count;
+		header_.dataSize += count * header_.dim * sizeof(double);
+		return out_ ? RESULT_CODE::SUCCESS : RESULT_CODE::FILE_ERROR;
+	}
+
+	// One encoded block of count vectors
+	RESULT_CODE appendBlock(uint8_t const* bytes, uint64_t size, uint64_t count)
+	{
+		out_.write((char const*)bytes, (std::streamsize)size);
+		header_.count += count;
+		header_.dataSize += size;
+		return out_ ? RESULT_CODE::SUCCESS : RESULT_CODE::FILE_ERROR;
+	}
+
+	RESULT_CODE finish(void const* index, uint64_t indexSize)
+	{
+		if (index != nullptr && indexSize != 0)
+		{
+			pad();
+			header_.indexOffset = (uint64_t)out_.tellp();
+			header_.indexSize = indexSize;
+			out_.write((char const*)index, (std::streamsize)indexSize);
+		}
+
+		out_.seekp(0);
+		out_.write((char const*)&header_, sizeof(header_));
+		out_.close();
+		return out_ ? RESULT_CODE::SUCCESS : RESULT_CODE::FILE_ERROR;
+	}
+};
+
+// Sequential reader that never holds more than the caller's buffer
+// (and one decoded block of a compressed snapshot) in memory
+class SnapshotReader
+{
+private:
+	std::ifstream in_;
+	SnapshotHeader header_;
+	uint64_t read_ = 0;
+	bool failed_ = false;
+
+	SnapshotBlockTable table_;
+	size_t block_ = 0;
+	std::vector<uint8_t> bytes_;
+	std::vector<double> decoded_;
+	uint64_t decodedPos_ = 0;
+	uint64_t decodedCount_ = 0;
+
+	bool compressed() const
+	{
+		return (header_.flags & SnapshotHeader::COMPRESSED) != 0;
+	}
+
+	bool nextBlock()
+	{
+		if (block_ >= table_.blockCount())
+			return false;
+
+		uint64_t size = table_.offsets[block_ + 1] - table_.offsets[block_];
+		decodedCount_ = table_.vectorsIn(block_, header_.count);
+		bytes_.resize(size);
+		decoded_.resize(decodedCount_ * header_.dim);
+		in_.seekg((std::streamoff)(header_.dataOffset + table_.offsets[block_]));
+		if (!in_.read((char*)bytes_.data(), (std::streamsize)size)
+			|| !decodeBlock(bytes_.data(), size, decodedCount_, header_.dim, decoded_.data()))
+			return false;
+
+		block_++;
+		decodedPos_ = 0;
+		return true;
+	}
+
+public:
+	RESULT_CODE open(char const* pFileName)
+	{
+		if (pFileName == nullptr)
+			return RESULT_CODE::BAD_REFERENCE;
+
+		in_.open(pFileName, std::ifstream::in | std::ifstream::binary);
+		if (!in_.is_open())
+			return RESULT_CODE::FILE_ERROR;
+
+		in_.seekg(0, std::ifstream::end);
+		uint64_t fileSize = (uint64_t)in_.tellg();
+		in_.seekg(0);
+		if (fileSize < sizeof(header_) || !in_.read((char*)&header_, sizeof(header_)))
+			return RESULT_CODE::FILE_ERROR;
+
+		RESULT_CODE code = header_.validate(fileSize);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		if (compressed())
+		{
+			std::vector<uint64_t> index(header_.indexSize / sizeof(uint64_t));
+			in_.seekg((std::streamoff)header_.indexOffset);
+			if (!in_.read((char*)index.data(), (std::streamsize)(index.size() * sizeof(uint64_t))))
+				return RESULT_CODE::FILE_ERROR;
+			code = table_.parse(header_, index.data());
+			if (code != RESULT_CODE::SUCCESS)
+				return code;
+		}
+		else if (header_.dim != 0 && header_.count > header_.dataSize / sizeof(double) / header_.dim)
+			return RESULT_CODE::FILE_ERROR;
+
+		return rewind();
+	}
+
+	SnapshotHeader const& header() const
+	{
+		return header_;
+	}
+
+	// Reads up to count vectors, returns how many were read, 0 at the end or after a failure
+	uint64_t read(double* coords, uint64_t count)
+	{
+		if (count > header_.count - read_)
+			count = header_.count - read_;
+		if (count == 0)
+			return 0;
+
+		if (compressed())
+		{
+			uint64_t done = 0;
+			while (done < count)
+			{
+				if (decodedPos_ == decodedCount_ && !nextBlock())
+				{
+					failed_ = true;
+					break;
+				}
+				uint64_t take = decodedCount_ - decodedPos_;
+				if (take > count - done)
+					take = count - done;
+				memcpy(coords + done * header_.dim, decoded_.data() + decodedPos_ * header_.dim, (size_t)(take * header_.dim * sizeof(double)));
+				decodedPos_ += take;
+				done += take;
+			}
+			read_ += done;
+			return done;
+		}
+
+		if (!in_.read((char*)coords, (std::streamsize)(count * header_.dim * sizeof(double))))
+		{
+			failed_ = true;
+			return 0;
+		}
+		read_ += count;
+		return count;
+	}
+
+	// Every vector of the header was read: a short or failed read also ends a pass
+	bool complete() const
+	{
+		return !failed_ && read_ == header_.count;
+	}
+
+	RESULT_CODE rewind()
+	{
+		in_.clear();
+		in_.seekg((std::streamoff)header_.dataOffset);
+		read_ = 0;
+		failed_ = false;
+		block_ = 0;
+		decodedPos_ = decodedCount_ = 0;
+		return in_ ? RESULT_CODE::SUCCESS : RESULT_CODE::FILE_ERROR;
+	}
+};
@@ -1,5 +1,7 @@
 #include "IVector.h"
 #include "VectorImpl.cpp"
+#include "numeric/LogLevel.h"
+#include <limits>
 
 IVector* IVector::createVector(size_t dim, double* pData, ILogger* pLogger)
 {
@@ -17,6 +19,13 @@ IVector* IVector::createVector(size_t dim, double* pData, ILogger* pLogger)
 		return nullptr;
 	}
 
+	if (dim > std::numeric_limits<size_t>::max() / sizeof(double))
+	{
+		if (pLogger != nullptr)
+			pLogger->log("In [IVector::createVector] dim is too large", RESULT_CODE::WRONG_DIM);
+		return nullptr;
+	}
+
 	double* data = new (std::nothrow)double[dim];
 	if (data == nullptr)
 	{
@@ -57,8 +66,7 @@ IVector* IVector::add(IVector const* pOperand1, IVector const* pOperand2, ILogge
 
 	if (pOperand1->getDim() != pOperand2->getDim())
 	{
-		if (pLogger != nullptr)
-			pLogger->log("In [IVector::add] operands dimension should be the same", RESULT_CODE::OUT_OF_BOUNDS);
+		UI_LOG_FAILURE_RECORD(pLogger, MESSAGE_ID::VECTOR_ADD_DIM, RESULT_CODE::OUT_OF_BOUNDS, pOperand1->getDim(), pOperand2->getDim());
 		return nullptr;
 	}
 
@@ -103,8 +111,7 @@ IVector* IVector::sub(IVector const* pOperand1, IVector const* pOperand2, ILogge
 
 	if (pOperand1->getDim() != pOperand2->getDim())
 	{
-		if (pLogger != nullptr)
-			pLogger->log("In [IVector::sub] operands dimension should be the same", RESULT_CODE::OUT_OF_BOUNDS);
+		UI_LOG_FAILURE_RECORD(pLogger, MESSAGE_ID::VECTOR_SUB_DIM, RESULT_CODE::OUT_OF_BOUNDS, pOperand1->getDim(), pOperand2->getDim());
 		return nullptr;
 	}
 
@@ -181,8 +188,7 @@ double IVector::mul(IVector const* pOperand1, IVector const* pOperand2, ILogger*
 
 	if (pOperand1->getDim() != pOperand2->getDim())
 	{
-		if (pLogger != nullptr)
-			pLogger->log("In [double IVector::mul] operands dimension should be the same", RESULT_CODE::OUT_OF_BOUNDS);
+		UI_LOG_FAILURE_RECORD(pLogger, MESSAGE_ID::VECTOR_MUL_DIM, RESULT_CODE::OUT_OF_BOUNDS, pOperand1->getDim(), pOperand2->getDim());
 		return 0;
 	}
 
@@ -219,8 +225,7 @@ RESULT_CODE IVector::equals(IVector const* pOperand1, IVector const* pOperand2,
 
 	if (pOperand1->getDim() != pOperand2->getDim())
 	{
-		if (pLogger != nullptr)
-			pLogger->log("In [IVector::equals] operands dimension should be the same", RESULT_CODE::OUT_OF_BOUNDS);
+		UI_LOG_FAILURE_RECORD(pLogger, MESSAGE_ID::VECTOR_EQUALS_DIM, RESULT_CODE::OUT_OF_BOUNDS, pOperand1->getDim(), pOperand2->getDim());
 		return RESULT_CODE::OUT_OF_BOUNDS;
 	}
 
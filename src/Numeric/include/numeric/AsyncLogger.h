@@ -0,0 +1,39 @@
+#pragma once
+#include "LogLevel.h"
+
+// ILogger that keeps disk I/O off the calling thread. log() copies the message into
+// a fixed-size record of a lock-free ring, a background thread writes records in batches.
+// Messages longer than MESSAGE_SIZE - 1 are truncated. The logger is deleted, after
+// writing every queued record, when its last client calls destroyLogger.
+class AsyncLogger : public ILeveledLogger
+{
+public:
+	static const size_t MESSAGE_SIZE = 240;
+
+	enum class OVERFLOW_POLICY
+	{
+		DROP,   // a full ring drops the record and counts it
+		BLOCK   // a full ring makes the caller wait for the writer
+	};
+
+	struct Params
+	{
+		size_t capacity = 4096;    // records in the ring, rounded up to a power of two
+		OVERFLOW_POLICY overflow = OVERFLOW_POLICY::DROP;
+		char const* fileName = "log.txt";
+		LogFileParams file;        // rotation and buffering of the file
+	};
+
+	static AsyncLogger* createLogger(void* pClient, Params const& params);
+
+	// Adds one more client to an existing logger
+	virtual void attach(void* pClient) = 0;
+
+	// Waits until every record logged before the call is written to the file
+	void flush() override = 0;
+
+	virtual size_t getDropped() const = 0;
+
+protected:
+	AsyncLogger() = default;
+};
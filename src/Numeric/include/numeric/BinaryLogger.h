@@ -0,0 +1,24 @@
+#pragma once
+#include "LogLevel.h"
+
+// ILogger writing compact binary records (see LogRecord.h) instead of text:
+// logRecord stores the message id and arguments, log stores a TEXT record.
+// tools/logdecode turns the file into text. The logger is deleted, after
+// writing its buffer, when its last client calls destroyLogger.
+class BinaryLogger : public ILeveledLogger
+{
+public:
+	static BinaryLogger* createLogger(void* pClient, char const* pFileName);
+
+	// Adds one more client to an existing logger
+	virtual void attach(void* pClient) = 0;
+
+	// Writes buffered records to the file
+	void flush() override = 0;
+
+	// Records lost to failed writes (a full disk)
+	virtual size_t getDropped() const = 0;
+
+protected:
+	BinaryLogger() = default;
+};
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+// How a text logger writes its file. Once the file would pass maxSize bytes it is renamed
+// to name.1 (name.1 to name.2 and so on) and a new one is started, at most maxFiles files
+// are kept. Lines are collected in memory and written in one call when bufferSize bytes
+// are pending or, checked on the next write only, flushMs have passed since the last
+// write. The async logger also checks flushMs while idle, otherwise call flush() to
+// write pending lines. The default logger uses a 4 KiB buffer unless params are given.
+struct LogFileParams
+{
+	size_t maxSize = 64 << 20;     // 0 for a single file that is never rotated
+	size_t maxFiles = 5;           // the current file included
+	size_t bufferSize = 64 << 10;  // 0 writes every line right away
+	unsigned flushMs = 1000;
+};
@@ -0,0 +1,124 @@
+#pragma once
+#include "ILogger.h"
+#include "LogRecord.h"
+#include "LogStats.h"
+#include "LogFile.h"
+#include <atomic>
+
+enum class LOG_LEVEL
+{
+	VERBOSE,
+	INFO,
+	WARNING,
+	FAILURE,
+	OFF
+};
+
+// Calls below this level are removed by the compiler, e.g. -DUI_LOG_MIN_LEVEL=3 keeps failures only
+#ifndef UI_LOG_MIN_LEVEL
+#define UI_LOG_MIN_LEVEL 0
+#endif
+
+// ILogger with a runtime threshold that callers can test before formatting a message
+class ILeveledLogger : public ILogger
+{
+private:
+	std::atomic<int> level_{ (int)LOG_LEVEL::INFO };
+
+public:
+	// The shared default logger, see ILogger::createLogger
+	static ILeveledLogger* createLogger(void* pClient);
+
+	LOG_LEVEL getLevel() const
+	{
+		return (LOG_LEVEL)level_.load(std::memory_order_relaxed);
+	}
+
+	void setLevel(LOG_LEVEL level)
+	{
+		level_.store((int)level, std::memory_order_relaxed);
+	}
+
+	bool isEnabled(LOG_LEVEL level) const
+	{
+		return level != LOG_LEVEL::OFF && (int)level >= level_.load(std::memory_order_relaxed);
+	}
+
+	using ILogger::setLogFile;
+
+	// File loggers rotate and buffer their file as params say, others take the name only
+	virtual RESULT_CODE setLogFile(char const* pLogFile, LogFileParams const& /*params*/)
+	{
+		return setLogFile(pLogFile);
+	}
+
+	// Writes buffered lines to the file
+	virtual void flush()
+	{}
+
+	// Structured record, text loggers format it right away
+	virtual void logRecord(MESSAGE_ID id, RESULT_CODE code, int64_t const* args, size_t argc)
+	{
+		log(formatMessage(id, args, argc).c_str(), code);
+	}
+
+protected:
+	ILeveledLogger() = default;
+};
+
+inline LOG_LEVEL levelOf(RESULT_CODE code)
+{
+	return code == RESULT_CODE::SUCCESS ? LOG_LEVEL::INFO : LOG_LEVEL::FAILURE;
+}
+
+// Loggers without a threshold take every message
+inline bool isLogEnabled(ILogger* pLogger, LOG_LEVEL level)
+{
+	if (pLogger == nullptr || (int)level < UI_LOG_MIN_LEVEL)
+		return false;
+
+	ILeveledLogger* leveled = dynamic_cast<ILeveledLogger*>(pLogger);
+	return leveled == nullptr || leveled->isEnabled(level);
+}
+
+// The message expression is evaluated only when it would be logged
+#define UI_LOG(pLogger, level, msg, code) \
+	do \
+	{ \
+		if ((int)(level) >= UI_LOG_MIN_LEVEL) \
+		{ \
+			LogStats::count((code)); \
+			if (isLogEnabled((pLogger), (level))) \
+				(pLogger)->log((msg), (code)); \
+		} \
+	} while (0)
+
+#define UI_LOG_FAILURE(pLogger, msg, code) UI_LOG(pLogger, LOG_LEVEL::FAILURE, msg, code)
+
+template<typename... Args>
+inline void logRecord(ILogger* pLogger, MESSAGE_ID id, RESULT_CODE code, Args... args)
+{
+	static_assert(sizeof...(Args) <= BinaryRecord::MAX_ARGS, "too many record arguments");
+	int64_t values[] = { 0, (int64_t)args... };
+
+	ILeveledLogger* leveled = dynamic_cast<ILeveledLogger*>(pLogger);
+	if (leveled != nullptr)
+		leveled->logRecord(id, code, values + 1, sizeof...(Args));
+	else
+		pLogger->log(formatMessage(id, values + 1, sizeof...(Args)).c_str(), code);
+}
+
+// Static message id and numeric arguments, e.g. UI_LOG_RECORD(pLogger, LOG_LEVEL::FAILURE, MESSAGE_ID::VECTOR_ADD_DIM, code, dim1, dim2).
+// Records past the LogStats limit are only counted.
+#define UI_LOG_RECORD(pLogger, level, id, code, ...) \
+	do \
+	{ \
+		if ((int)(level) >= UI_LOG_MIN_LEVEL) \
+		{ \
+			LogStats::count((id), (code)); \
+			if (isLogEnabled((pLogger), (level)) && LogStats::admit((id), (code), (pLogger))) \
+				logRecord((pLogger), (id), (code), __VA_ARGS__); \
+		} \
+	} while (0)
+
+#define UI_LOG_FAILURE_RECORD(pLogger, id, code, ...) UI_LOG_RECORD(pLogger, LOG_LEVEL::FAILURE, id, code, __VA_ARGS__)
@@ -0,0 +1,66 @@
+#pragma once
+#include "ILogger.h"
+#include <string>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+// Static messages: the log keeps only the id and the numeric arguments,
+// the text is put together when the record is read. "{}" stands for the next argument,
+// "{msg}" for the format of the message whose id is the next argument.
+// Append new messages at the end, ids of binary logs already written must not change.
+#define UI_LOG_MESSAGES(X) \
+	X(TEXT, "{}") \
+	X(VECTOR_ADD_DIM, "In [IVector::add] operands dimension should be the same, got {} and {}") \
+	X(VECTOR_SUB_DIM, "In [IVector::sub] operands dimension should be the same, got {} and {}") \
+	X(VECTOR_MUL_DIM, "In [double IVector::mul] operands dimension should be the same, got {} and {}") \
+	X(VECTOR_EQUALS_DIM, "In [IVector::equals] operands dimension should be the same, got {} and {}") \
+	X(SUPPRESSED, "{} more occurrences in last {} ms of: {msg}")
+
+enum class MESSAGE_ID : uint16_t
+{
+#define UI_LOG_MESSAGE_ID(name, text) name,
+	UI_LOG_MESSAGES(UI_LOG_MESSAGE_ID)
+#undef UI_LOG_MESSAGE_ID
+	COUNT
+};
+
+char const* messageFormat(MESSAGE_ID id);
+char const* codeName(RESULT_CODE code);
+
+// Text of a record, missing arguments are left as "{}"
+std::string formatMessage(MESSAGE_ID id, int64_t const* args, size_t argc);
+
+// Binary log file: BinaryLogHeader, then records one after another.
+// TEXT records have one argument, the byte length of the text that follows
+// (at most BinaryRecord::MAX_TEXT, longer texts are cut), padded with zeros to 8 bytes.
+struct BinaryLogHeader
+{
+	static const uint32_t VERSION = 1;
+
+	char magic[8];
+	uint32_t version;
+	uint32_t messages;  // MESSAGE_ID::COUNT of the writer
+
+	static void const* magicValue()
+	{
+		return "UILOG\r\n";
+	}
+};
+
+struct BinaryRecord
+{
+	static const size_t MAX_ARGS = 8;
+	static const size_t MAX_TEXT = 1 << 20;
+
+	uint64_t timestamp;  // ns since the epoch
+	uint32_t thread;     // small number given to each thread on its first record
+	uint16_t id;
+	uint8_t code;
+	uint8_t argc;
+};
+
+// Writes every record of a binary log as a text line "seconds.nanoseconds t<thread> message CODE"
+RESULT_CODE decodeBinaryLog(char const* pFileName, std::ostream& out);
+
+static_assert(sizeof(BinaryLogHeader) == 16 && sizeof(BinaryRecord) == 16, "binary log layout must not change");
@@ -0,0 +1,43 @@
+#pragma once
+#include "LogRecord.h"
+
+// Process-wide counters of logged failures and rate limiting of static messages.
+// Counters are kept even when no logger takes the message. Past the burst, further
+// records of a message in the same period are dropped and collapse into one
+// SUPPRESSED record ("N more occurrences in last T ms") when the period ends. The
+// summary goes to the logger the dropped records were meant for. Library loggers
+// report pending summaries on flush and release themselves before they are deleted,
+// other loggers that take rate-limited records call release(this) before they are deleted.
+class LogStats
+{
+public:
+	struct Limit
+	{
+		size_t burst = 100;       // records of one message logged per period, 0 - no limit
+		size_t periodMs = 1000;
+	};
+
+	static void setLimit(Limit const& limit);
+	static Limit getLimit();
+
+	static size_t getCount(RESULT_CODE code);
+	static size_t getCount(MESSAGE_ID id);
+	static size_t getSuppressed(MESSAGE_ID id);
+	static void reset();
+
+	// Logs SUPPRESSED records of pLogger for periods that are not over yet
+	static void flushSummaries(ILogger* pLogger);
+
+	// Logs SUPPRESSED records of pLogger for periods that are over, for loggers that
+	// wake up on their own (no record has to come to end the period)
+	static void flushExpiredSummaries(ILogger* pLogger);
+
+	// Logs what is pending for pLogger and waits until no other thread is reporting to it,
+	// after that pLogger can be deleted. Must not be called while holding a lock the logger takes.
+	static void release(ILogger* pLogger);
+
+	// Used by the logging macros
+	static void count(RESULT_CODE code);
+	static void count(MESSAGE_ID id, RESULT_CODE code);
+	static bool admit(MESSAGE_ID id, RESULT_CODE code, ILogger* pLogger);
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include "ISet.h"
+
+// Set with random-projection buckets for NORM_2 tolerance search in high dimensions.
+// NORM_2 lookups only inspect colliding buckets, so they may miss a near vector;
+// every candidate is verified exactly. Other norms fall back to a full scan.
+class LshSet : public ISet
+{
+public:
+	struct Params
+	{
+		size_t tables = 8;          // L: more tables - higher recall, slower queries
+		size_t hashesPerTable = 4;  // K: more hashes - smaller buckets, lower recall
+		double bucketWidth = 1.0;   // w: should be a few times the tolerance in use
+		size_t probes = 0;          // extra neighbouring buckets checked per table, up to K
+		unsigned seed = 0;
+	};
+
+	static LshSet* createSet(Params const& params, ILogger* pLogger);
+
+	virtual Params getParams() const = 0;
+
+protected:
+	LshSet() = default;
+};
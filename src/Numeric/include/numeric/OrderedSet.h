@@ -0,0 +1,30 @@
+#pragma once
+#include "ISet.h"
+#include <vector>
+
+// Set with a selectable memory layout. get(index) always follows insertion order,
+// only the order of coordinates in storage changes.
+class OrderedSet : public ISet
+{
+public:
+	enum class LAYOUT
+	{
+		INSERTION,  // storage follows insertion order
+		MORTON      // storage is kept (mostly) sorted along the Z-order curve
+	};
+
+	static OrderedSet* createSet(LAYOUT layout, ILogger* pLogger);
+
+	virtual LAYOUT getLayout() const = 0;
+	virtual void reorder() = 0;  // sort all pending elements into layout order now
+
+	// Position of element index in storage, index < getSize()
+	virtual size_t getSlot(size_t index) const = 0;
+
+	// Indices of all elements near pSample, in storage order. MORTON only visits the curve
+	// range of the tolerance box and the elements not sorted yet.
+	virtual RESULT_CODE findAll(IVector const* pSample, IVector::NORM norm, double tolerance, std::vector<size_t>& indices) const = 0;
+
+protected:
+	OrderedSet() = default;
+};
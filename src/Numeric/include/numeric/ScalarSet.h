@@ -0,0 +1,203 @@
+#pragma once
+#include "ScalarVector.h"
+#include <vector>
+
+// Set of ScalarVector with the semantics of ISet: an insert is skipped if an element is
+// near it (so a zero tolerance keeps duplicates), operations keep the order of the first
+// operand. Coordinates are stored element after element in one array.
+template<Scalar T>
+class ScalarSet
+{
+private:
+	typedef ScalarVector<T> Vector;
+
+	size_t dim_ = 0;
+	std::vector<T> data_;
+
+	T const* element(size_t index) const
+	{
+		return data_.data() + index * dim_;
+	}
+
+	static RESULT_CODE validate(const ScalarSet& a, const ScalarSet& b, const T& tolerance)
+	{
+		if (tolerance < ScalarTraits<T>::zero())
+			return RESULT_CODE::WRONG_ARGUMENT;
+		if (a.dim_ == 0 || b.dim_ == 0 || a.dim_ != b.dim_)
+			return RESULT_CODE::WRONG_DIM;
+		return RESULT_CODE::SUCCESS;
+	}
+
+public:
+	size_t getDim() const
+	{
+		return dim_;
+	}
+
+	size_t getSize() const
+	{
+		return dim_ == 0 ? 0 : data_.size() / dim_;
+	}
+
+	void clear()
+	{
+		dim_ = 0;
+		data_.clear();
+	}
+
+	// index of the first element near sample, if there is one
+	bool find(const Vector& sample, IVector::NORM norm, const T& tolerance, size_t& index) const
+	{
+		if (sample.getDim() != dim_)
+			return false;
+
+		size_t size = getSize();
+		for (size_t i = 0; i < size; i++)
+			if (Vector::isNear(element(i), sample.getData(), dim_, norm, tolerance))
+			{
+				index = i;
+				return true;
+			}
+		return false;
+	}
+
+	RESULT_CODE insert(const Vector& vector, IVector::NORM norm, const T& tolerance)
+	{
+		if (tolerance < ScalarTraits<T>::zero())
+			return RESULT_CODE::WRONG_ARGUMENT;
+		if (vector.getDim() == 0)
+			return RESULT_CODE::WRONG_DIM;
+
+		if (getSize() == 0)
+			dim_ = vector.getDim();
+		else if (dim_ != vector.getDim())
+			return RESULT_CODE::WRONG_DIM;
+		else
+		{
+			size_t found;
+			if (find(vector, norm, tolerance, found))
+				return RESULT_CODE::SUCCESS;
+		}
+
+		data_.insert(data_.end(), vector.getData(), vector.getData() + dim_);
+		return RESULT_CODE::SUCCESS;
+	}
+
+	RESULT_CODE get(Vector& res, size_t index) const
+	{
+		if (index >= getSize())
+			return RESULT_CODE::OUT_OF_BOUNDS;
+
+		res = Vector(std::vector<T>(element(index), element(index) + dim_));
+		return RESULT_CODE::SUCCESS;
+	}
+
+	RESULT_CODE erase(size_t index)
+	{
+		if (index >= getSize())
+			return RESULT_CODE::OUT_OF_BOUNDS;
+
+		data_.erase(data_.begin() + index * dim_, data_.begin() + (index + 1) * dim_);
+		if (data_.empty())
+			clear();
+		return RESULT_CODE::SUCCESS;
+	}
+
+	// Erases every element near sample
+	RESULT_CODE erase(const Vector& sample, IVector::NORM norm, const T& tolerance)
+	{
+		if (tolerance < ScalarTraits<T>::zero())
+			return RESULT_CODE::WRONG_ARGUMENT;
+		if (sample.getDim() != dim_)
+			return RESULT_CODE::WRONG_DIM;
+
+		size_t kept = 0, size = getSize();
+		for (size_t i = 0; i < size; i++)
+		{
+			if (Vector::isNear(element(i), sample.getData(), dim_, norm, tolerance))
+				continue;
+			if (kept != i)
+				for (size_t j = 0; j < dim_; j++)
+					data_[kept * dim_ + j] = std::move(data_[i * dim_ + j]);
+			kept++;
+		}
+		data_.resize(kept * dim_, ScalarTraits<T>::zero());
+		if (data_.empty())
+			clear();
+		return RESULT_CODE::SUCCESS;
+	}
+
+	static RESULT_CODE add(const ScalarSet& a, const ScalarSet& b, IVector::NORM norm, const T& tolerance, ScalarSet& res)
+	{
+		RESULT_CODE code = validate(a, b, tolerance);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		ScalarSet sum = a;
+		Vector vector;
+		for (size_t i = 0; i < b.getSize(); i++)
+		{
+			b.get(vector, i);
+			sum.insert(vector, norm, tolerance);
+		}
+		res = std::move(sum);
+		return RESULT_CODE::SUCCESS;
+	}
+
+	// Elements of b near an element of a
+	static RESULT_CODE intersect(const ScalarSet& a, const ScalarSet& b, IVector::NORM norm, const T& tolerance, ScalarSet& res)
+	{
+		RESULT_CODE code = validate(a, b, tolerance);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		ScalarSet common;
+		Vector vector;
+		for (size_t i = 0; i < a.getSize(); i++)
+		{
+			size_t found;
+			a.get(vector, i);
+			if (b.find(vector, norm, tolerance, found))
+			{
+				b.get(vector, found);
+				common.insert(vector, norm, tolerance);
+			}
+		}
+		res = std::move(common);
+		return RESULT_CODE::SUCCESS;
+	}
+
+	static RESULT_CODE sub(const ScalarSet& a, const ScalarSet& b, IVector::NORM norm, const T& tolerance, ScalarSet& res)
+	{
+		RESULT_CODE code = validate(a, b, tolerance);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		ScalarSet difference = a;
+		Vector vector;
+		for (size_t i = 0; i < b.getSize() && difference.getSize() > 0; i++)
+		{
+			b.get(vector, i);
+			difference.erase(vector, norm, tolerance);
+		}
+		res = std::move(difference);
+		return RESULT_CODE::SUCCESS;
+	}
+
+	static RESULT_CODE symSub(const ScalarSet& a, const ScalarSet& b, IVector::NORM norm, const T& tolerance, ScalarSet& res)
+	{
+		RESULT_CODE code = validate(a, b, tolerance);
+		if (code != RESULT_CODE::SUCCESS)
+			return code;
+
+		ScalarSet sum, common;
+		add(a, b, norm, tolerance, sum);
+		intersect(a, b, norm, tolerance, common);
+		if (common.getSize() == 0)
+		{
+			res = std::move(sum);
+			return RESULT_CODE::SUCCESS;
+		}
+		return sub(sum, common, norm, tolerance, res);
+	}
+};
@@ -0,0 +1,129 @@
+#pragma once
+#include "models/Rational.h"
+#include "models/RationalAccumulator.h"
+#include "models/RealD.h"
+#include <concepts>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// What ScalarVector and ScalarSet need from a coordinate type, specialized per scalar.
+// EXACT scalars have no square root: NORM_2 comparisons use squares instead.
+template<typename T>
+struct ScalarTraits;
+
+template<>
+struct ScalarTraits<double>
+{
+	static const bool EXACT = false;
+
+	static double zero() { return 0.0; }
+	static double abs(double x) { return std::fabs(x); }
+	static double max(double a, double b) { return std::max(a, b); }
+	static double root(double x) { return std::sqrt(x); }
+
+	// Four independent sums keep the adds pipelined
+	static double dot(const double* a, const double* b, size_t dim)
+	{
+		double sums[4] = {};
+		size_t i = 0;
+		for (; i + 4 <= dim; i += 4)
+			for (size_t j = 0; j < 4; j++)
+				sums[j] += a[i + j] * b[i + j];
+		for (; i < dim; i++)
+			sums[0] += a[i] * b[i];
+		return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+	}
+};
+
+template<>
+struct ScalarTraits<float>
+{
+	static const bool EXACT = false;
+
+	static float zero() { return 0.0f; }
+	static float abs(float x) { return std::fabs(x); }
+	static float max(float a, float b) { return std::max(a, b); }
+	static float root(float x) { return std::sqrt(x); }
+
+	// Summed in double, float products are exact there
+	static float dot(const float* a, const float* b, size_t dim)
+	{
+		double sum = 0;
+		for (size_t i = 0; i < dim; i++)
+			sum += (double)a[i] * b[i];
+		return (float)sum;
+	}
+};
+
+template<>
+struct ScalarTraits<Rational>
+{
+	static const bool EXACT = true;
+
+	static Rational zero() { return Rational(0); }
+	static Rational abs(const Rational& x) { return x.sign() < 0 ? -x : x; }
+	static Rational max(const Rational& a, const Rational& b) { return std::max(a, b); }
+
+	// Over one common denominator, reduced once at the end
+	static Rational dot(const Rational* a, const Rational* b, size_t dim)
+	{
+		RationalAccumulator sum;
+		sum.addDot(a, b, dim);
+		return sum.getSum();
+	}
+};
+
+template<>
+struct ScalarTraits<Real>
+{
+	static const bool EXACT = true;
+
+	static Real zero() { return Real(Rational(0), Rational(0)); }
+
+	static Real abs(const Real& x)
+	{
+		if (x.getLower().sign() >= 0)
+			return x;
+		if (x.getUpper().sign() <= 0)
+			return -x;
+		return Real(Rational(0), std::max(-x.getLower(), x.getUpper()));
+	}
+
+	// Bound by bound, Real's < only holds for disjoint intervals
+	static Real max(const Real& a, const Real& b)
+	{
+		return Real(std::max(a.getLower(), b.getLower()), std::max(a.getUpper(), b.getUpper()));
+	}
+
+	// Widened to the outward-rounded RealD sum, which encloses the exact one. Exact
+	// if a bound leaves the double range.
+	static Real dot(const Real* a, const Real* b, size_t dim)
+	{
+		RealD sum(0.0);
+		for (size_t i = 0; i < dim; i++)
+			sum += RealD(a[i]) * RealD(b[i]);
+		Real res = sum.toReal();
+		if (!res.isNaN())
+			return res;
+
+		Real exact = zero();
+		for (size_t i = 0; i < dim; i++)
+			exact += a[i] * b[i];
+		return exact;
+	}
+};
+
+template<typename T>
+concept Scalar = std::copyable<T> && requires(T a, const T& b, const T* p, size_t n)
+{
+	{ ScalarTraits<T>::zero() } -> std::convertible_to<T>;
+	{ ScalarTraits<T>::abs(b) } -> std::convertible_to<T>;
+	{ ScalarTraits<T>::max(b, b) } -> std::convertible_to<T>;
+	{ ScalarTraits<T>::dot(p, p, n) } -> std::convertible_to<T>;
+	{ ScalarTraits<T>::EXACT } -> std::convertible_to<bool>;
+	a += b;
+	a -= b;
+	a *= b;
+	{ b < b } -> std::convertible_to<bool>;
+};
@@ -0,0 +1,214 @@
+#pragma once
+#include "IVector.h"
+#include "ScalarTraits.h"
+#include <vector>
+#include <utility>
+
+// Vector over any Scalar (double, float, Rational, Real) with the operations of IVector.
+// A value type: coordinates are owned, copies are deep.
+template<Scalar T>
+class ScalarVector
+{
+private:
+	typedef ScalarTraits<T> Traits;
+
+	std::vector<T> data_;
+
+public:
+	ScalarVector() = default;
+
+	explicit ScalarVector(size_t dim)
+		: data_(dim, Traits::zero())
+	{}
+
+	explicit ScalarVector(std::vector<T> coords)
+		: data_(std::move(coords))
+	{}
+
+	size_t getDim() const
+	{
+		return data_.size();
+	}
+
+	// index < getDim()
+	const T& getCoord(size_t index) const
+	{
+		return data_[index];
+	}
+
+	RESULT_CODE setCoord(size_t index, const T& value)
+	{
+		if (index >= data_.size())
+			return RESULT_CODE::OUT_OF_BOUNDS;
+
+		data_[index] = value;
+		return RESULT_CODE::SUCCESS;
+	}
+
+	const T* getData() const
+	{
+		return data_.data();
+	}
+
+	// NORM_2 of an EXACT scalar is its square, there is no exact root. Squares are of
+	// magnitudes, so an interval square stays non-negative.
+	T norm(IVector::NORM norm) const
+	{
+		T value = Traits::zero();
+		switch (norm)
+		{
+		case IVector::NORM::NORM_1:
+			for (const T& x : data_)
+				value += Traits::abs(x);
+			break;
+
+		case IVector::NORM::NORM_2:
+			for (const T& x : data_)
+			{
+				T square = Traits::abs(x);
+				square *= square;
+				value += square;
+			}
+			if constexpr (!Traits::EXACT)
+				value = Traits::root(value);
+			break;
+
+		case IVector::NORM::NORM_INF:
+			for (const T& x : data_)
+				value = Traits::max(value, Traits::abs(x));
+			break;
+
+		default:
+			break;
+		}
+		return value;
+	}
+
+	// Same predicate as sub(a, b).norm(norm) < tolerance, squared for NORM_2 of EXACT
+	// scalars. Partial sums only grow, so the scan stops as soon as the answer is known.
+	static bool isNear(const T* a, const T* b, size_t dim, IVector::NORM norm, const T& tolerance)
+	{
+		T value = Traits::zero();
+		switch (norm)
+		{
+		case IVector::NORM::NORM_1:
+			for (size_t i = 0; i < dim; i++)
+			{
+				T d = a[i];
+				d -= b[i];
+				value += Traits::abs(d);
+				if (!(value < tolerance))
+					return false;
+			}
+			return true;
+
+		case IVector::NORM::NORM_2:
+		{
+			T limit = tolerance;
+			if constexpr (Traits::EXACT)
+				limit *= tolerance;
+			for (size_t i = 0; i < dim; i++)
+			{
+				T d = a[i];
+				d -= b[i];
+				d = Traits::abs(d);
+				d *= d;
+				value += d;
+			}
+			if constexpr (!Traits::EXACT)
+				value = Traits::root(value);
+			return value < limit;
+		}
+
+		case IVector::NORM::NORM_INF:
+			for (size_t i = 0; i < dim; i++)
+			{
+				T d = a[i];
+				d -= b[i];
+				if (!(Traits::abs(d) < tolerance))
+					return false;
+			}
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	static RESULT_CODE add(const ScalarVector& a, const ScalarVector& b, ScalarVector& res)
+	{
+		if (a.getDim() != b.getDim())
+			return RESULT_CODE::WRONG_DIM;
+
+		res.data_.resize(a.getDim(), Traits::zero());
+		for (size_t i = 0; i < a.getDim(); i++)
+		{
+			T sum = a.data_[i];
+			sum += b.data_[i];
+			res.data_[i] = std::move(sum);
+		}
+		return RESULT_CODE::SUCCESS;
+	}
+
+	static RESULT_CODE sub(const ScalarVector& a, const ScalarVector& b, ScalarVector& res)
+	{
+		if (a.getDim() != b.getDim())
+			return RESULT_CODE::WRONG_DIM;
+
+		res.data_.resize(a.getDim(), Traits::zero());
+		for (size_t i = 0; i < a.getDim(); i++)
+		{
+			T difference = a.data_[i];
+			difference -= b.data_[i];
+			res.data_[i] = std::move(difference);
+		}
+		return RESULT_CODE::SUCCESS;
+	}
+
+	static RESULT_CODE mul(const ScalarVector& a, const T& scale, ScalarVector& res)
+	{
+		res.data_.resize(a.getDim(), Traits::zero());
+		for (size_t i = 0; i < a.getDim(); i++)
+		{
+			T product = a.data_[i];
+			product *= scale;
+			res.data_[i] = std::move(product);
+		}
+		return RESULT_CODE::SUCCESS;
+	}
+
+	static RESULT_CODE mul(const ScalarVector& a, const ScalarVector& b, T& res)
+	{
+		if (a.getDim() != b.getDim())
+			return RESULT_CODE::WRONG_DIM;
+
+		res = Traits::dot(a.data_.data(), b.data_.data(), a.getDim());
+		return RESULT_CODE::SUCCESS;
+	}
+
+	static RESULT_CODE equals(const ScalarVector& a, const ScalarVector& b, IVector::NORM norm, const T& tolerance, bool& result)
+	{
+		if (a.getDim() != b.getDim())
+			return RESULT_CODE::WRONG_DIM;
+		if (tolerance < Traits::zero())
+			return RESULT_CODE::WRONG_ARGUMENT;
+
+		result = isNear(a.data_.data(), b.data_.data(), a.getDim(), norm, tolerance);
+		return RESULT_CODE::SUCCESS;
+	}
+
+	// Copies of IVector coordinates, for double and float only
+	static ScalarVector fromIVector(IVector const* pVector) requires std::floating_point<T>
+	{
+		ScalarVector res(pVector->getDim());
+		for (size_t i = 0; i < res.getDim(); i++)
+			res.data_[i] = (T)pVector->getCoord(i);
+		return res;
+	}
+
+	IVector* toIVector(ILogger* pLogger) const requires std::floating_point<T>
+	{
+		std::vector<double> coords(data_.begin(), data_.end());
+		return IVector::createVector(coords.size(), coords.data(), pLogger);
+	}
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "ISet.h"
+
+// Versioned binary snapshots of sets and vectors.
+// loadMapped serves the coordinates straight from a memory-mapped file:
+// no copy and no duplicate checks until the set is first modified.
+// saveCompressed sorts vectors along the Morton curve and encodes them losslessly
+// in blocks of blockSize (up to 65536) vectors, each column as exact decimals or
+// XOR with the previous value; loadMapped decodes such files into owned storage
+// and SnapshotBlocks reads single blocks. Insertion order is not kept.
+class SetSnapshot
+{
+public:
+	static const size_t BLOCK_SIZE = 1024;
+
+	static RESULT_CODE save(ISet const* pSet, char const* pFileName, ILogger* pLogger);
+	static RESULT_CODE saveCompressed(ISet const* pSet, char const* pFileName, size_t blockSize, ILogger* pLogger);
+	static ISet* loadMapped(char const* pFileName, ILogger* pLogger);
+
+	static RESULT_CODE save(IVector const* pVector, char const* pFileName, ILogger* pLogger);
+	static IVector* loadVector(char const* pFileName, ILogger* pLogger);
+};
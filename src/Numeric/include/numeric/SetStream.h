@@ -0,0 +1,23 @@
+#pragma once
+#include "ISet.h"
+
+// Set operations on snapshot files (see SetSnapshot) that need not fit in memory.
+// Operands are split into slabs along the coordinate whose sample splits best and
+// spilled to disk, vectors within tolerance of a slab border are copied to the neighbour slab,
+// so every slab is processed on its own. Slab borders are quantiles of a sample, a slab
+// that still doesn't fit is split again. Result order follows the slabs.
+// OUT_OF_MEMORY if vectors that can't be split (closer than 3 tolerances on that
+// coordinate) don't fit in memoryLimit.
+class SetStream
+{
+public:
+	struct Params
+	{
+		size_t memoryLimit = 256u << 20;  // bytes for slab data, its index, samples and spill buffers
+		char const* tempDir = ".";        // directory for spilled runs
+	};
+
+	static RESULT_CODE add(char const* pOperand1, char const* pOperand2, char const* pResult, IVector::NORM norm, double tolerance, Params const& params, ILogger* pLogger);
+	static RESULT_CODE intersect(char const* pOperand1, char const* pOperand2, char const* pResult, IVector::NORM norm, double tolerance, Params const& params, ILogger* pLogger);
+	static RESULT_CODE sub(char const* pOperand1, char const* pOperand2, char const* pResult, IVector::NORM norm, double tolerance, Params const& params, ILogger* pLogger);
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include "ISet.h"
+
+// Block-level random access to a snapshot file (see SetSnapshot) without loading it whole.
+// Compressed snapshots keep their block size, plain ones are cut into BLOCK_SIZE blocks.
+class SnapshotBlocks
+{
+public:
+	static const size_t BLOCK_SIZE = 1024;
+
+	static SnapshotBlocks* open(char const* pFileName, ILogger* pLogger);
+
+	virtual size_t getDim() const = 0;
+	virtual size_t getSize() const = 0;
+	virtual size_t getBlockCount() const = 0;
+	virtual size_t getBlockSize() const = 0;
+
+	// Vectors of the block (getBlockSize(), fewer in the last one), dim coordinates each
+	virtual size_t getBlockLength(size_t block) const = 0;
+	virtual RESULT_CODE decodeBlock(size_t block, double* coords) const = 0;
+
+	virtual ~SnapshotBlocks() = 0;
+
+protected:
+	SnapshotBlocks() = default;
+
+private:
+	SnapshotBlocks(SnapshotBlocks const&) = delete;
+	SnapshotBlocks& operator=(SnapshotBlocks const&) = delete;
+};
@@ -6,5 +6,5 @@
 	_CrtSetDbgFlag(_CRTDBG_LEAK_CHECK_DF | _CRTDBG_CHECK_ALWAYS_DF | _CRTDBG_ALLOC_MEM_DF \
 | _CrtSetDbgFlag(_CRTDBG_REPORT_FLAG))
 #else
-#define SetDbgMemHooks() ((VOID)0)
+#define SetDbgMemHooks() ((void)0)
 #endif
\ No newline at end of file
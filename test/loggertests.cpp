@@ -0,0 +1,447 @@
+#include "loggertests.h"
+#include "ISet.h"
+#include <thread>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <chrono>
+#include <limits>
+#include <csignal>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+	void logFromThreads(ILogger* logger, size_t threads, size_t perThread)
+	{
+		std::vector<std::thread> workers;
+		for (size_t t = 0; t < threads; t++)
+			workers.emplace_back([=]() {
+				std::string msg = "thread " + std::to_string(t) + " message ";
+				for (size_t i = 0; i < perThread; i++)
+					logger->log((msg + std::to_string(i)).c_str(), RESULT_CODE::WRONG_DIM);
+			});
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	// Counts calls, no output
+	class CountingLogger : public ILogger
+	{
+	public:
+		size_t calls = 0;
+		std::string last;
+
+		~CountingLogger()
+		{
+			LogStats::release(this);
+		}
+
+		void destroyLogger(void* /*pClient*/) override {}
+		void log(char const* pMsg, RESULT_CODE /*err*/) override { calls++; last = pMsg; }
+		RESULT_CODE setLogFile(char const* /*pLogFile*/) override { return RESULT_CODE::SUCCESS; }
+	};
+
+	char const* countedMessage(size_t& evaluated)
+	{
+		evaluated++;
+		return "message";
+	}
+
+	long fileSize(char const* pFileName)
+	{
+		std::ifstream in(pFileName, std::ifstream::binary | std::ifstream::ate);
+		return in.is_open() ? (long)in.tellg() : -1;
+	}
+
+	void readLines(char const* pFileName, std::vector<std::string>& lines)
+	{
+		std::ifstream in(pFileName);
+		std::string line;
+		while (std::getline(in, line))
+			lines.push_back(line);
+	}
+}
+
+void Logger1::test()
+{
+	AsyncLogger::Params params;
+	params.capacity = 64;
+	params.overflow = AsyncLogger::OVERFLOW_POLICY::BLOCK;
+	params.fileName = "async_block.txt";
+	AsyncLogger* logger = AsyncLogger::createLogger(this, params);
+	_INEQ_(logger, (AsyncLogger*)nullptr);
+
+	logFromThreads(logger, 4, 1000);
+	std::string longMsg(1000, 'x');
+	logger->log(longMsg.c_str(), RESULT_CODE::SUCCESS);
+
+	// CHECK: flush writes every record, a full ring blocks instead of dropping
+	logger->flush();
+	std::vector<std::string> lines;
+	readLines("async_block.txt", lines);
+	_EQ_(lines.size(), (size_t)4001);
+	_EQ_(logger->getDropped(), (size_t)0);
+
+	// CHECK: long messages are truncated to a record
+	_EQ_(lines.back().size(), AsyncLogger::MESSAGE_SIZE - 1);
+
+	// CHECK: the last client's destroyLogger writes what is still queued
+	logger->attach(&lines);
+	logger->log("last", RESULT_CODE::SUCCESS);
+	logger->destroyLogger(this);
+	logger->destroyLogger(&lines);
+	lines.clear();
+	readLines("async_block.txt", lines);
+	_EQ_(lines.back(), std::string("last"));
+
+	std::remove("async_block.txt");
+}
+
+void Logger2::test()
+{
+	AsyncLogger::Params params;
+
+	// CHECK: a ring that can't be allocated is reported, not thrown
+	params.capacity = 0;
+	_EQ_(AsyncLogger::createLogger(this, params), (AsyncLogger*)nullptr);
+	params.capacity = std::numeric_limits<size_t>::max();
+	_EQ_(AsyncLogger::createLogger(this, params), (AsyncLogger*)nullptr);
+
+	params.capacity = 4;
+	params.fileName = "async_drop.txt";
+	AsyncLogger* logger = AsyncLogger::createLogger(this, params);
+
+	logFromThreads(logger, 4, 2000);
+	size_t dropped = logger->getDropped();
+	logger->destroyLogger(this);
+
+	// CHECK: every record is either written or counted in a drop summary
+	std::vector<std::string> lines;
+	readLines("async_drop.txt", lines);
+	size_t written = 0;
+	size_t summarized = 0;
+	for (std::string const& line : lines)
+	{
+		if (line.compare(0, 14, "[AsyncLogger] ") == 0)
+			summarized += std::stoul(line.substr(14));
+		else
+			written++;
+	}
+	_EQ_(written + dropped, (size_t)8000);
+	_EQ_(summarized, dropped);
+
+	std::remove("async_drop.txt");
+}
+
+void Logger3::test()
+{
+	// CHECK: successful set operations don't touch the logger
+	CountingLogger counting;
+	ISet* set1 = ISet::createSet(&counting);
+	ISet* set2 = ISet::createSet(&counting);
+	double data[2] = { 1, 2 };
+	IVector* vec = IVector::createVector(2, data, &counting);
+	set1->insert(vec, IVector::NORM::NORM_2, 0.1);
+	set2->insert(vec, IVector::NORM::NORM_2, 0.1);
+	ISet* sum = ISet::add(set1, set2, IVector::NORM::NORM_2, 0.1, &counting);
+	_EQ_(counting.calls, (size_t)0);
+
+	// CHECK: failures still are
+	ISet* bad = ISet::add(set1, nullptr, IVector::NORM::NORM_2, 0.1, &counting);
+	_EQ_(counting.calls, (size_t)1);
+
+	// CHECK: messages below the threshold are neither formatted nor written
+	AsyncLogger::Params params;
+	params.fileName = "async_levels.txt";
+	AsyncLogger* logger = AsyncLogger::createLogger(this, params);
+	logger->setLevel(LOG_LEVEL::FAILURE);
+	size_t evaluated = 0;
+	UI_LOG(logger, LOG_LEVEL::INFO, countedMessage(evaluated), RESULT_CODE::SUCCESS);
+	_EQ_(evaluated, (size_t)0);
+	UI_LOG_FAILURE(logger, countedMessage(evaluated), RESULT_CODE::WRONG_DIM);
+	_EQ_(evaluated, (size_t)1);
+	logger->log("skipped", RESULT_CODE::SUCCESS);
+	logger->flush();
+
+	std::vector<std::string> lines;
+	readLines("async_levels.txt", lines);
+	_EQ_(lines.size(), (size_t)1);
+	_EQ_(isLogEnabled(nullptr, LOG_LEVEL::FAILURE), false);
+	_EQ_(isLogEnabled(&counting, LOG_LEVEL::VERBOSE), true);
+
+	logger->destroyLogger(this);
+	std::remove("async_levels.txt");
+	delete bad;
+	delete sum;
+	delete vec;
+	delete set1;
+	delete set2;
+}
+
+void Logger4::test()
+{
+	ILeveledLogger* logger = ILeveledLogger::createLogger(this);
+	logger->setLevel(LOG_LEVEL::FAILURE);
+
+	// CHECK: sets register with the shared logger from many threads at once
+	std::vector<std::thread> workers;
+	for (int t = 0; t < 4; t++)
+		workers.emplace_back([t]() {
+			double data[2] = { (double)t, 0 };
+			for (int i = 0; i < 500; i++)
+			{
+				ISet* set = ISet::createSet(nullptr);
+				IVector* vec = IVector::createVector(2, data, nullptr);
+				set->insert(vec, IVector::NORM::NORM_2, 0.1);
+				ISet* copy = set->clone();
+				delete copy;
+				delete vec;
+				delete set;
+			}
+		});
+	for (std::thread& worker : workers)
+		worker.join();
+
+	// CHECK: the logger outlives the sets and keeps its settings
+	_EQ_(ILeveledLogger::createLogger(nullptr), logger);
+	_EQ_(logger->getLevel(), LOG_LEVEL::FAILURE);
+
+	// CHECK: the last client resets it
+	logger->destroyLogger(this);
+	logger = ILeveledLogger::createLogger(this);
+	_EQ_(logger->getLevel(), LOG_LEVEL::INFO);
+	logger->destroyLogger(this);
+}
+
+void Logger5::test()
+{
+	BinaryLogger* logger = BinaryLogger::createLogger(this, "binary_log.bin");
+	_INEQ_(logger, (BinaryLogger*)nullptr);
+
+	// CHECK: static messages keep their arguments and codes
+	double data[3] = { 1, 2, 3 };
+	IVector* vec2 = IVector::createVector(2, data, logger);
+	IVector* vec3 = IVector::createVector(3, data, logger);
+	IVector* sum = IVector::add(vec2, vec3, logger);
+	_EQ_(sum, (IVector*)nullptr);
+	logger->log("plain text", RESULT_CODE::NOT_FOUND);
+	std::thread([logger]() {
+		UI_LOG_FAILURE_RECORD(logger, MESSAGE_ID::VECTOR_SUB_DIM, RESULT_CODE::WRONG_DIM, 4, -5);
+	}).join();
+	logger->flush();
+
+	std::ostringstream text;
+	_EQ_(decodeBinaryLog("binary_log.bin", text), RESULT_CODE::SUCCESS);
+	std::istringstream lines(text.str());
+	std::string line;
+	std::vector<std::string> tails;
+	while (std::getline(lines, line))
+		tails.push_back(line.substr(line.find(' ') + 1));
+
+	_EQ_(tails.size(), (size_t)3);
+	_EQ_(tails[0].find("In [IVector::add] operands dimension should be the same, got 2 and 3 OUT_OF_BOUNDS") != std::string::npos, true);
+	_EQ_(tails[1].find("plain text NOT_FOUND") != std::string::npos, true);
+	_EQ_(tails[2].find("In [IVector::sub] operands dimension should be the same, got 4 and -5 WRONG_DIM") != std::string::npos, true);
+	_INEQ_(tails[0].substr(0, tails[0].find(' ')), tails[2].substr(0, tails[2].find(' ')));
+
+	// CHECK: a text longer than the decoder accepts is cut, the log stays readable
+	std::string longText(BinaryRecord::MAX_TEXT + 100, 'x');
+	logger->log(longText.c_str(), RESULT_CODE::NOT_FOUND);
+	logger->flush();
+	text.str("");
+	_EQ_(decodeBinaryLog("binary_log.bin", text), RESULT_CODE::SUCCESS);
+	longText.resize(BinaryRecord::MAX_TEXT);
+	_EQ_(text.str().find(" " + longText + " NOT_FOUND\n") != std::string::npos, true);
+
+	// CHECK: text loggers format records right away
+	int64_t args[2] = { 7, 8 };
+	_EQ_(formatMessage(MESSAGE_ID::VECTOR_MUL_DIM, args, 1), std::string("In [double IVector::mul] operands dimension should be the same, got 7 and {}"));
+
+	logger->destroyLogger(this);
+	_EQ_(decodeBinaryLog("missing.bin", text), RESULT_CODE::FILE_ERROR);
+
+#ifndef _WIN32
+	// CHECK: records of a failed write are counted as dropped, the file stays readable
+	logger = BinaryLogger::createLogger(this, "binary_log.bin");
+	logger->log("written", RESULT_CODE::NOT_FOUND);
+	logger->flush();
+	rlimit limit;
+	getrlimit(RLIMIT_FSIZE, &limit);
+	rlimit small = limit;
+	small.rlim_cur = 4096;
+	void (*handler)(int) = std::signal(SIGXFSZ, SIG_IGN);
+	setrlimit(RLIMIT_FSIZE, &small);
+	std::string bulk(8000, 'x');
+	logger->log(bulk.c_str(), RESULT_CODE::NOT_FOUND);
+	logger->log("lost", RESULT_CODE::NOT_FOUND);
+	logger->flush();
+	setrlimit(RLIMIT_FSIZE, &limit);
+	std::signal(SIGXFSZ, handler);
+	_EQ_(logger->getDropped(), (size_t)2);
+	logger->log("after", RESULT_CODE::NOT_FOUND);
+	logger->destroyLogger(this);
+	text.str("");
+	_EQ_(decodeBinaryLog("binary_log.bin", text), RESULT_CODE::SUCCESS);
+	_EQ_(text.str().find("written NOT_FOUND") != std::string::npos, true);
+	_EQ_(text.str().find("lost") == std::string::npos, true);
+	_EQ_(text.str().find("after NOT_FOUND") != std::string::npos, true);
+#endif
+	std::remove("binary_log.bin");
+	delete vec2;
+	delete vec3;
+}
+
+void Logger6::test()
+{
+	LogStats::Limit defaults = LogStats::getLimit();
+	LogStats::Limit limit;
+	limit.burst = 5;
+	limit.periodMs = 50;
+	LogStats::setLimit(limit);
+	LogStats::reset();
+
+	CountingLogger counting;
+	double data[3] = { 1, 2, 3 };
+	IVector* vec2 = IVector::createVector(2, data, &counting);
+	IVector* vec3 = IVector::createVector(3, data, &counting);
+
+	// CHECK: a storm is counted in full but logged only up to the burst
+	for (int i = 0; i < 1000; i++)
+		IVector::add(vec2, vec3, &counting);
+	_EQ_(counting.calls, (size_t)5);
+	_EQ_(LogStats::getCount(MESSAGE_ID::VECTOR_ADD_DIM), (size_t)1000);
+	_EQ_(LogStats::getCount(RESULT_CODE::OUT_OF_BOUNDS), (size_t)1000);
+	_EQ_(LogStats::getSuppressed(MESSAGE_ID::VECTOR_ADD_DIM), (size_t)995);
+
+	// CHECK: the rest collapses into one summary when the period ends
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+	IVector::add(vec2, vec3, &counting);
+	_EQ_(counting.calls, (size_t)7);
+	IVector::sub(vec2, vec3, &counting);
+	_EQ_(counting.last.find("In [IVector::sub]") == 0, true);
+
+	for (int i = 0; i < 10; i++)
+		IVector::add(vec2, vec3, &counting);
+	LogStats::flushSummaries(&counting);
+	_EQ_(counting.last.find("6 more occurrences in last ") == 0, true);
+	_EQ_(counting.last.find("ms of: In [IVector::add]") != std::string::npos, true);
+
+	// CHECK: the summary goes to the logger whose records were dropped, not to the one that ends the period
+	CountingLogger other;
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+	size_t calls = counting.calls;
+	for (int i = 0; i < 10; i++)
+		IVector::add(vec2, vec3, &counting);
+	_EQ_(counting.calls, calls + 5);
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+	IVector::add(vec2, vec3, &other);
+	_EQ_(counting.calls, calls + 6);
+	_EQ_(counting.last.find("5 more occurrences in last ") == 0, true);
+	_EQ_(other.calls, (size_t)1);
+
+	// CHECK: a released logger gets what is pending at once, later records end up elsewhere
+	CountingLogger* gone = new CountingLogger();
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+	for (int i = 0; i < 10; i++)
+		IVector::add(vec2, vec3, gone);
+	LogStats::release(gone);
+	_EQ_(gone->calls, (size_t)6);
+	_EQ_(gone->last.find("5 more occurrences in last ") == 0, true);
+	delete gone;
+	calls = other.calls;
+	for (int i = 0; i < 10; i++)
+		IVector::add(vec2, vec3, &other);
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+	IVector::add(vec2, vec3, &counting);
+	_EQ_(other.last.find("10 more occurrences in last ") == 0, true);
+
+	// CHECK: an idle async logger reports a period that is over, flush reports one that is not
+	AsyncLogger::Params params;
+	params.fileName = "stats_async.txt";
+	params.file.bufferSize = 0;
+	AsyncLogger* async = AsyncLogger::createLogger(this, params);
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+	for (int i = 0; i < 10; i++)
+		IVector::add(vec2, vec3, async);
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	std::vector<std::string> lines;
+	readLines("stats_async.txt", lines);
+	_EQ_(lines.size(), (size_t)6);
+	_EQ_(lines.back().find("5 more occurrences in last ") == 0, true);
+
+	for (int i = 0; i < 10; i++)
+		IVector::add(vec2, vec3, async);
+	async->flush();
+	lines.clear();
+	readLines("stats_async.txt", lines);
+	_EQ_(lines.size(), (size_t)12);
+	_EQ_(lines.back().find("5 more occurrences in last ") == 0, true);
+	async->destroyLogger(this);
+	std::remove("stats_async.txt");
+
+	// CHECK: no limit logs everything
+	limit.burst = 0;
+	LogStats::setLimit(limit);
+	calls = counting.calls;
+	for (int i = 0; i < 100; i++)
+		IVector::add(vec2, vec3, &counting);
+	_EQ_(counting.calls, calls + 100);
+
+	LogStats::setLimit(defaults);
+	delete vec2;
+	delete vec3;
+}
+
+void Logger7::test()
+{
+	char const* fileNames[] = { "rotation.txt", "rotation.txt.1", "rotation.txt.2", "rotation.txt.3" };
+	LogFileParams params;
+	params.maxSize = 1000;
+	params.maxFiles = 3;
+	params.bufferSize = 256;
+	params.flushMs = 60000;
+
+	ILeveledLogger* logger = ILeveledLogger::createLogger(this);
+	_EQ_(logger->setLogFile(fileNames[0], params), RESULT_CODE::SUCCESS);
+
+	// CHECK: lines wait in the buffer until it fills
+	logger->log("line 0", RESULT_CODE::SUCCESS);
+	_EQ_(fileSize(fileNames[0]), 0L);
+	logger->flush();
+	_EQ_(fileSize(fileNames[0]), 7L);
+
+	// CHECK: files are rotated by size and only maxFiles are kept
+	for (int i = 1; i < 300; i++)
+		logger->log(("line " + std::to_string(i)).c_str(), RESULT_CODE::SUCCESS);
+	logger->flush();
+	for (int i = 0; i < 3; i++)
+	{
+		_INEQ_(fileSize(fileNames[i]), -1L);
+		_EQ_(fileSize(fileNames[i]) <= 1000L, true);
+	}
+	_EQ_(fileSize(fileNames[3]), -1L);
+
+	std::vector<std::string> lines;
+	readLines(fileNames[0], lines);
+	_EQ_(lines.back(), std::string("line 299"));
+	lines.clear();
+	readLines(fileNames[1], lines);
+	readLines(fileNames[0], lines);
+	for (size_t i = 1; i < lines.size(); i++)
+		_EQ_(std::stoi(lines[i].substr(5)), std::stoi(lines[i - 1].substr(5)) + 1);
+
+	// CHECK: the last client's destroyLogger writes the buffer
+	logger->log("last", RESULT_CODE::WRONG_DIM);
+	logger->destroyLogger(this);
+	lines.clear();
+	readLines(fileNames[0], lines);
+	_EQ_(lines.back(), std::string("last WRONG_DIM"));
+
+	for (char const* fileName : fileNames)
+		std::remove(fileName);
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "Test.h"
+#include "ILogger.h"
+#include "numeric/AsyncLogger.h"
+#include "numeric/LogLevel.h"
+#include "numeric/BinaryLogger.h"
+#include "numeric/LogStats.h"
+
+const std::string LOGGER_PREFIX = "Logger  ";
+
+class Logger1 : public Test
+{
+private:
+	void test() override;
+public:
+	Logger1() : Test(LOGGER_PREFIX + "AsyncBlock") {}
+};
+
+class Logger2 : public Test
+{
+private:
+	void test() override;
+public:
+	Logger2() : Test(LOGGER_PREFIX + "AsyncDrop") {}
+};
+
+class Logger3 : public Test
+{
+private:
+	void test() override;
+public:
+	Logger3() : Test(LOGGER_PREFIX + "Levels") {}
+};
+
+class Logger4 : public Test
+{
+private:
+	void test() override;
+public:
+	Logger4() : Test(LOGGER_PREFIX + "SharedClients") {}
+};
+
+class Logger5 : public Test
+{
+private:
+	void test() override;
+public:
+	Logger5() : Test(LOGGER_PREFIX + "BinaryRecords") {}
+};
+
+class Logger6 : public Test
+{
+private:
+	void test() override;
+public:
+	Logger6() : Test(LOGGER_PREFIX + "ErrorStorm") {}
+};
+
+class Logger7 : public Test
+{
+private:
+	void test() override;
+public:
+	Logger7() : Test(LOGGER_PREFIX + "Rotation") {}
+};
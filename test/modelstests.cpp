@@ -0,0 +1,871 @@
+#include "modelstests.h"
+#include <sstream>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <set>
+
+namespace
+{
+	// 1 + 1 / 2 + ... + 1 / n
+	constexpr Rational harmonic(int n)
+	{
+		Rational sum(0);
+		for (int k = 1; k <= n; k++)
+			sum += Rational(1, k);
+		return sum;
+	}
+
+	// C(n, 0) ... C(n, n)
+	template<size_t N>
+	constexpr std::array<Integer, N + 1> binomialRow()
+	{
+		std::array<Integer, N + 1> row;
+		row[0] = 1;
+		for (size_t k = 1; k <= N; k++)
+			row[k] = row[k - 1] * Integer((int)(N - k + 1)) / Integer((int)k);
+		return row;
+	}
+
+	// Built by the compiler, nothing runs at startup
+	constexpr Rational HARMONIC[] = { harmonic(1), harmonic(2), harmonic(3), harmonic(10) };
+	constexpr std::array<Integer, 21> BINOMIAL_20 = binomialRow<20>();
+	constexpr Real UNIT = Real(Rational(-1, 2), Rational(1, 2)) * Real(Rational(2), Rational(3));
+
+	static_assert(HARMONIC[2] == Rational(11, 6));
+	static_assert(HARMONIC[3] == Rational(7381, 2520));
+	static_assert(BINOMIAL_20[10] == Integer(184756));
+	static_assert(GCD(Integer(-84), Integer(36)) == Integer(12));
+	static_assert(UNIT == Real(Rational(-3, 2), Rational(3, 2)));
+	static_assert(RATIONAL_NaN.isNaN() && REAL_NaN.isNaN());
+	static_assert((Rational(1, 3) / Rational(0)).compare(Rational(1, 3)) == 0);
+	static_assert((Rational(1) + RATIONAL_NaN).compare(Rational(1)) == 0);
+	static_assert(Rational(1) < Rational(Integer(INT64_MAX), Integer(INT64_MAX - 1)));
+
+	// Deterministic decimal numbers of the given length
+	std::string randomDigits(size_t count, uint64_t& state)
+	{
+		std::string digits;
+		for (size_t i = 0; i < count; i++)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			digits += (char)('0' + (state >> 33) % 10);
+		}
+		if (digits[0] == '0')
+			digits[0] = '1';
+		return digits;
+	}
+
+	template<typename T>
+	std::string toString(T const& value)
+	{
+		std::ostringstream text;
+		text << value;
+		return text.str();
+	}
+
+	// Determinant and rank by Gaussian elimination in Rational arithmetic
+	Rational gaussDeterminant(const RationalMatrix& matrix, size_t& rank)
+	{
+		size_t rows = matrix.getRows(), cols = matrix.getCols();
+		std::vector<std::vector<Rational>> a(rows);
+		for (size_t i = 0; i < rows; i++)
+			for (size_t j = 0; j < cols; j++)
+				a[i].push_back(matrix.get(i, j));
+
+		Rational det(1);
+		rank = 0;
+		for (size_t c = 0; c < cols && rank < rows; c++)
+		{
+			size_t pivot = rank;
+			while (pivot < rows && a[pivot][c] == Rational(0))
+				pivot++;
+			if (pivot == rows)
+			{
+				det = Rational(0);
+				continue;
+			}
+			if (pivot != rank)
+			{
+				std::swap(a[pivot], a[rank]);
+				det = -det;
+			}
+			det *= a[rank][c];
+			for (size_t i = rank + 1; i < rows; i++)
+			{
+				Rational factor = a[i][c] / a[rank][c];
+				for (size_t j = c; j < cols; j++)
+					a[i][j] -= factor * a[rank][j];
+			}
+			rank++;
+		}
+		return rank < rows ? Rational(0) : det;
+	}
+
+	size_t handled = 0;
+	Error handledError;
+
+	void countError(const Error& error)
+	{
+		handled++;
+		handledError = error;
+	}
+
+	BigInteger fromString(std::string const& digits)
+	{
+		BigInteger res;
+		BigInteger::fromString(digits, res);
+		return res;
+	}
+}
+
+void Integer1::test()
+{
+	// CHECK: decimal conversion
+	BigInteger factorial(1);
+	for (int k = 2; k <= 30; k++)
+		factorial *= BigInteger(k);
+	_EQ_(factorial.toString(), std::string("265252859812191058636308480000000"));
+
+	uint64_t state = 7;
+	std::string digits = "-" + randomDigits(500, state);
+	_EQ_(fromString(digits).toString(), digits);
+	BigInteger parsed;
+	_EQ_(BigInteger::fromString("12x", parsed), false);
+	_EQ_(BigInteger::fromString("-", parsed), false);
+
+	// CHECK: Karatsuba products, (10^n - 1)^2 = 9..980..01
+	std::string nines(600, '9');
+	BigInteger x = fromString(nines);
+	_EQ_((x * x).toString(), std::string(599, '9') + "8" + std::string(599, '0') + "1");
+
+	// CHECK: a = q b + r with |r| < |b| and the sign of a, for short and long divisors
+	size_t sizes[][2] = { { 30, 5 }, { 200, 20 }, { 700, 350 }, { 1500, 1400 }, { 40, 60 } };
+	for (size_t* size : sizes)
+	{
+		BigInteger a = fromString(randomDigits(size[0], state));
+		BigInteger b = -fromString(randomDigits(size[1], state));
+		BigInteger q, r;
+		_EQ_(BigInteger::divide(a, b, q, r), true);
+		_EQ_(q * b + r, a);
+		_EQ_(r.isNegative(), false);
+		_EQ_(r < -b, true);
+		_EQ_((a * b) / b, a);
+		_EQ_((a * b) % a, BigInteger());
+	}
+	BigInteger q, r;
+	_EQ_(BigInteger::divide(x, BigInteger(), q, r), false);
+}
+
+void Integer2::test()
+{
+	// CHECK: results past int64_t become big and come back once they fit
+	Integer max(INT64_MAX);
+	Integer sum = max + Integer(1);
+	_EQ_(sum.isBig(), true);
+	std::ostringstream text;
+	text << sum;
+	_EQ_(text.str(), std::string("9223372036854775808"));
+	sum -= Integer(1);
+	_EQ_(sum.isBig(), false);
+	_EQ_(sum, max);
+
+	Integer product = Integer(INT32_MAX) * Integer(INT32_MAX);
+	_EQ_((int64_t)product, (int64_t)4611686014132420609LL);
+	_EQ_((Integer(INT64_MIN) / Integer(-1)).isBig(), true);
+	_EQ_(Integer(INT64_MIN) % Integer(-1), Integer(0));
+
+	Integer power(1);
+	for (int k = 0; k < 100; k++)
+		power *= Integer(3);
+	_EQ_(power > max, true);
+	for (int k = 0; k < 99; k++)
+		power /= Integer(3);
+	_EQ_(power, Integer(3));
+
+	std::istringstream in("-123456789012345678901234567890");
+	Integer parsed;
+	in >> parsed;
+	_EQ_(parsed.isBig(), true);
+	_EQ_(parsed < 0, true);
+	_EQ_(parsed % Integer(10), Integer(0));
+
+	// CHECK: Rational stays exact where int products overflowed
+	Rational harmonic(0);
+	for (int k = 1; k <= 30; k++)
+		harmonic += Rational(1, k);
+	text.str("");
+	text << harmonic;
+	_EQ_(text.str(), std::string("9304682830147 / 2329089562800"));
+}
+
+void Integer3::test()
+{
+	typedef FixedInteger<int32_t, CheckedOverflow> Checked32;
+	typedef FixedInteger<int32_t, SaturatingOverflow> Saturating32;
+	typedef FixedInteger<int32_t, WrappingOverflow> Wrapping32;
+	typedef FixedInteger<int32_t, WideningOverflow> Widening32;
+
+	// CHECK: checked keeps the value and reports the overflow
+	Checked32 checked(INT32_MAX);
+	_EQ_(checked.add(Checked32(1)), INTEGER_STATUS::OVERFLOW);
+	_EQ_(checked.get(), INT32_MAX);
+	_EQ_(checked.sub(Checked32(1)), INTEGER_STATUS::OK);
+	_EQ_(checked.div(Checked32(0)), INTEGER_STATUS::DIVIDED_BY_ZERO);
+	_EQ_(Checked32(INT32_MIN).div(Checked32(-1)), INTEGER_STATUS::OVERFLOW);
+	_EQ_((Checked32(INT32_MIN) % Checked32(-1)).get(), 0);
+
+	// CHECK: saturating clamps in the direction of the exact result
+	_EQ_((Saturating32(INT32_MAX) + Saturating32(5)).get(), INT32_MAX);
+	_EQ_((Saturating32(INT32_MIN) - Saturating32(5)).get(), INT32_MIN);
+	_EQ_((Saturating32(-70000) * Saturating32(70000)).get(), INT32_MIN);
+	_EQ_((Saturating32(-70000) * Saturating32(-70000)).get(), INT32_MAX);
+	_EQ_((Saturating32(INT32_MIN) / Saturating32(-1)).get(), INT32_MAX);
+	_EQ_((-Saturating32(INT32_MIN)).get(), INT32_MAX);
+
+	// CHECK: wrapping is modulo 2^32
+	_EQ_((Wrapping32(INT32_MAX) + Wrapping32(1)).get(), INT32_MIN);
+	_EQ_((Wrapping32(65536) * Wrapping32(65536)).get(), 0);
+
+	// CHECK: widening binary operators give the exact result in the wider storage
+	auto wide = Widening32(INT32_MAX) * Widening32(INT32_MIN);
+	_EQ_(wide.get(), (int64_t)INT32_MAX * INT32_MIN);
+	_EQ_((Widening32(INT32_MIN) - Widening32(INT32_MAX)).get(), (int64_t)INT32_MIN - INT32_MAX);
+	Widening32 narrow(INT32_MAX);
+	narrow += Widening32(1);
+	_EQ_(narrow.get(), INT32_MAX);
+
+#ifdef __SIZEOF_INT128__
+	typedef FixedInteger<int64_t, WideningOverflow> Widening64;
+	auto wide128 = Widening64(INT64_MIN) * Widening64(INT64_MIN);
+	_EQ_(toString(wide128), std::string("85070591730234615865843651857942052864"));
+	_EQ_(toString(FixedInteger<__int128>(FixedInteger<__int128>::min())), std::string("-170141183460469231731687303715884105728"));
+#endif
+	_EQ_(toString(Checked32(-2147483647 - 1)), std::string("-2147483648"));
+}
+
+void Models1::test()
+{
+	ErrorHandler previous = setErrorHandler(countError);
+	handled = 0;
+	clearLastError();
+	_EQ_((bool)getLastError(), false);
+
+	// CHECK: the handler gets the static descriptor of each failure
+	Rational value(1);
+	value += RATIONAL_NaN;
+	_EQ_(handled, (size_t)1);
+	_EQ_(std::string(handledError.getSource()), std::string("Rational"));
+	_EQ_(handledError.getCode(), 3);
+	_EQ_(getLastError().getMessage(), handledError.getMessage());
+
+	Integer quotient = Integer(1) / Integer(0);
+	_EQ_(handled, (size_t)2);
+	_EQ_(quotient, Integer(1));
+	_EQ_(toString(getLastError()), std::string("ERROR 1: [Integer] (/ 0, % 0) is undefined"));
+
+	// CHECK: without a handler errors are only recorded
+	setErrorHandler(nullptr);
+	Real(Rational(2), Rational(1));
+	_EQ_(handled, (size_t)2);
+	_EQ_(std::string(getLastError().getSource()), std::string("Real"));
+
+	setErrorHandler(previous);
+	clearLastError();
+}
+
+void Models2::test()
+{
+	// CHECK: binary GCD is non-negative and handles zero and the int64_t edge
+	_EQ_(GCD(Integer(-12), Integer(18)), Integer(6));
+	_EQ_(GCD(Integer(0), Integer(0)), Integer(0));
+	_EQ_(GCD(Integer(0), Integer(-7)), Integer(7));
+	_EQ_(toString(GCD(Integer(INT64_MIN), Integer(0))), std::string("9223372036854775808"));
+	Integer big = Integer(INT64_MAX) * Integer(INT64_MAX) * Integer(6);
+	_EQ_(GCD(big, Integer(INT64_MAX) * Integer(4)), Integer(INT64_MAX) * Integer(2));
+
+	// CHECK: lazy sums equal eager ones
+	int denominators[] = { 2, 3, 4, 5, 6, 8, 10, 12 };
+	Rational eager(0), lazy(0);
+	lazy.setLazy(true);
+	for (int k = 0; k < 1000; k++)
+	{
+		Rational term(k % 7 - 3, denominators[k % 8]);
+		eager += term;
+		lazy += term;
+		if (k % 97 == 0)
+		{
+			_EQ_(lazy == eager, true);
+			_EQ_(lazy != eager, false);
+			_EQ_(toString(lazy), toString(eager));
+		}
+	}
+	_EQ_(lazy == eager, true);
+	_EQ_(lazy < eager + Rational(1, 1000), true);
+
+	Rational half(1, 2);
+	half.setLazy(true);
+	half *= Rational(2, 3);
+	half /= Rational(2, 3);
+	_EQ_(half, Rational(1, 2));
+	_EQ_(toString(-half), std::string("-1 / 2"));
+	half.setLazy(false);
+	_EQ_(half.isLazy(), false);
+	_EQ_(toString(half), std::string("1 / 2"));
+}
+
+void Models3::test()
+{
+	// CHECK: word-sized values whose cross products pass int64_t
+	Rational x(Integer(INT64_MAX), Integer(INT64_MAX - 1));
+	Rational y(Integer(INT64_MAX - 1), Integer(INT64_MAX - 2));
+	_EQ_(x.compare(y), -1);
+	_EQ_(y.compare(x), 1);
+	_EQ_(x.compare(x), 0);
+	_EQ_(x < y, true);
+	_EQ_((-x).compare(-y), 1);
+	_EQ_(x.compare(RATIONAL_NaN), Rational::UNORDERED);
+	_EQ_(x <= RATIONAL_NaN, false);
+	_EQ_(x > RATIONAL_NaN, false);
+
+	// CHECK: big values agree with exact cross products
+	uint64_t state = 11;
+	for (int k = 0; k < 200; k++)
+	{
+		Integer p1(fromString(randomDigits(20 + k % 30, state)));
+		Integer q1(fromString(randomDigits(20 + k % 25, state)));
+		Integer p2(fromString(randomDigits(20 + k % 30, state)));
+		Integer q2(fromString(randomDigits(20 + k % 25, state)));
+		if (k % 3 == 0)
+			p1 = -p1;
+		if (k % 5 == 0)
+			p2 = -p2;
+		if (k % 7 == 0)
+		{
+			p2 = p1 * Integer(3);
+			q2 = q1 * Integer(3);
+		}
+		Rational a(p1, q1), b(p2, q2);
+		int expected = (p1 * q2).compare(p2 * q1);
+		_EQ_(a.compare(b), expected);
+		_EQ_(b.compare(a), -expected);
+	}
+
+	// CHECK: interval products in every sign case match all four products
+	int bounds[][2] = { { 2, 5 }, { -5, -2 }, { -3, 4 }, { 0, 3 }, { -3, 0 }, { 0, 0 } };
+	for (auto& u : bounds)
+		for (auto& v : bounds)
+		{
+			Rational a(u[0]), b(u[1]), c(v[0]), d(v[1]);
+			Rational lo = std::min(std::min(a * c, a * d), std::min(b * c, b * d));
+			Rational hi = std::max(std::max(a * c, a * d), std::max(b * c, b * d));
+			_EQ_(Real(a, b) * Real(c, d), Real(lo, hi));
+		}
+	_EQ_(Real(Rational(-1), Rational(2)).containsZero(), true);
+	_EQ_(Real(Rational(1), Rational(2)).containsZero(), false);
+}
+
+void Models4::test()
+{
+	// CHECK: sums and differences equal a += loop, also when the denominator grows past a word
+	RationalAccumulator accumulator;
+	Rational expected(0);
+	for (int k = 1; k <= 300; k++)
+	{
+		Rational term(k % 2 == 0 ? k : -k, k % 13 == 0 ? 7 * k + 1 : k % 12 + 1);
+		if (k % 4 == 0)
+		{
+			accumulator.sub(term);
+			expected -= term;
+		}
+		else
+		{
+			accumulator.add(term);
+			expected += term;
+		}
+	}
+	_EQ_(accumulator.getSum(), expected);
+	_EQ_(toString(accumulator.getSum()), toString(expected));
+
+	// CHECK: dot products
+	Rational a[] = { Rational(1, 2), Rational(-2, 3), Rational(3, 4) };
+	Rational b[] = { Rational(4, 5), Rational(5, 6), Rational(-6, 7) };
+	accumulator.reset();
+	accumulator.addDot(a, b, 3);
+	_EQ_(accumulator.getSum(), a[0] * b[0] + a[1] * b[1] + a[2] * b[2]);
+
+	// CHECK: NaN sticks until reset
+	accumulator.add(RATIONAL_NaN);
+	accumulator.add(Rational(1));
+	_EQ_(accumulator.isNaN(), true);
+	_EQ_(accumulator.getSum().isNaN(), true);
+	accumulator.reset();
+	_EQ_(accumulator.getSum(), Rational(0));
+	clearLastError();
+}
+
+void Models5::test()
+{
+	// CHECK: compile-time tables match the same values computed at run time
+	int n = 10;
+	_EQ_(HARMONIC[3], harmonic(n));
+	_EQ_(toString(HARMONIC[3]), std::string("7381 / 2520"));
+	Integer sum(0);
+	for (const Integer& c : BINOMIAL_20)
+		sum += c;
+	_EQ_(sum, Integer(1 << 20));
+
+	// CHECK: at run time the same errors are still reported
+	clearLastError();
+	Rational third(1, 3);
+	third /= Rational(0);
+	_EQ_(third, Rational(1, 3));
+	_EQ_(std::string(getLastError().getSource()), std::string("Rational"));
+	_EQ_(getLastError().getCode(), 2);
+	clearLastError();
+	Integer i(7);
+	i /= Integer(0);
+	_EQ_(i, Integer(7));
+	_EQ_(std::string(getLastError().getSource()), std::string("Integer"));
+	clearLastError();
+}
+
+void Models6::test()
+{
+	auto encloses = [](const RealD& outer, const Real& exact) {
+		Real bounds = outer.toReal();
+		return bounds.getLower() <= exact.getLower() && bounds.getUpper() >= exact.getUpper();
+	};
+
+	// CHECK: doubles convert exactly both ways, other rationals to the adjacent doubles
+	RealD tenth(0.1);
+	_EQ_(RealD(tenth.toReal()), tenth);
+	RealD exactTenth(Real(Rational(1, 10), Rational(1, 10)));
+	_EQ_(exactTenth.getUpper(), std::nextafter(exactTenth.getLower(), 1.0));
+	_EQ_(encloses(exactTenth, Real(Rational(1, 10), Rational(1, 10))), true);
+	Rational huge(Integer(fromString("1000000000000000000000000000001")), Integer(3));
+	RealD hugeD(Real(-huge, huge));
+	_EQ_(hugeD.getUpper(), std::nextafter(1e30 / 3, 1e31));
+	_EQ_(encloses(hugeD, Real(-huge, huge)), true);
+	_EQ_(RealD(Real(Rational(1), Rational(2))).toReal(), Real(Rational(1), Rational(2)));
+	Rational belowMin(Integer(((int64_t)1 << 53) - 1), Integer(BigInteger::powerOfTwo(1075)));
+	RealD belowMinD(Real(belowMin, belowMin));
+	_EQ_(belowMinD.getUpper(), DBL_MIN);
+	_EQ_(belowMinD.getLower(), std::nextafter(DBL_MIN, 0.0));
+	_EQ_(encloses(belowMinD, Real(belowMin, belowMin)), true);
+
+	// CHECK: every operation in every sign case encloses the exact one
+	Rational ends[] = { Rational(-7, 3), Rational(-1, 10), Rational(0), Rational(2, 7), Rational(5) };
+	for (int k = 0; k < 100; k++)
+	{
+		const Rational& a = ends[k % 5];
+		const Rational& b = std::max(a, ends[(k / 5) % 5]);
+		const Rational& c = ends[(k / 25) % 5];
+		const Rational& d = std::max(c, ends[(k * 7) % 5]);
+		Real x(a, b), y(c, d);
+		RealD xd(x), yd(y);
+		_EQ_(encloses(xd + yd, x + y), true);
+		_EQ_(encloses(xd - yd, x - y), true);
+		_EQ_(encloses(xd * yd, x * y), true);
+		if (!y.containsZero())
+			_EQ_(encloses(xd / yd, x / y), true);
+	}
+
+	// CHECK: an inexact sum is one ulp wide around the exact sum of the doubles
+	RealD sum = RealD(0.1) + RealD(0.2);
+	_EQ_(sum.getUpper(), 0.30000000000000004);
+	_EQ_(sum.getLower(), std::nextafter(0.30000000000000004, 0.0));
+	_EQ_(encloses(sum, RealD(0.1).toReal() + RealD(0.2).toReal()), true);
+	_EQ_(RealD(0.5) + RealD(0.25), RealD(0.75));
+	_EQ_(encloses(RealD(1e308) * RealD(10.0), Real(Rational(1), Rational(1))), false);
+	_EQ_((RealD(1e308) * RealD(10.0)).getLower(), DBL_MAX);
+
+	// CHECK: the same errors as Real
+	clearLastError();
+	RealD one(1.0);
+	one /= RealD(-1.0, 1.0);
+	_EQ_(one, RealD(1.0));
+	_EQ_(std::string(getLastError().getSource()), std::string("RealD"));
+	_EQ_(REALD_NaN.isNaN(), true);
+	clearLastError();
+}
+
+void Models7::test()
+{
+	// Bounds of every sign, exact and inexact, in an odd count for the scalar tails
+	const size_t COUNT = 1003;
+	uint64_t state = 5;
+	auto next = [&state]() {
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return (double)(int64_t)(state >> 11) / (double)(1LL << 40) - 4096.0;
+	};
+	IntervalArray x, y;
+	for (size_t k = 0; k < COUNT; k++)
+	{
+		double a = k % 11 == 0 ? 0.0 : next(), b = next();
+		double c = next(), d = k % 13 == 0 ? 0.0 : next() / 3.0;
+		x.append(RealD(std::min(a, b), std::max(a, b)));
+		y.append(RealD(std::min(c, d), std::max(c, d)));
+	}
+
+	// CHECK: every kernel gives the RealD result for every element
+	INTERVAL_KERNEL initial = IntervalArray::getKernel();
+	for (INTERVAL_KERNEL kernel : { INTERVAL_KERNEL::SCALAR, INTERVAL_KERNEL::AVX2, INTERVAL_KERNEL::AVX512 })
+	{
+		if (!IntervalArray::setKernel(kernel))
+			continue;
+		IntervalArray sum, difference, product, quotient;
+		std::vector<uint8_t> zeros;
+		IntervalArray::add(x, y, sum);
+		IntervalArray::sub(x, y, difference);
+		IntervalArray::mul(x, y, product);
+		clearLastError();
+		IntervalArray::div(x, y, quotient);
+		_EQ_(std::string(getLastError().getSource()), std::string("IntervalArray"));
+		y.containsZero(zeros);
+
+		bool same = true;
+		for (size_t k = 0; k < COUNT; k++)
+		{
+			RealD a = x.get(k), b = y.get(k);
+			same = same && sum.get(k) == a + b && difference.get(k) == a - b && product.get(k) == a * b;
+			same = same && (zeros[k] == 1) == b.containsZero();
+			same = same && (b.containsZero() ? quotient.get(k).isNaN() : quotient.get(k) == a / b);
+		}
+		_EQ_(same, true);
+	}
+	IntervalArray::setKernel(initial);
+	_EQ_(IntervalArray::getKernel(), initial);
+
+	// CHECK: conversions from Real enclose, results in place
+	std::vector<Real> exact = { Real(Rational(1, 3), Rational(1, 2)), Real(Rational(-2, 7), Rational(5)) };
+	IntervalArray z(exact);
+	IntervalArray::mul(z, z, z);
+	Real square = exact[1] * exact[1];
+	_EQ_(z.toReal(1).getLower() <= square.getLower() && z.toReal(1).getUpper() >= square.getUpper(), true);
+	_EQ_(z.get(0), RealD(exact[0]) * RealD(exact[0]));
+
+	// CHECK: mismatched sizes leave the result alone
+	clearLastError();
+	IntervalArray::add(x, z, z);
+	_EQ_(z.size(), (size_t)2);
+	_EQ_(getLastError().getCode(), 1);
+	clearLastError();
+}
+
+void Models8::test()
+{
+	auto distance = [](const Rational& a, const Rational& b) {
+		Rational d = a - b;
+		return d.sign() < 0 ? -d : d;
+	};
+
+	// CHECK: doubles convert exactly, NaN and infinities don't
+	_EQ_(Rational::fromDouble(0.1), Rational(Integer((int64_t)3602879701896397), Integer((int64_t)1 << 55)));
+	_EQ_(Rational::fromDouble(-3.0), Rational(-3));
+	_EQ_(Rational::fromDouble(0x1p70), Rational(Integer((int64_t)1 << 35) * Integer((int64_t)1 << 35)));
+	_EQ_(Rational::fromDouble(0x1p-1074) * Rational::fromDouble(0x1p1000) * Rational::fromDouble(0x1p74), Rational(1));
+	clearLastError();
+	_EQ_(Rational::fromDouble(INFINITY).isNaN(), true);
+	_EQ_(std::string(getLastError().getSource()), std::string("Rational"));
+	clearLastError();
+
+	// CHECK: every finite double comes back unchanged, subnormals included
+	uint64_t state = 11;
+	bool same = true;
+	for (int k = 0; k < 2000; k++)
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		double value;
+		uint64_t bits = k % 4 == 0 ? state >> 12 : state;
+		std::memcpy(&value, &bits, sizeof(value));
+		if (std::isfinite(value))
+			same = same && Rational::fromDouble(value).toDouble() == value;
+	}
+	_EQ_(same, true);
+	_EQ_(Rational::fromDouble(DBL_MAX).toDouble(), DBL_MAX);
+
+	// CHECK: to nearest, ties to even, also in the subnormal range and past DBL_MAX
+	_EQ_(Rational(1, 3).toDouble(), 1.0 / 3);
+	_EQ_(Rational(Integer((int64_t)9007199254740993)).toDouble(), 9007199254740992.0);
+	_EQ_(Rational(Integer((int64_t)9007199254740995)).toDouble(), 9007199254740996.0);
+	Rational tiny = Rational::fromDouble(0x1p-1074);
+	_EQ_((tiny * Rational(1, 2)).toDouble(), 0.0);
+	_EQ_((tiny * Rational(3, 4)).toDouble(), 0x1p-1074);
+	_EQ_((tiny * Rational(5, 2)).toDouble(), 0x1p-1073);
+	_EQ_((-Rational::fromDouble(DBL_MAX) * Rational(2)).toDouble(), -HUGE_VAL);
+	_EQ_(std::isnan(RATIONAL_NaN.toDouble()), true);
+
+	// CHECK: no double is closer to a big fraction than its conversion
+	bool nearest = true;
+	for (int k = 0; k < 200; k++)
+	{
+		Rational value(Integer(fromString(randomDigits(1 + k % 40, state))), Integer(fromString(randomDigits(1 + k % 23, state))));
+		double d = value.toDouble();
+		Rational error = distance(value, Rational::fromDouble(d));
+		nearest = nearest && error <= distance(value, Rational::fromDouble(std::nextafter(d, INFINITY)));
+		nearest = nearest && error <= distance(value, Rational::fromDouble(std::nextafter(d, -INFINITY)));
+	}
+	_EQ_(nearest, true);
+
+	// CHECK: best approximations of pi, against every denominator in range
+	double pi = 3.14159265358979323846;
+	_EQ_(Rational::fromDouble(pi).approximate(Integer(7)), Rational(22, 7));
+	_EQ_(Rational::fromDouble(pi).approximate(Integer(100)), Rational(311, 99));
+	_EQ_(Rational::fromDouble(-pi).approximate(Integer(1000)), Rational(-355, 113));
+	bool best = true;
+	for (int k = 0; k < 100; k++)
+	{
+		Rational value(Integer(fromString(randomDigits(1 + k % 12, state))), Integer(fromString(randomDigits(1 + k % 9, state))));
+		int bound = 1 + k % 60;
+		Rational approximation = value.approximate(Integer(bound));
+		best = best && approximation.getDenominator() <= Integer(bound);
+		Rational error = distance(value, approximation);
+		for (int q = 1; q <= bound; q++)
+		{
+			Integer p = value.getNumerator() * Integer(q) / value.getDenominator();
+			best = best && distance(value, Rational(p, Integer(q))) >= error;
+			best = best && distance(value, Rational(p + Integer(1), Integer(q))) >= error;
+		}
+	}
+	_EQ_(best, true);
+	_EQ_(Rational(1, 3).approximate(Integer(0)).isNaN(), true);
+	_EQ_(getLastError().getCode(), 9);
+	clearLastError();
+
+	// CHECK: batches give the single results
+	double values[] = { 0.1, -2.5, 1e300, 0x1p-1060, 0.3333333333 };
+	std::vector<Rational> exact, approximations;
+	Rational::fromDoubles(values, 5, exact);
+	Rational::approximate(values, 5, Integer(10), approximations);
+	double back[5];
+	Rational::toDoubles(exact.data(), 5, back);
+	_EQ_(std::equal(values, values + 5, back), true);
+	_EQ_(exact[3], Rational::fromDouble(0x1p-1060));
+	_EQ_(approximations[4], Rational(1, 3));
+	_EQ_(approximations[3], Rational(0));
+	std::vector<double> many;
+	for (int k = 0; k < 500; k++)
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		many.push_back(std::ldexp((double)(state >> 11) / 0x1p53 - 0.5, k % 80 - 60));
+	}
+	Rational::approximate(many.data(), many.size(), Integer(100000), approximations);
+	bool single = true;
+	for (size_t k = 0; k < many.size(); k++)
+		single = single && approximations[k] == Rational::fromDouble(many[k]).approximate(Integer(100000));
+	_EQ_(single, true);
+
+	// CHECK: a batch gives NaN for infinities, NaNs and a bound below 1
+	double special[] = { INFINITY, -INFINITY, NAN, 0.5 };
+	Rational::approximate(special, 4, Integer(10), approximations);
+	_EQ_(approximations.size(), (size_t)4);
+	_EQ_(approximations[0].isNaN() && approximations[1].isNaN() && approximations[2].isNaN(), true);
+	_EQ_(approximations[3], Rational(1, 2));
+	Rational::approximate(special, 4, Integer(0), approximations);
+	_EQ_(approximations.size(), (size_t)4);
+	_EQ_(std::all_of(approximations.begin(), approximations.end(), [](const Rational& r) { return r.isNaN(); }), true);
+	_EQ_(getLastError().getCode(), 9);
+	clearLastError();
+}
+
+void Models9::test()
+{
+	// CHECK: determinants with a row swap, of a Hilbert matrix, of non-square matrices
+	_EQ_(RationalMatrix(2, 2, { Rational(0), Rational(1), Rational(1), Rational(0) }).determinant(), Rational(-1));
+	RationalMatrix hilbert(5, 5);
+	for (size_t i = 0; i < 5; i++)
+		for (size_t j = 0; j < 5; j++)
+			hilbert.set(i, j, Rational(1, (int)(i + j + 1)));
+	_EQ_(hilbert.determinant(), Rational(Integer(1), Integer((int64_t)266716800000)));
+	clearLastError();
+	_EQ_(RationalMatrix(2, 3).determinant().isNaN(), true);
+	_EQ_(getLastError().getCode(), 1);
+	clearLastError();
+
+	// CHECK: rank of a rectangular matrix with a zero column and a dependent row
+	RationalMatrix low(3, 4, { Rational(0), Rational(1), Rational(2), Rational(1, 2),
+		Rational(0), Rational(3), Rational(-1), Rational(4),
+		Rational(0), Rational(4), Rational(1), Rational(9, 2) });
+	_EQ_(low.rank(), (size_t)2);
+	_EQ_(RationalMatrix(3, 2).rank(), (size_t)0);
+
+	// CHECK: the solution satisfies the system exactly
+	RationalMatrix big(6, 6);
+	for (size_t i = 0; i < 6; i++)
+		for (size_t j = 0; j < 6; j++)
+			big.set(i, j, Rational(1, (int)(i + j + 1)));
+	std::vector<Rational> b, x;
+	for (int i = 0; i < 6; i++)
+		b.push_back(Rational(i - 2, 3));
+	_EQ_(big.solve(b, x), true);
+	bool satisfied = x.size() == 6;
+	for (size_t i = 0; i < 6 && satisfied; i++)
+	{
+		Rational sum(0);
+		for (size_t j = 0; j < 6; j++)
+			sum += big.get(i, j) * x[j];
+		satisfied = sum == b[i];
+	}
+	_EQ_(satisfied, true);
+	_EQ_(RationalMatrix(2, 2, { Rational(1), Rational(2), Rational(2), Rational(4) }).solve({ Rational(1), Rational(2) }, x), false);
+	_EQ_(getLastError().getCode(), 3);
+	clearLastError();
+
+	// CHECK: same determinant and rank as Rational elimination, singular matrices included
+	uint64_t state = 17;
+	bool same = true;
+	for (int k = 0; k < 60; k++)
+	{
+		size_t rows = 1 + k % 7, cols = k % 3 == 0 ? 1 + (k / 3) % 6 : rows;
+		RationalMatrix matrix(rows, cols);
+		for (size_t i = 0; i < rows; i++)
+			for (size_t j = 0; j < cols; j++)
+			{
+				state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+				int p = (int)((state >> 40) % 21) - 10, q = 1 + (int)((state >> 20) % 6);
+				matrix.set(i, j, (k + i) % 5 == 0 && i > 0 ? matrix.get(i - 1, j) * Rational(-2) : Rational(p, q));
+			}
+		size_t rank = 0;
+		Rational det = gaussDeterminant(matrix, rank);
+		same = same && matrix.rank() == rank;
+		if (rows == cols)
+			same = same && matrix.determinant() == det;
+	}
+	_EQ_(same, true);
+}
+
+void Models10::test()
+{
+	// CHECK: equal values hash alike whatever their form
+	Integer huge(fromString("123456789012345678901234567890"));
+	_EQ_(std::hash<Integer>()(huge * Integer(2) - huge), std::hash<Integer>()(huge));
+	_EQ_(std::hash<Integer>()(huge - huge + Integer(5)), std::hash<Integer>()(Integer(5)));
+	Rational lazy(1, 6);
+	lazy.setLazy(true);
+	lazy += Rational(1, 3);
+	_EQ_(lazy.isLazy() && lazy.getDenominator() != Integer(2), true);
+	_EQ_(lazy.hash(), Rational(1, 2).hash());
+	_EQ_(Rational(Integer(-4), Integer(-6)).hash(), Rational(2, 3).hash());
+	_INEQ_(Rational(2, 3).hash(), Rational(3, 2).hash());
+	_EQ_(RATIONAL_NaN.hash(), Rational(0, 0).hash());
+	_EQ_(Real(Rational(1, 2), lazy).hash(), Real(Rational(1, 2), Rational(1, 2)).hash());
+	_INEQ_(Real(Rational(1), Rational(2)).hash(), Real(Rational(2), Rational(2)).hash());
+
+	// CHECK: lexicographic total order, NaN first, overlapping intervals included
+	std::set<Real, RealTotalLess> reals = { Real(Rational(1), Rational(3)), Real(Rational(2), Rational(2)),
+		Real(Rational(1), Rational(2)), REAL_NaN, Real(Rational(2, 4), Rational(3)), REAL_NaN };
+	clearLastError();
+	std::vector<Real> sorted(reals.begin(), reals.end());
+	_EQ_(sorted.size(), (size_t)5);
+	_EQ_(sorted[0].isNaN(), true);
+	_EQ_(sorted[1], Real(Rational(1, 2), Rational(3)));
+	_EQ_(sorted[2], Real(Rational(1), Rational(2)));
+	_EQ_(sorted[4], Real(Rational(2), Rational(2)));
+	_EQ_(getLastError().getCode(), 0);
+
+	// CHECK: exact vector set and map dedupe equal vectors in any form, NaN included
+	RationalVectorSet set;
+	set.insert({ Rational(1, 2), Rational(1, 3) });
+	set.insert({ lazy, Rational(2, 6) });
+	set.insert({ Rational(1, 2), Rational(1, 3), Rational(0) });
+	set.insert({ RATIONAL_NaN, Rational(1) });
+	set.insert({ RATIONAL_NaN, Rational(1) });
+	_EQ_(set.size(), (size_t)3);
+	_EQ_(set.count({ Rational(3, 6), Rational(1, 3) }), (size_t)1);
+	_EQ_(getLastError().getCode(), 0);
+
+	RationalVectorMap<int> counts;
+	for (int k = 0; k < 100; k++)
+		counts[{ Rational(k % 3, 3), Rational(k % 2 + 1, 2) }]++;
+	_EQ_(counts.size(), (size_t)6);
+	_EQ_(counts[{ Rational(0), Rational(1, 2) }], 17);
+}
+
+void Models11::test()
+{
+	char buffer[256];
+	auto format = [&](const auto& value) {
+		std::to_chars_result res = value.toChars(buffer, buffer + sizeof(buffer));
+		return res.ec == std::errc() ? std::string(buffer, res.ptr) : std::string("ERROR");
+	};
+	auto parse = [](std::string_view text, auto& value) {
+		std::from_chars_result res = std::remove_reference_t<decltype(value)>::fromChars(text.data(), text.data() + text.size(), value);
+		return res.ec == std::errc() ? (size_t)(res.ptr - text.data()) : (size_t)-1;
+	};
+
+	// CHECK: integers round trip on both sides of the word boundary
+	Integer integer(0);
+	for (std::string text : { "0", "-7", "999999999999999999", "-9223372036854775808", "123456789012345678901234567890", "-18446744073709551616" })
+	{
+		_EQ_(parse(text, integer), text.size());
+		_EQ_(format(integer), text);
+	}
+	_EQ_(integer, -Integer(fromString("18446744073709551616")));
+	_EQ_(parse("12abc", integer), (size_t)2);
+	_EQ_(parse("-", integer), (size_t)-1);
+	_EQ_(parse("+5", integer), (size_t)-1);
+
+	// CHECK: rationals as printed by <<, reduced, spaces around '/' optional
+	Rational rational(0);
+	Rational lazy(1, 6);
+	lazy.setLazy(true);
+	lazy += Rational(1, 3);
+	std::ostringstream printed;
+	printed << lazy;
+	_EQ_(format(lazy), printed.str());
+	_EQ_(format(lazy), std::string("1 / 2"));
+	_EQ_(format(RATIONAL_NaN), std::string("NaN"));
+	_EQ_(parse("NaN", rational), (size_t)3);
+	_EQ_(rational.isNaN(), true);
+	_EQ_(parse("3", rational), (size_t)1);
+	_EQ_(rational, Rational(3));
+	_EQ_(parse("-1/2", rational), (size_t)4);
+	_EQ_(rational, Rational(-1, 2));
+	_EQ_(parse("2 / 4 rest", rational), (size_t)5);
+	_EQ_(rational, Rational(1, 2));
+	_EQ_(parse("1 / 0", rational), (size_t)-1);
+	_EQ_(parse("1 / -2", rational), (size_t)6);
+	_EQ_(rational, Rational(-1, 2));
+
+	// CHECK: intervals as printed by <<, bounds in order
+	Real real(Rational(0), Rational(0));
+	_EQ_(parse("[ 1/2 ,3 / 1]", real), (size_t)13);
+	_EQ_(real, Real(Rational(1, 2), Rational(3)));
+	_EQ_(format(real), std::string("[1 / 2, 3 / 1]"));
+	printed.str("");
+	printed << real;
+	_EQ_(format(real), printed.str());
+	_EQ_(parse("[3, 1]", real), (size_t)-1);
+	_EQ_(parse("[1, 2", real), (size_t)-1);
+	_EQ_(parse("NaN", real), (size_t)3);
+	_EQ_(real.isNaN(), true);
+	_EQ_(format(REAL_NaN), std::string("NaN"));
+
+	// CHECK: batches read any whitespace, report the count and stop at bad text
+	std::string text = " 1 / 3\n-2\t\t5 / 10  NaN\n";
+	std::vector<Rational> rationals(8, Rational(0));
+	size_t count = 0;
+	std::from_chars_result read = Rational::fromChars(text.data(), text.data() + text.size(), rationals, count);
+	_EQ_(read.ec == std::errc() && read.ptr == text.data() + text.size(), true);
+	_EQ_(count, (size_t)4);
+	_EQ_(rationals[2], Rational(1, 2));
+	std::to_chars_result written = Rational::toChars(buffer, buffer + sizeof(buffer), std::span<const Rational>(rationals.data(), count), ' ');
+	_EQ_(std::string(buffer, written.ptr), std::string("1 / 3 -2 / 1 1 / 2 NaN"));
+
+	text = "1 2 x 4";
+	std::vector<Integer> integers(8);
+	read = Integer::fromChars(text.data(), text.data() + text.size(), integers, count);
+	_EQ_(read.ec == std::errc::invalid_argument && read.ptr == text.data() + 4, true);
+	_EQ_(count, (size_t)2);
+
+	// CHECK: a short buffer is value_too_large, for words and big integers alike
+	_EQ_(Integer(123456).toChars(buffer, buffer + 5).ec == std::errc::value_too_large, true);
+	_EQ_(fromString("123456789012345678901234567890").toChars(buffer, buffer + 29).ec == std::errc::value_too_large, true);
+	_EQ_(Rational(1, 3).toChars(buffer, buffer + 4).ec == std::errc::value_too_large, true);
+	_EQ_(Real(Rational(1), Rational(2)).toChars(buffer, buffer + 13).ec == std::errc::value_too_large, true);
+	_EQ_(getLastError().getCode(), 0);
+}
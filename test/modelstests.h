@@ -0,0 +1,128 @@
+#pragma once
+#include "Test.h"
+#include "models/BigInteger.h"
+#include "models/Integer.h"
+#include "models/FixedInteger.h"
+#include "models/Rational.h"
+#include "models/RationalAccumulator.h"
+#include "models/Real.h"
+#include "models/RealD.h"
+#include "models/IntervalArray.h"
+#include "models/RationalMatrix.h"
+#include "models/RationalVectorSet.h"
+#include "models/Error.h"
+
+const std::string INTEGER_PREFIX = "Integer ";
+const std::string MODELS_PREFIX = "Models  ";
+
+class Integer1 : public Test
+{
+private:
+	void test() override;
+public:
+	Integer1() : Test(INTEGER_PREFIX + "BigArithmetic") {}
+};
+
+class Integer2 : public Test
+{
+private:
+	void test() override;
+public:
+	Integer2() : Test(INTEGER_PREFIX + "Overflow") {}
+};
+
+class Integer3 : public Test
+{
+private:
+	void test() override;
+public:
+	Integer3() : Test(INTEGER_PREFIX + "FixedPolicies") {}
+};
+
+class Models1 : public Test
+{
+private:
+	void test() override;
+public:
+	Models1() : Test(MODELS_PREFIX + "ErrorHandler") {}
+};
+
+class Models2 : public Test
+{
+private:
+	void test() override;
+public:
+	Models2() : Test(MODELS_PREFIX + "LazyRational") {}
+};
+
+class Models3 : public Test
+{
+private:
+	void test() override;
+public:
+	Models3() : Test(MODELS_PREFIX + "RationalCompare") {}
+};
+
+class Models4 : public Test
+{
+private:
+	void test() override;
+public:
+	Models4() : Test(MODELS_PREFIX + "RationalAccumulator") {}
+};
+
+class Models5 : public Test
+{
+private:
+	void test() override;
+public:
+	Models5() : Test(MODELS_PREFIX + "Constexpr") {}
+};
+
+class Models6 : public Test
+{
+private:
+	void test() override;
+public:
+	Models6() : Test(MODELS_PREFIX + "RealD") {}
+};
+
+class Models7 : public Test
+{
+private:
+	void test() override;
+public:
+	Models7() : Test(MODELS_PREFIX + "IntervalArray") {}
+};
+
+class Models8 : public Test
+{
+private:
+	void test() override;
+public:
+	Models8() : Test(MODELS_PREFIX + "RationalDouble") {}
+};
+
+class Models9 : public Test
+{
+private:
+	void test() override;
+public:
+	Models9() : Test(MODELS_PREFIX + "RationalMatrix") {}
+};
+
+class Models10 : public Test
+{
+private:
+	void test() override;
+public:
+	Models10() : Test(MODELS_PREFIX + "Hashing") {}
+};
+
+class Models11 : public Test
+{
+private:
+	void test() override;
+public:
+	Models11() : Test(MODELS_PREFIX + "TextFormat") {}
+};
@@ -1,5 +1,12 @@
 #include "settests.h"
 #include "IVector.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+#include <fstream>
+#include <string>
 
 void Set1::test()
 {
@@ -225,3 +232,613 @@ void Set5::test()
 	delete set2;
 	delete res;
 }
+
+
+void Set6::test()
+{
+	ILogger* logger = ILogger::createLogger(nullptr);
+
+	LshSet::Params params;
+	params.bucketWidth = 2.0;
+	params.probes = 2;
+
+	// CHECK: invalid parameters are rejected
+	LshSet::Params wrong = params;
+	wrong.bucketWidth = 0;
+	_EQ_(LshSet::createSet(wrong, logger), (LshSet*)nullptr);
+
+	double data1[3] = { 2, 0, 0 };
+	IVector* vec1 = IVector::createVector(3, data1, logger);
+	double data2[3] = { 0, 1, 0 };
+	IVector* vec2 = IVector::createVector(3, data2, logger);
+	double data3[3] = { 0.1, 1.1, 0.1 };
+	IVector* vec3 = IVector::createVector(3, data3, logger);
+	double data4[4] = { 0, 0, 0, 0 };
+	IVector* vec4 = IVector::createVector(4, data4, logger);
+
+	IVector::NORM norm2 = IVector::NORM::NORM_2;
+
+	ISet* set = LshSet::createSet(params, logger);
+	_INEQ_(set, (ISet*)nullptr);
+
+	// CHECK: vec1, vec2 inserted correctly
+	_EQ_(set->insert(vec1, norm2, 0.2), RESULT_CODE::SUCCESS);
+	_EQ_(set->insert(vec2, norm2, 0.2), RESULT_CODE::SUCCESS);
+	_EQ_(set->getSize(), (size_t)2);
+	_EQ_(set->getDim(), (size_t)3);
+
+	// CHECK: vec3 doesn't inserted hence it's already in the set (as vec2) with tolerance 0.2
+	_EQ_(set->insert(vec3, norm2, 0.2), RESULT_CODE::SUCCESS);
+	_EQ_(set->getSize(), (size_t)2);
+
+	// CHECK: vec4 doesn't inserted hence it has dim = 4, but set dim = 3
+	_EQ_(set->insert(vec4, norm2, 0.2), RESULT_CODE::WRONG_DIM);
+
+	// CHECK: found vector is verified exactly
+	IVector* test = nullptr;
+	_EQ_(set->get(test, vec3, norm2, 0.2), RESULT_CODE::SUCCESS);
+	_INEQ_(test, (IVector*)nullptr);
+	_EQ_(test->getCoord(1), 1.0);
+	delete test;
+	test = nullptr;
+	_EQ_(set->get(test, vec3, norm2, 0.1), RESULT_CODE::SUCCESS);
+	_EQ_(test, (IVector*)nullptr);
+
+	// CHECK: other norms are served by a full scan
+	_EQ_(set->get(test, vec3, IVector::NORM::NORM_INF, 0.2), RESULT_CODE::SUCCESS);
+	_INEQ_(test, (IVector*)nullptr);
+	delete test;
+
+	// CHECK: coordinates that aren't finite are rejected, huge ones still get a bucket
+	double bad[3] = { 0, std::nan(""), 0 };
+	IVector* vecNan = IVector::createVector(3, bad, logger);
+	_EQ_(set->insert(vecNan, norm2, 0.2), RESULT_CODE::NAN_VALUE);
+	_EQ_(set->get(test, vecNan, norm2, 0.2), RESULT_CODE::NAN_VALUE);
+	_EQ_(set->erase(vecNan, norm2, 0.2), RESULT_CODE::NAN_VALUE);
+	bad[1] = 1e300;
+	IVector* vecHuge = IVector::createVector(3, bad, logger);
+	_EQ_(set->insert(vecHuge, norm2, 0.2), RESULT_CODE::SUCCESS);
+	_EQ_(set->getSize(), (size_t)3);
+	_EQ_(set->get(test, vecHuge, norm2, 0.2), RESULT_CODE::SUCCESS);
+	_INEQ_(test, (IVector*)nullptr);
+	delete test;
+	delete vecNan;
+	delete vecHuge;
+
+	delete vec1;
+	delete vec2;
+	delete vec3;
+	delete vec4;
+	delete set;
+}
+
+void Set7::test()
+{
+	ILogger* logger = ILogger::createLogger(nullptr);
+
+	LshSet::Params params;
+	params.bucketWidth = 4.0;
+
+	IVector::NORM norm2 = IVector::NORM::NORM_2;
+	ISet* set = LshSet::createSet(params, logger);
+
+	double data[4] = { 0, 0, 0, 0 };
+	for (int i = 0; i < 10; i++)
+	{
+		data[i % 4] = 10.0 * i;
+		IVector* vec = IVector::createVector(4, data, logger);
+		set->insert(vec, norm2, 0.5);
+		delete vec;
+	}
+	_EQ_(set->getSize(), (size_t)10);
+
+	// CHECK: erase by index keeps the rest reachable
+	IVector* first = nullptr;
+	set->get(first, 0);
+	_EQ_(set->erase(0), RESULT_CODE::SUCCESS);
+	_EQ_(set->getSize(), (size_t)9);
+
+	IVector* test = nullptr;
+	_EQ_(set->get(test, first, norm2, 0.5), RESULT_CODE::SUCCESS);
+	_EQ_(test, (IVector*)nullptr);
+	for (size_t i = 0; i < set->getSize(); i++)
+	{
+		IVector* vec = nullptr;
+		set->get(vec, i);
+		_EQ_(set->get(test, vec, norm2, 0.5), RESULT_CODE::SUCCESS);
+		_INEQ_(test, (IVector*)nullptr);
+		delete test;
+		delete vec;
+	}
+
+	// CHECK: erase by sample, clone is independent
+	ISet* cloned = set->clone();
+	IVector* last = nullptr;
+	set->get(last, set->getSize() - 1);
+	_EQ_(set->erase(last, norm2, 0.5), RESULT_CODE::SUCCESS);
+	_EQ_(set->getSize(), (size_t)8);
+	_EQ_(cloned->getSize(), (size_t)9);
+
+	delete first;
+	delete last;
+	delete cloned;
+	delete set;
+}
+
+void Set8::test()
+{
+	ILogger* logger = ILogger::createLogger(nullptr);
+	IVector::NORM normInf = IVector::NORM::NORM_INF;
+
+	OrderedSet* morton = OrderedSet::createSet(OrderedSet::LAYOUT::MORTON, logger);
+	OrderedSet* plain = OrderedSet::createSet(OrderedSet::LAYOUT::INSERTION, logger);
+	_EQ_(morton->getLayout(), OrderedSet::LAYOUT::MORTON);
+
+	double data[2];
+	for (int i = 0; i < 300; i++)
+	{
+		data[0] = (i * 37) % 101;
+		data[1] = (i * 53) % 103;
+		IVector* vec = IVector::createVector(2, data, logger);
+		morton->insert(vec, normInf, 0.5);
+		plain->insert(vec, normInf, 0.5);
+		delete vec;
+	}
+	morton->reorder();
+	_EQ_(morton->getSize(), plain->getSize());
+
+	// CHECK: get(index) keeps insertion order after storage is sorted
+	bool same = true;
+	for (size_t i = 0; i < plain->getSize(); i++)
+	{
+		IVector* vec1 = nullptr;
+		IVector* vec2 = nullptr;
+		morton->get(vec1, i);
+		plain->get(vec2, i);
+		same &= vec1->getCoord(0) == vec2->getCoord(0) && vec1->getCoord(1) == vec2->getCoord(1);
+		delete vec1;
+		delete vec2;
+	}
+	_EQ_(same, true);
+
+	// CHECK: erase by index removes the element with that insertion index
+	IVector* second = nullptr;
+	morton->get(second, 1);
+	_EQ_(morton->erase(1), RESULT_CODE::SUCCESS);
+	plain->erase(1);
+	IVector* test = nullptr;
+	_EQ_(morton->get(test, second, normInf, 0.5), RESULT_CODE::SUCCESS);
+	_EQ_(test, (IVector*)nullptr);
+	morton->get(test, 1);
+	_EQ_(test->getCoord(0), (double)((2 * 37) % 101));
+	delete test;
+
+	// CHECK: set operations agree across layouts
+	ISet* sum = ISet::add(morton, plain, normInf, 0.5, logger);
+	ISet* common = ISet::intersect(plain, morton, normInf, 0.5, logger);
+	ISet* diff = ISet::sub(morton, plain, normInf, 0.5, logger);
+	_EQ_(sum->getSize(), plain->getSize());
+	_EQ_(common->getSize(), plain->getSize());
+	_EQ_(diff->getSize(), (size_t)0);
+
+	// CHECK: range queries find the same elements as a full scan, with unsorted inserts pending
+	for (int i = 0; i < 40; i++)
+	{
+		data[0] = (i * 29) % 97 + 0.25;
+		data[1] = (i * 31) % 89 + 0.25;
+		IVector* vec = IVector::createVector(2, data, logger);
+		morton->insert(vec, normInf, 0.5);
+		plain->insert(vec, normInf, 0.5);
+		delete vec;
+	}
+	same = true;
+	for (IVector::NORM norm : { IVector::NORM::NORM_1, IVector::NORM::NORM_2, normInf })
+		for (double tolerance : { 0.0, 0.3, 1.0, 3.5, 20.0 })
+			for (int q = 0; q < 30; q++)
+			{
+				data[0] = (q * 13) % 101 + 0.1 * (q % 3);
+				data[1] = (q * 7) % 103;
+				IVector* sample = IVector::createVector(2, data, logger);
+				std::vector<size_t> found, expected;
+				morton->findAll(sample, norm, tolerance, found);
+				plain->findAll(sample, norm, tolerance, expected);
+				std::sort(found.begin(), found.end());
+				same &= found == expected;
+				delete sample;
+			}
+	_EQ_(same, true);
+
+	delete second;
+	delete sum;
+	delete common;
+	delete diff;
+	delete morton;
+	delete plain;
+
+	// CHECK: storage follows the curve: sorted values in one dimension, Z order of a square in two
+	OrderedSet* line = OrderedSet::createSet(OrderedSet::LAYOUT::MORTON, logger);
+	for (int i = 0; i < 101; i++)
+	{
+		data[0] = (i * 37) % 101;
+		IVector* vec = IVector::createVector(1, data, logger);
+		line->insert(vec, normInf, 0.5);
+		delete vec;
+	}
+	line->reorder();
+	same = true;
+	for (size_t i = 0; i < line->getSize(); i++)
+		same &= line->getSlot(i) == (i * 37) % 101;
+	_EQ_(same, true);
+	delete line;
+
+	OrderedSet* square = OrderedSet::createSet(OrderedSet::LAYOUT::MORTON, logger);
+	double corners[4][2] = { { 1, 1 }, { 1, 0 }, { 0, 1 }, { 0, 0 } };
+	for (double* corner : corners)
+	{
+		IVector* vec = IVector::createVector(2, corner, logger);
+		square->insert(vec, normInf, 0.5);
+		delete vec;
+	}
+	_EQ_(square->getSlot(0), (size_t)0);
+	square->reorder();
+	_EQ_(square->getSlot(0), (size_t)3);
+	_EQ_(square->getSlot(1), (size_t)2);
+	_EQ_(square->getSlot(2), (size_t)1);
+	_EQ_(square->getSlot(3), (size_t)0);
+	delete square;
+}
+
+void Set9::test()
+{
+	ILogger* logger = ILogger::createLogger(nullptr);
+	IVector::NORM normInf = IVector::NORM::NORM_INF;
+	char const* fileName = "set_snapshot.bin";
+
+	ISet* set = OrderedSet::createSet(OrderedSet::LAYOUT::MORTON, logger);
+	double data[3];
+	for (int i = 0; i < 100; i++)
+	{
+		data[0] = i % 7;
+		data[1] = i % 11;
+		data[2] = i;
+		IVector* vec = IVector::createVector(3, data, logger);
+		set->insert(vec, normInf, 0.5);
+		delete vec;
+	}
+
+	// CHECK: saved and mapped sets hold the same vectors in the same order
+	_EQ_(SetSnapshot::save(set, fileName, logger), RESULT_CODE::SUCCESS);
+	ISet* loaded = SetSnapshot::loadMapped(fileName, logger);
+	_INEQ_(loaded, (ISet*)nullptr);
+	_EQ_(loaded->getDim(), (size_t)3);
+	_EQ_(loaded->getSize(), set->getSize());
+	bool same = true;
+	for (size_t i = 0; i < set->getSize(); i++)
+	{
+		IVector* vec1 = nullptr;
+		IVector* vec2 = nullptr;
+		set->get(vec1, i);
+		loaded->get(vec2, i);
+		for (size_t j = 0; j < 3; j++)
+			same &= vec1->getCoord(j) == vec2->getCoord(j);
+		delete vec1;
+		delete vec2;
+	}
+	_EQ_(same, true);
+
+	// CHECK: mapped set can be changed, the source set stays intact
+	data[2] = 1000;
+	IVector* extra = IVector::createVector(3, data, logger);
+	_EQ_(loaded->insert(extra, normInf, 0.5), RESULT_CODE::SUCCESS);
+	_EQ_(loaded->erase(0), RESULT_CODE::SUCCESS);
+	_EQ_(loaded->getSize(), set->getSize());
+	IVector* test = nullptr;
+	_EQ_(loaded->get(test, extra, normInf, 0.5), RESULT_CODE::SUCCESS);
+	_INEQ_(test, (IVector*)nullptr);
+	delete test;
+
+	// CHECK: single vector round trip
+	_EQ_(SetSnapshot::save(extra, fileName, logger), RESULT_CODE::SUCCESS);
+	IVector* vec = SetSnapshot::loadVector(fileName, logger);
+	_INEQ_(vec, (IVector*)nullptr);
+	_EQ_(vec->getCoord(2), 1000.0);
+	delete vec;
+
+	// CHECK: missing file is reported
+	_EQ_(SetSnapshot::loadMapped("no_such_snapshot.bin", logger), (ISet*)nullptr);
+
+	std::remove(fileName);
+	delete extra;
+	delete loaded;
+	delete set;
+}
+
+void Set10::test()
+{
+	ILogger* logger = ILogger::createLogger(nullptr);
+	IVector::NORM norm2 = IVector::NORM::NORM_2;
+
+	ISet* set1 = ISet::createSet(logger);
+	ISet* set2 = ISet::createSet(logger);
+	double data[3];
+	for (int i = 0; i < 400; i++)
+	{
+		data[0] = i % 50;
+		data[1] = (i * 7) % 13;
+		data[2] = i / 50;
+		IVector* vec = IVector::createVector(3, data, logger);
+		set1->insert(vec, norm2, 0.5);
+		delete vec;
+
+		// Every third vector is shifted a bit, the others are far from set1
+		data[1] += i % 3 == 0 ? 0.1 : 0.5 * 13;
+		vec = IVector::createVector(3, data, logger);
+		set2->insert(vec, norm2, 0.5);
+		delete vec;
+	}
+	SetSnapshot::save(set1, "stream1.bin", logger);
+	SetSnapshot::save(set2, "stream2.bin", logger);
+
+	// Small memory limit forces many slabs
+	SetStream::Params params;
+	params.memoryLimit = 16384;
+
+	ISet* expected[3] = {
+		ISet::add(set1, set2, norm2, 0.5, logger),
+		ISet::intersect(set1, set2, norm2, 0.5, logger),
+		ISet::sub(set1, set2, norm2, 0.5, logger)
+	};
+	RESULT_CODE codes[3] = {
+		SetStream::add("stream1.bin", "stream2.bin", "stream_add.bin", norm2, 0.5, params, logger),
+		SetStream::intersect("stream1.bin", "stream2.bin", "stream_intersect.bin", norm2, 0.5, params, logger),
+		SetStream::sub("stream1.bin", "stream2.bin", "stream_sub.bin", norm2, 0.5, params, logger)
+	};
+	char const* names[3] = { "stream_add.bin", "stream_intersect.bin", "stream_sub.bin" };
+
+	// CHECK: streamed results hold the same vectors as in-memory ones
+	for (int op = 0; op < 3; op++)
+	{
+		_EQ_(codes[op], RESULT_CODE::SUCCESS);
+		ISet* result = SetSnapshot::loadMapped(names[op], logger);
+		_INEQ_(result, (ISet*)nullptr);
+		_EQ_(result->getSize(), expected[op]->getSize());
+
+		ISet* diff = ISet::symSub(result, expected[op], norm2, 0.01, logger);
+		_EQ_(diff->getSize(), (size_t)0);
+
+		delete diff;
+		delete result;
+		delete expected[op];
+		std::remove(names[op]);
+	}
+
+	// CHECK: a degenerate first coordinate is split on another one
+	set1->clear();
+	set2->clear();
+	for (int i = 0; i < 400; i++)
+	{
+		data[0] = 5;
+		data[1] = i % 40;
+		data[2] = i / 40;
+		IVector* vec = IVector::createVector(3, data, logger);
+		set1->insert(vec, norm2, 0.5);
+		delete vec;
+		data[2] += i % 2 == 0 ? 0.1 : 20;
+		vec = IVector::createVector(3, data, logger);
+		set2->insert(vec, norm2, 0.5);
+		delete vec;
+	}
+	SetSnapshot::save(set1, "stream1.bin", logger);
+	SetSnapshot::save(set2, "stream2.bin", logger);
+	_EQ_(SetStream::sub("stream1.bin", "stream2.bin", "stream_sub.bin", norm2, 0.5, params, logger), RESULT_CODE::SUCCESS);
+	ISet* result = SetSnapshot::loadMapped("stream_sub.bin", logger);
+	_EQ_(result->getSize(), (size_t)200);
+	delete result;
+	_EQ_(SetStream::add("stream1.bin", "stream2.bin", "stream_add.bin", norm2, 0.5, params, logger), RESULT_CODE::SUCCESS);
+	result = SetSnapshot::loadMapped("stream_add.bin", logger);
+	_EQ_(result->getSize(), (size_t)600);
+	delete result;
+	std::remove("stream_sub.bin");
+	std::remove("stream_add.bin");
+
+	// CHECK: vectors that can't be split and don't fit are reported, not loaded past the limit
+	set1->clear();
+	data[1] = data[2] = 0;
+	for (int i = 0; i < 400; i++)
+	{
+		IVector* vec = IVector::createVector(3, data, logger);
+		set1->insert(vec, norm2, 0);
+		delete vec;
+	}
+	_EQ_(set1->getSize(), (size_t)400);
+	SetSnapshot::save(set1, "stream1.bin", logger);
+	_EQ_(SetStream::sub("stream1.bin", "stream2.bin", "stream_sub.bin", norm2, 0.5, params, logger), RESULT_CODE::OUT_OF_MEMORY);
+	params.memoryLimit = 1 << 20;
+	_EQ_(SetStream::sub("stream1.bin", "stream2.bin", "stream_sub.bin", norm2, 0.5, params, logger), RESULT_CODE::SUCCESS);
+	std::remove("stream_sub.bin");
+
+	// CHECK: a truncated operand is an error, not a smaller set
+	for (bool compressed : { false, true })
+	{
+		if (compressed)
+			SetSnapshot::saveCompressed(set1, "stream1.bin", 64, logger);
+		std::ifstream in("stream1.bin", std::ifstream::binary);
+		std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.close();
+		std::ofstream out("stream_cut.bin", std::ofstream::binary);
+		out.write(bytes.data(), (std::streamsize)bytes.size() - 8);
+		out.close();
+		_EQ_(SetStream::sub("stream_cut.bin", "stream2.bin", "stream_sub.bin", norm2, 0.5, params, logger), RESULT_CODE::FILE_ERROR);
+	}
+	std::remove("stream_cut.bin");
+	std::remove("stream_sub.bin");
+
+	// CHECK: dimension mismatch is reported
+	double other[2] = { 0, 0 };
+	IVector* vec = IVector::createVector(2, other, logger);
+	set2->clear();
+	set2->insert(vec, norm2, 0.5);
+	SetSnapshot::save(set2, "stream2.bin", logger);
+	_EQ_(SetStream::sub("stream1.bin", "stream2.bin", "stream_sub.bin", norm2, 0.5, params, logger), RESULT_CODE::WRONG_DIM);
+
+	std::remove("stream1.bin");
+	std::remove("stream2.bin");
+	delete vec;
+	delete set1;
+	delete set2;
+}
+
+void Set11::test()
+{
+	ILogger* logger = ILogger::createLogger(nullptr);
+	IVector::NORM norm2 = IVector::NORM::NORM_2;
+
+	// Grid-like data with a few noisy coordinates
+	ISet* set = ISet::createSet(logger);
+	double data[4];
+	for (int i = 0; i < 3000; i++)
+	{
+		data[0] = (i % 30) * 0.25;
+		data[1] = (i / 30) * 0.5;
+		data[2] = 1.0 / (1 + i % 7);
+		data[3] = i % 11 == 0 ? -1e-3 * i : 42;
+		IVector* vec = IVector::createVector(4, data, logger);
+		set->insert(vec, norm2, 0);
+		delete vec;
+	}
+
+	// CHECK: compressed file is smaller and decodes to the same vectors
+	_EQ_(SetSnapshot::save(set, "plain.bin", logger), RESULT_CODE::SUCCESS);
+	_EQ_(SetSnapshot::saveCompressed(set, "packed.bin", 256, logger), RESULT_CODE::SUCCESS);
+
+	std::FILE* plain = std::fopen("plain.bin", "rb");
+	std::FILE* packed = std::fopen("packed.bin", "rb");
+	std::fseek(plain, 0, SEEK_END);
+	std::fseek(packed, 0, SEEK_END);
+	_EQ_(std::ftell(packed) * 2 < std::ftell(plain), true);
+	std::fclose(plain);
+	std::fclose(packed);
+
+	ISet* loaded = SetSnapshot::loadMapped("packed.bin", logger);
+	_INEQ_(loaded, (ISet*)nullptr);
+	_EQ_(loaded->getSize(), set->getSize());
+	ISet* diff = ISet::symSub(loaded, set, norm2, 1e-9, logger);
+	_EQ_(diff->getSize(), (size_t)0);
+	delete diff;
+	delete loaded;
+
+	// CHECK: single blocks decode on their own
+	SnapshotBlocks* blocks = SnapshotBlocks::open("packed.bin", logger);
+	_INEQ_(blocks, (SnapshotBlocks*)nullptr);
+	_EQ_(blocks->getBlockCount(), (size_t)12);
+	_EQ_(blocks->getBlockLength(11), (size_t)(3000 - 11 * 256));
+	std::vector<double> block(256 * 4);
+	_EQ_(blocks->decodeBlock(11, block.data()), RESULT_CODE::SUCCESS);
+	IVector* vec = IVector::createVector(4, block.data(), logger);
+	IVector* found = nullptr;
+	_EQ_(set->get(found, vec, norm2, 1e-9), RESULT_CODE::SUCCESS);
+	delete found;
+	delete vec;
+	_EQ_(blocks->decodeBlock(12, block.data()), RESULT_CODE::OUT_OF_BOUNDS);
+	delete blocks;
+
+	// CHECK: a column stream cut short fails to decode instead of reading zeros
+	ISet* column = ISet::createSet(logger);
+	for (int i = 0; i < 256; i++)
+	{
+		data[2] = 1.0 / (1 + i % 7);
+		IVector* vec = IVector::createVector(1, data + 2, logger);
+		column->insert(vec, norm2, 0);
+		delete vec;
+	}
+	_EQ_(SetSnapshot::saveCompressed(column, "column.bin", 256, logger), RESULT_CODE::SUCCESS);
+	std::ifstream in("column.bin", std::ifstream::binary);
+	std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	in.close();
+	_EQ_(bytes[64 + 4], (char)0);  // the column is XOR encoded
+	for (uint8_t cut = 1; cut < 8; cut++)
+	{
+		std::string cutBytes = bytes;
+		uint32_t length;
+		memcpy(&length, bytes.data() + 64, sizeof(length));
+		length -= cut;
+		memcpy(&cutBytes[64], &length, sizeof(length));
+		std::ofstream out("column.bin", std::ofstream::binary);
+		out.write(cutBytes.data(), (std::streamsize)cutBytes.size());
+		out.close();
+		blocks = SnapshotBlocks::open("column.bin", logger);
+		_EQ_(blocks->decodeBlock(0, block.data()), RESULT_CODE::FILE_ERROR);
+		delete blocks;
+	}
+	std::remove("column.bin");
+	delete column;
+
+	// CHECK: plain snapshots are served in blocks as well
+	blocks = SnapshotBlocks::open("plain.bin", logger);
+	_EQ_(blocks->getBlockCount(), (size_t)3);
+	delete blocks;
+
+	// CHECK: streaming operations read compressed operands
+	SetStream::Params params;
+	_EQ_(SetStream::sub("packed.bin", "plain.bin", "packed_sub.bin", norm2, 0.01, params, logger), RESULT_CODE::SUCCESS);
+	loaded = SetSnapshot::loadMapped("packed_sub.bin", logger);
+	_EQ_(loaded->getSize(), (size_t)0);
+	delete loaded;
+
+	std::remove("plain.bin");
+	std::remove("packed.bin");
+	std::remove("packed_sub.bin");
+	delete set;
+}
+
+void Set12::test()
+{
+	const IVector::NORM norm2 = IVector::NORM::NORM_2;
+	typedef ScalarVector<Rational> Vec;
+	Vec a({ Rational(1, 3), Rational(2, 3) });
+	Vec b({ Rational(1, 3), Rational(2, 3) + Rational(1, 1000000) });
+	Vec c({ Rational(-1), Rational(5, 7) });
+	Vec d({ Rational(4), Rational(0) });
+
+	// CHECK: a nearby element isn't inserted, a zero tolerance keeps it
+	ScalarSet<Rational> set1, set2;
+	_EQ_(set1.insert(a, norm2, Rational(1, 1000)), RESULT_CODE::SUCCESS);
+	_EQ_(set1.insert(b, norm2, Rational(1, 1000)), RESULT_CODE::SUCCESS);
+	_EQ_(set1.getSize(), (size_t)1);
+	_EQ_(set1.insert(b, norm2, Rational(0)), RESULT_CODE::SUCCESS);
+	_EQ_(set1.getSize(), (size_t)2);
+	_EQ_(set1.insert(a, norm2, Rational(-1)), RESULT_CODE::WRONG_ARGUMENT);
+	_EQ_(set1.insert(Vec(3), norm2, Rational(0)), RESULT_CODE::WRONG_DIM);
+	set1.insert(c, norm2, Rational(1, 1000));
+
+	// CHECK: set operations with an exact tolerance
+	set2.insert(c, norm2, Rational(1, 1000));
+	set2.insert(d, norm2, Rational(1, 1000));
+	ScalarSet<Rational> res;
+	_EQ_(ScalarSet<Rational>::add(set1, set2, norm2, Rational(1, 1000), res), RESULT_CODE::SUCCESS);
+	_EQ_(res.getSize(), (size_t)4);
+	_EQ_(ScalarSet<Rational>::intersect(set1, set2, norm2, Rational(1, 1000), res), RESULT_CODE::SUCCESS);
+	_EQ_(res.getSize(), (size_t)1);
+	_EQ_(ScalarSet<Rational>::sub(set1, set2, norm2, Rational(1, 1000), res), RESULT_CODE::SUCCESS);
+	_EQ_(res.getSize(), (size_t)2);
+	_EQ_(ScalarSet<Rational>::symSub(set1, set2, norm2, Rational(1, 1000), res), RESULT_CODE::SUCCESS);
+	_EQ_(res.getSize(), (size_t)3);
+	size_t index = 0;
+	_EQ_(res.find(d, norm2, Rational(1, 1000), index), true);
+	Vec found;
+	_EQ_(res.get(found, index), RESULT_CODE::SUCCESS);
+	_EQ_(found.getCoord(0), Rational(4));
+
+	// CHECK: erase by sample removes every near element
+	_EQ_(set1.erase(a, norm2, Rational(1, 1000)), RESULT_CODE::SUCCESS);
+	_EQ_(set1.getSize(), (size_t)1);
+	_EQ_(set1.erase(0), RESULT_CODE::SUCCESS);
+	_EQ_(set1.getDim(), (size_t)0);
+	_EQ_(ScalarSet<Rational>::add(set1, set2, norm2, Rational(0), res), RESULT_CODE::WRONG_DIM);
+
+	// CHECK: float set
+	ScalarSet<float> floats;
+	floats.insert(ScalarVector<float>({ 1.0f, 2.0f }), IVector::NORM::NORM_INF, 0.5f);
+	floats.insert(ScalarVector<float>({ 1.25f, 2.0f }), IVector::NORM::NORM_INF, 0.5f);
+	_EQ_(floats.getSize(), (size_t)1);
+}
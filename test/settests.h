@@ -2,6 +2,12 @@
 #include "Test.h"
 #include "ILogger.h"
 #include "ISet.h"
+#include "numeric/LshSet.h"
+#include "numeric/OrderedSet.h"
+#include "numeric/ScalarSet.h"
+#include "numeric/SetSnapshot.h"
+#include "numeric/SetStream.h"
+#include "numeric/SnapshotBlocks.h"
 
 const std::string SET_PREFIX = "Set     ";
 
@@ -43,4 +49,60 @@ private:
 	void test() override;
 public:
 	Set5() : Test(SET_PREFIX + "Sub") {}
+};
+
+class Set6 : public Test
+{
+private:
+	void test() override;
+public:
+	Set6() : Test(SET_PREFIX + "LshInsert") {}
+};
+
+class Set7 : public Test
+{
+private:
+	void test() override;
+public:
+	Set7() : Test(SET_PREFIX + "LshErase") {}
+};
+
+class Set8 : public Test
+{
+private:
+	void test() override;
+public:
+	Set8() : Test(SET_PREFIX + "MortonLayout") {}
+};
+
+class Set9 : public Test
+{
+private:
+	void test() override;
+public:
+	Set9() : Test(SET_PREFIX + "Snapshot") {}
+};
+
+class Set10 : public Test
+{
+private:
+	void test() override;
+public:
+	Set10() : Test(SET_PREFIX + "StreamOps") {}
+};
+
+class Set11 : public Test
+{
+private:
+	void test() override;
+public:
+	Set11() : Test(SET_PREFIX + "CompressedSnapshot") {}
+};
+
+class Set12 : public Test
+{
+private:
+	void test() override;
+public:
+	Set12() : Test(SET_PREFIX + "Scalar") {}
 };
\ No newline at end of file
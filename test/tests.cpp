@@ -1,5 +1,7 @@
 #include "vectortests.h"
 #include "settests.h"
+#include "loggertests.h"
+#include "modelstests.h"
 #include "leaktest.h"
 #include <iostream>
 
@@ -14,12 +16,43 @@ int main()
 	driver.addTest(new Vector4());
 	driver.addTest(new Vector5());
 	driver.addTest(new Vector6());
+	driver.addTest(new Vector7());
 
 	driver.addTest(new Set1());
 	driver.addTest(new Set2());
 	driver.addTest(new Set3());
 	driver.addTest(new Set4());
 	driver.addTest(new Set5());
+	driver.addTest(new Set6());
+	driver.addTest(new Set7());
+	driver.addTest(new Set8());
+	driver.addTest(new Set9());
+	driver.addTest(new Set10());
+	driver.addTest(new Set11());
+	driver.addTest(new Set12());
+
+	driver.addTest(new Logger1());
+	driver.addTest(new Logger2());
+	driver.addTest(new Logger3());
+	driver.addTest(new Logger4());
+	driver.addTest(new Logger5());
+	driver.addTest(new Logger6());
+	driver.addTest(new Logger7());
+
+	driver.addTest(new Integer1());
+	driver.addTest(new Integer2());
+	driver.addTest(new Integer3());
+	driver.addTest(new Models1());
+	driver.addTest(new Models2());
+	driver.addTest(new Models3());
+	driver.addTest(new Models4());
+	driver.addTest(new Models5());
+	driver.addTest(new Models6());
+	driver.addTest(new Models7());
+	driver.addTest(new Models8());
+	driver.addTest(new Models9());
+	driver.addTest(new Models10());
+	driver.addTest(new Models11());
 
 	driver.runTests(std::cout);
 	std::cin.get();
@@ -1,4 +1,5 @@
 #include "vectortests.h"
+#include <cmath>
 
 
 void Vector0::test()
@@ -137,3 +138,54 @@ void Vector6::test()
 	delete cloned;
 	logger->destroyLogger(nullptr);
 }
+
+void Vector7::test()
+{
+	ILogger* logger = ILogger::createLogger(nullptr);
+
+	// CHECK: exact dot and norms, NORM_2 is squared
+	ScalarVector<Rational> a({ Rational(1, 3), Rational(-1, 2), Rational(2) });
+	ScalarVector<Rational> b({ Rational(3), Rational(1, 5), Rational(-1, 7) });
+	Rational dot(0);
+	_EQ_(ScalarVector<Rational>::mul(a, b, dot), RESULT_CODE::SUCCESS);
+	_EQ_(dot, Rational(1) - Rational(1, 10) - Rational(2, 7));
+	_EQ_(a.norm(IVector::NORM::NORM_1), Rational(17, 6));
+	_EQ_(a.norm(IVector::NORM::NORM_2), Rational(1, 9) + Rational(1, 4) + Rational(4));
+	_EQ_(a.norm(IVector::NORM::NORM_INF), Rational(2));
+
+	// CHECK: near with an exact tolerance, compared on squares for NORM_2
+	ScalarVector<Rational> c({ Rational(1, 3), Rational(-1, 2), Rational(2) + Rational(1, 1000) });
+	bool result = false;
+	_EQ_(ScalarVector<Rational>::equals(a, c, IVector::NORM::NORM_2, Rational(1, 999), result), RESULT_CODE::SUCCESS);
+	_EQ_(result, true);
+	_EQ_(ScalarVector<Rational>::equals(a, c, IVector::NORM::NORM_2, Rational(1, 1000), result), RESULT_CODE::SUCCESS);
+	_EQ_(result, false);
+	_EQ_(ScalarVector<Rational>::equals(a, c, IVector::NORM::NORM_1, Rational(-1), result), RESULT_CODE::WRONG_ARGUMENT);
+	_EQ_(ScalarVector<Rational>::add(a, ScalarVector<Rational>(2), c), RESULT_CODE::WRONG_DIM);
+
+	// CHECK: the widened Real dot encloses the exact one
+	ScalarVector<Real> x({ Real(Rational(1, 3), Rational(1, 2)), Real(Rational(-1, 7), Rational(-1, 7)) });
+	ScalarVector<Real> y({ Real(Rational(3), Rational(3)), Real(Rational(-2, 3), Rational(5, 11)) });
+	Real product(Rational(0), Rational(0));
+	_EQ_(ScalarVector<Real>::mul(x, y, product), RESULT_CODE::SUCCESS);
+	Real exact = x.getCoord(0) * y.getCoord(0) + x.getCoord(1) * y.getCoord(1);
+	_EQ_(product.getLower() <= exact.getLower() && product.getUpper() >= exact.getUpper(), true);
+	_EQ_(x.norm(IVector::NORM::NORM_2).getLower() >= Rational(0), true);
+
+	// CHECK: double and float through IVector
+	double data[3] = { 1, -2, 2 };
+	IVector* vector = IVector::createVector(3, data, logger);
+	ScalarVector<float> f = ScalarVector<float>::fromIVector(vector);
+	_EQ_(f.norm(IVector::NORM::NORM_2), 3.0f);
+	ScalarVector<double> d = ScalarVector<double>::fromIVector(vector);
+	ScalarVector<double>::mul(d, 0.5, d);
+	IVector* back = d.toIVector(logger);
+	_EQ_(back->getCoord(1), -1.0);
+	double square = 0;
+	_EQ_(ScalarVector<double>::mul(d, d, square), RESULT_CODE::SUCCESS);
+	_EQ_(square, 2.25);
+
+	delete back;
+	delete vector;
+	logger->destroyLogger(nullptr);
+}
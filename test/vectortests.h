@@ -2,6 +2,7 @@
 #include "Test.h"
 #include "ILogger.h"
 #include "IVector.h"
+#include "numeric/ScalarVector.h"
 
 const std::string VEC_PREFIX = "Vector  ";
 
@@ -59,4 +60,12 @@ private:
 	void test() override;
 public:
 	Vector6() : Test(VEC_PREFIX + "Clone") {}
+};
+
+class Vector7 : public Test
+{
+private:
+	void test() override;
+public:
+	Vector7() : Test(VEC_PREFIX + "Scalar") {}
 };
\ No newline at end of file
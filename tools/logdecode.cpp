@@ -0,0 +1,20 @@
+#include "numeric/LogRecord.h"
+#include <iostream>
+
+// Prints a log written by BinaryLogger as text
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		std::cerr << "usage: logdecode <binary log>\n";
+		return 2;
+	}
+
+	RESULT_CODE code = decodeBinaryLog(argv[1], std::cout);
+	if (code != RESULT_CODE::SUCCESS)
+	{
+		std::cerr << "logdecode: " << argv[1] << " is missing or broken (" << codeName(code) << ")\n";
+		return 1;
+	}
+	return 0;
+}